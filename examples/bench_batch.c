@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/batch.h"
+#include "goengc/board.h"
+#include "goengc/instrument.h"
+#include "goengc/types.h"
+
+/* Board size of the high-volume run: 9x9, or smaller if the build is */
+#if GOENGC_MAX_BOARD_SIZE < 9
+#define SMALL_BOARD_SIZE GOENGC_MAX_BOARD_SIZE
+#else
+#define SMALL_BOARD_SIZE 9
+#endif
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Run a batch from the empty board and report its throughput */
+static int run_batch(uint8_t size, uint32_t num_playouts,
+                     uint16_t num_threads, GoengcBatchResult* result) {
+    GoengcBoard root;
+    goengc_board_init(&root, goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+
+    double start = now_ns();
+    if (goengc_batch_run(&root, GOENGC_COLOR_BLACK, num_playouts, num_threads,
+                         size, result) != 0) {
+        fprintf(stderr, "batch run failed\n");
+        return -1;
+    }
+    double seconds = (now_ns() - start) / 1e9;
+
+    /* Ownership of the center point */
+    uint16_t center = goengc_coord_to_index(GOENGC_PAD + size / 2,
+                                            GOENGC_PAD + size / 2);
+    printf("%2ux%-2u  %2u threads  %7u playouts  %9.0f playouts/s  "
+           "black wins %.1f%%  mean score %+.2f  center ownership %+.3f\n",
+           size, size, num_threads, result->num_playouts,
+           result->num_playouts / seconds,
+           100.0 * result->black_wins / result->num_playouts,
+           result->mean_score2 / 2.0, result->ownership[center]);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    uint16_t max_threads = argc > 1 ? (uint16_t)atoi(argv[1]) : 4;
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    printf("Batched uniform random playouts (area scoring, komi 7.5)\n");
+    static GoengcBatchResult reference;
+    static GoengcBatchResult result;
+    if (run_batch(SMALL_BOARD_SIZE, 100000, 1, &reference) != 0) {
+        return 1;
+    }
+    for (uint16_t threads = 2; threads <= max_threads; threads *= 2) {
+        if (run_batch(SMALL_BOARD_SIZE, 100000, threads, &result) != 0) {
+            return 1;
+        }
+        /* Chunks are seeded independently of the thread that runs them */
+        if (result.black_wins != reference.black_wins ||
+            result.mean_score2 != reference.mean_score2) {
+            fprintf(stderr, "result depends on the thread count\n");
+            return 1;
+        }
+    }
+#if GOENGC_MAX_BOARD_SIZE > SMALL_BOARD_SIZE
+    for (uint16_t threads = 1; threads <= max_threads; threads *= 2) {
+        if (run_batch(GOENGC_MAX_BOARD_SIZE, 10000, threads, &result) != 0) {
+            return 1;
+        }
+    }
+#endif
+
+    /* Work counted by all worker threads (GOENGC_INSTRUMENT builds) */
+    if (goengc_instrument_enabled()) {
+        GoengcInstrumentSnapshot snapshot;
+        goengc_instrument_snapshot(&snapshot);
+        printf("\nInstrumentation counters\n");
+        goengc_instrument_print(&snapshot, stdout);
+    }
+    return 0;
+}
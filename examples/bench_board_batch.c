@@ -0,0 +1,230 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/board_batch.h"
+#include "goengc/color_field.h"
+#include "goengc/floodfill.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "goengc/scoring.h"
+#include "goengc/types.h"
+
+/* Not a multiple of the lane count, so the last group is partly empty */
+#define NUM_BOARDS 1003
+#define SEED 20240611
+
+static GoengcBoard boards[NUM_BOARDS];
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Positions of mixed sizes, rules and game stages: random moves from the
+ * empty board, and every fourth one played out to the end */
+static void setup_boards(void) {
+    static const uint8_t sizes[3] = {GOENGC_MAX_BOARD_SIZE,
+                                     GOENGC_MAX_BOARD_SIZE < 9
+                                         ? GOENGC_MAX_BOARD_SIZE
+                                         : 9,
+                                     GOENGC_MAX_BOARD_SIZE < 5
+                                         ? GOENGC_MAX_BOARD_SIZE
+                                         : 5};
+    GoengcRng rng;
+    GoengcWorkspace workspace;
+    GoengcBitfield legal;
+    goengc_rng_seed(&rng, SEED);
+
+    for (uint32_t i = 0; i < NUM_BOARDS; i++) {
+        GoengcBoard* board = &boards[i];
+        uint8_t size = sizes[i % 3];
+        goengc_board_init(board, goengc_vec2_create(size, size),
+                          (int8_t)(i % 16),
+                          i % 2 ? GOENGC_SCORING_TERRITORY
+                                : GOENGC_SCORING_AREA);
+        GoengcColor color = GOENGC_COLOR_BLACK;
+        uint32_t num_moves = i % (2 * size * size);
+        for (uint32_t m = 0; m < num_moves; m++) {
+            goengc_board_get_legal_moves(board, color, &legal);
+            uint16_t count = goengc_bitfield_count_bits(&legal);
+            if (count == 0) {
+                break;
+            }
+            uint16_t index = goengc_bitfield_select(
+                &legal, (uint16_t)goengc_rng_below(&rng, count));
+            goengc_board_play(board,
+                              goengc_move_create(color, 0,
+                                                 goengc_index_to_coord(index)));
+            color = goengc_color_opposite(color);
+        }
+        if (i % 4 == 0) {
+            goengc_playout_run(board, &workspace, color, &rng);
+        }
+    }
+}
+
+/* Check a plane against one bitfield per board */
+static int check_plane(const GoengcBoardBatch* batch, const uint64_t* plane,
+                       uint32_t index, const GoengcBitfield* expected,
+                       const char* what) {
+    GoengcBitfield got;
+    goengc_board_batch_get_bitfield(batch, plane, index, &got);
+    for (uint16_t w = 0; w < GOENGC_BITFIELD_WORDS; w++) {
+        if (got.words[w] != expected->words[w]) {
+            fprintf(stderr, "board %u: %s differs in word %u\n", index, what,
+                    w);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Compare every batch kernel with the per-board functions */
+static int check_batch(GoengcBoardBatch* batch, uint64_t* mask,
+                       uint64_t* region) {
+    static GoengcScore scores[NUM_BOARDS];
+    static uint16_t counts[NUM_BOARDS];
+    int failed = 0;
+
+    for (GoengcColor color = GOENGC_COLOR_OFF_BOARD;
+         color <= GOENGC_COLOR_WHITE; color++) {
+        goengc_board_batch_get_mask(batch, color, mask);
+        for (uint32_t i = 0; i < NUM_BOARDS && !failed; i++) {
+            GoengcBitfield expected;
+            goengc_colorfield_get_mask(&boards[i].color_field, color,
+                                       &expected);
+            failed |= check_plane(batch, mask, i, &expected, "mask");
+        }
+    }
+
+    for (GoengcColor color = GOENGC_COLOR_BLACK; color <= GOENGC_COLOR_WHITE;
+         color++) {
+        goengc_board_batch_count_liberties(batch, color, region, counts);
+        for (uint32_t i = 0; i < NUM_BOARDS && !failed; i++) {
+            GoengcBitfield stones, empty, expected;
+            goengc_colorfield_get_mask(&boards[i].color_field, color, &stones);
+            goengc_colorfield_get_mask(&boards[i].color_field,
+                                       GOENGC_COLOR_EMPTY, &empty);
+            goengc_bitfield_neighbors(&expected, &stones);
+            goengc_bitfield_and(&expected, &expected, &empty);
+            failed |= check_plane(batch, region, i, &expected, "liberties");
+            if (!failed && counts[i] != goengc_bitfield_count_bits(&expected)) {
+                fprintf(stderr, "board %u: liberty count differs\n", i);
+                failed = 1;
+            }
+        }
+    }
+
+    /* Fill the empty regions that touch black stones */
+    goengc_board_batch_count_liberties(batch, GOENGC_COLOR_BLACK, region,
+                                       counts);
+    goengc_board_batch_get_mask(batch, GOENGC_COLOR_EMPTY, mask);
+    goengc_board_batch_flood_fill(batch, mask, region);
+    for (uint32_t i = 0; i < NUM_BOARDS && !failed; i++) {
+        GoengcBitfield black, empty, expected;
+        goengc_colorfield_get_mask(&boards[i].color_field, GOENGC_COLOR_BLACK,
+                                   &black);
+        goengc_colorfield_get_mask(&boards[i].color_field, GOENGC_COLOR_EMPTY,
+                                   &empty);
+        goengc_bitfield_neighbors(&expected, &black);
+        goengc_bitfield_and(&expected, &expected, &empty);
+        goengc_flood_fill_region(&empty, &expected);
+        failed |= check_plane(batch, region, i, &expected, "flood fill");
+    }
+
+    goengc_board_batch_score(batch, scores);
+    for (uint32_t i = 0; i < NUM_BOARDS && !failed; i++) {
+        GoengcBitfield black_area, white_area;
+        GoengcScore expected =
+            goengc_score(&boards[i], NULL, &black_area, &white_area);
+        if (scores[i].black != expected.black ||
+            scores[i].white != expected.white ||
+            scores[i].dame != expected.dame ||
+            scores[i].score2 != expected.score2) {
+            fprintf(stderr, "board %u: score differs\n", i);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+/* Boards scored per second with the batch kernels */
+static double time_batch(const GoengcBoardBatch* batch, uint32_t rounds) {
+    static GoengcScore scores[NUM_BOARDS];
+    double start = now_ns();
+    for (uint32_t r = 0; r < rounds; r++) {
+        goengc_board_batch_score(batch, scores);
+    }
+    return (double)rounds * NUM_BOARDS / ((now_ns() - start) / 1e9);
+}
+
+/* Boards scored per second one at a time with goengc_score */
+static double time_single(uint32_t rounds) {
+    GoengcBitfield black_area, white_area;
+    volatile int32_t sink = 0;
+    double start = now_ns();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < NUM_BOARDS; i++) {
+            sink += goengc_score(&boards[i], NULL, &black_area, &white_area)
+                        .score2;
+        }
+    }
+    (void)sink;
+    return (double)rounds * NUM_BOARDS / ((now_ns() - start) / 1e9);
+}
+
+int main(int argc, char** argv) {
+    static const GoengcBoardBatchKernel kernels[] = {
+        GOENGC_BOARD_BATCH_SCALAR, GOENGC_BOARD_BATCH_AVX2,
+        GOENGC_BOARD_BATCH_AVX512};
+    static const char* const names[] = {"auto", "scalar", "avx2", "avx512"};
+    uint32_t rounds = argc > 1 ? (uint32_t)atoi(argv[1]) : 200;
+    if (rounds == 0) {
+        rounds = 1;
+    }
+
+    setup_boards();
+    GoengcBoardBatch batch;
+    if (goengc_board_batch_init(&batch, NUM_BOARDS) != 0) {
+        fprintf(stderr, "could not allocate the batch\n");
+        return 1;
+    }
+    uint64_t* mask = goengc_board_batch_alloc_plane(&batch);
+    uint64_t* region = goengc_board_batch_alloc_plane(&batch);
+    if (mask == NULL || region == NULL) {
+        fprintf(stderr, "could not allocate the planes\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < NUM_BOARDS; i++) {
+        goengc_board_batch_set(&batch, i, &boards[i]);
+    }
+
+    printf("Scoring %u boards of mixed sizes, all stones alive\n", NUM_BOARDS);
+    printf("%-8s %12.0f boards/s\n", "single", time_single(rounds));
+    int failed = 0;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (goengc_board_batch_select_kernel(kernels[k]) != kernels[k]) {
+            printf("%-8s not supported by this processor\n", names[kernels[k]]);
+            continue;
+        }
+        if (check_batch(&batch, mask, region) != 0) {
+            printf("%-8s MISMATCH\n", names[kernels[k]]);
+            failed = 1;
+            continue;
+        }
+        printf("%-8s %12.0f boards/s\n", names[kernels[k]],
+               time_batch(&batch, rounds));
+    }
+
+    free(mask);
+    free(region);
+    goengc_board_batch_free(&batch);
+    printf(failed ? "batch kernels FAILED\n" : "batch kernels passed\n");
+    return failed;
+}
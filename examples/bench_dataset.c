@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/dataset.h"
+#include "goengc/random.h"
+#include "goengc/scoring.h"
+#include "goengc/types.h"
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Pick a random legal move that does not fill an own eye, or pass */
+static GoengcMove random_move(const GoengcBoard* board, GoengcColor color,
+                              GoengcRng* rng) {
+    GoengcBitfield candidates;
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY,
+                               &candidates);
+    uint16_t count = goengc_bitfield_count_bits(&candidates);
+    while (count > 0) {
+        uint16_t index =
+            goengc_bitfield_select(&candidates, goengc_rng_below(rng, count));
+        GoengcMove move =
+            goengc_move_create(color, 0, goengc_index_to_coord(index));
+        if (!goengc_board_is_eye(board, index, color) &&
+            goengc_board_is_legal(board, move)) {
+            return move;
+        }
+        goengc_bitfield_clear_bit(&candidates, index);
+        count--;
+    }
+    return goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+}
+
+/* Write random games until num_records positions are stored. The hash of
+ * every stored position is kept to check the reader against. */
+static int write_dataset(const char* path, uint64_t num_records,
+                         uint64_t* hashes, GoengcRng* rng) {
+    const uint8_t size = GOENGC_MAX_BOARD_SIZE;
+    const int max_moves = 3 * size * size;
+    GoengcDatasetRecord* game = malloc(max_moves * sizeof(*game));
+    GoengcDatasetWriter writer;
+    if (game == NULL || goengc_dataset_writer_open(&writer, path) != 0) {
+        free(game);
+        return -1;
+    }
+
+    uint64_t written = 0;
+    while (written < num_records) {
+        GoengcBoard board;
+        goengc_board_init(&board, goengc_vec2_create(size, size), 15,
+                          GOENGC_SCORING_AREA);
+        GoengcColor color = GOENGC_COLOR_BLACK;
+        int passes = 0;
+        int ply = 0;
+        for (; ply < max_moves && passes < 2 &&
+               written + (uint64_t)ply < num_records;
+             ply++) {
+            GoengcMove move = random_move(&board, color, rng);
+            goengc_dataset_record_from_board(&board, color, move, 0,
+                                             &game[ply]);
+            hashes[written + (uint64_t)ply] = board.hash;
+            goengc_board_play(&board, move);
+            passes = move.is_pass ? passes + 1 : 0;
+            color = goengc_color_opposite(color);
+        }
+
+        /* The result is only known once the game is over */
+        GoengcBitfield black_area;
+        GoengcBitfield white_area;
+        GoengcScore score = goengc_score(&board, NULL, &black_area,
+                                         &white_area);
+        for (int i = 0; i < ply; i++) {
+            game[i].result2 = score.score2;
+            if (goengc_dataset_writer_add(&writer, &game[i]) != 0) {
+                goengc_dataset_writer_close(&writer);
+                free(game);
+                return -1;
+            }
+        }
+        written += (uint64_t)ply;
+    }
+
+    free(game);
+    return goengc_dataset_writer_close(&writer);
+}
+
+int main(int argc, char** argv) {
+    const uint64_t num_records =
+        argc > 1 ? strtoull(argv[1], NULL, 10) : 200000;
+    const uint64_t num_samples = 1000000;
+    const char* path = argc > 2 ? argv[2] : "bench_dataset.bin";
+    uint64_t* hashes = malloc(num_records * sizeof(uint64_t));
+    if (num_records == 0 || hashes == NULL) {
+        return 1;
+    }
+
+    GoengcRng rng;
+    goengc_rng_seed(&rng, 42);
+    double start = now_ns();
+    if (write_dataset(path, num_records, hashes, &rng) != 0) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    double write_seconds = (now_ns() - start) / 1e9;
+
+    GoengcDatasetReader reader;
+    if (goengc_dataset_reader_open(&reader, path) != 0 ||
+        reader.num_records != num_records) {
+        fprintf(stderr, "cannot map %s\n", path);
+        return 1;
+    }
+    printf("Dataset of %llu %ux%u positions, %zu bytes per record "
+           "(%.1f MB), written in %.2f s\n",
+           (unsigned long long)num_records, GOENGC_MAX_BOARD_SIZE,
+           GOENGC_MAX_BOARD_SIZE, sizeof(GoengcDatasetRecord),
+           reader.mapping_size / 1e6, write_seconds);
+
+    /* Unpack only the planes, as a feature encoder would */
+    uint64_t checksum = 0;
+    start = now_ns();
+    for (uint64_t i = 0; i < num_samples; i++) {
+        const GoengcDatasetRecord* record = goengc_dataset_reader_get(
+            &reader, goengc_rng_next(&rng) % num_records);
+        GoengcColorField color_field;
+        goengc_dataset_record_get_colors(record, &color_field);
+        checksum += color_field.occupied_bits.words[1];
+    }
+    double colors_ns = (now_ns() - start) / num_samples;
+
+    /* Load full boards and check them against the written positions */
+    uint64_t mismatches = 0;
+    start = now_ns();
+    for (uint64_t i = 0; i < num_samples; i++) {
+        uint64_t index = goengc_rng_next(&rng) % num_records;
+        const GoengcDatasetRecord* record =
+            goengc_dataset_reader_get(&reader, index);
+        GoengcBoard board;
+        goengc_dataset_record_to_board(record, &board);
+        mismatches += board.hash != hashes[index];
+    }
+    double board_ns = (now_ns() - start) / num_samples;
+
+    /* Loading and re-encoding must reproduce every record exactly */
+    for (uint64_t i = 0; i < num_records; i++) {
+        const GoengcDatasetRecord* record = goengc_dataset_reader_get(&reader, i);
+        GoengcBoard board;
+        goengc_dataset_record_to_board(record, &board);
+        GoengcMove next_move = goengc_move_create(
+            GOENGC_COLOR_EMPTY, record->next_move == GOENGC_DATASET_PASS,
+            goengc_vec2_create(0, 0));
+        if (record->next_move < GOENGC_DATASET_PASS) {
+            next_move.color = (GoengcColor)record->to_move;
+            next_move.coord = goengc_index_to_coord(
+                goengc_dataset_unpack_point(record->next_move));
+        }
+        GoengcDatasetRecord copy;
+        goengc_dataset_record_from_board(&board, (GoengcColor)record->to_move,
+                                         next_move, record->result2, &copy);
+        mismatches += memcmp(&copy, record, sizeof(copy)) != 0;
+    }
+
+    printf("random colors  %8.1f ns/record  (checksum %llx)\n", colors_ns,
+           (unsigned long long)checksum);
+    printf("random board   %8.1f ns/record\n", board_ns);
+
+    goengc_dataset_reader_close(&reader);
+    remove(path);
+    free(hashes);
+    if (mismatches != 0) {
+        fprintf(stderr, "%llu records do not round-trip\n",
+                (unsigned long long)mismatches);
+        return 1;
+    }
+    return 0;
+}
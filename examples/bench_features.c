@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/features.h"
+#include "goengc/random.h"
+#include "goengc/types.h"
+
+#define BATCH_SIZE 1024
+#define HISTORY 3
+#define REPEATS 20
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Pick a random legal move that does not fill an own eye, or pass */
+static GoengcMove random_move(const GoengcBoard* board, GoengcColor color,
+                              GoengcRng* rng) {
+    GoengcBitfield candidates;
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY,
+                               &candidates);
+    uint16_t count = goengc_bitfield_count_bits(&candidates);
+    while (count > 0) {
+        uint16_t index =
+            goengc_bitfield_select(&candidates, goengc_rng_below(rng, count));
+        GoengcMove move =
+            goengc_move_create(color, 0, goengc_index_to_coord(index));
+        if (!goengc_board_is_eye(board, index, color) &&
+            goengc_board_is_legal(board, move)) {
+            return move;
+        }
+        goengc_bitfield_clear_bit(&candidates, index);
+        count--;
+    }
+    return goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+}
+
+/* Fill one sample: a position after a random number of random moves, and the
+ * HISTORY positions before it */
+static void make_sample(GoengcBoard* boards, GoengcColor* to_move,
+                        GoengcRng* rng) {
+    const uint8_t size = GOENGC_MAX_BOARD_SIZE;
+    GoengcBoard window[HISTORY + 1];
+    goengc_board_init(&window[0], goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+    for (int h = 1; h <= HISTORY; h++) {
+        window[h] = window[0];
+    }
+
+    GoengcColor color = GOENGC_COLOR_BLACK;
+    uint32_t num_moves = goengc_rng_below(rng, 2 * size * size);
+    for (uint32_t i = 0; i < num_moves; i++) {
+        memmove(&window[1], &window[0], HISTORY * sizeof(GoengcBoard));
+        goengc_board_play(&window[0], random_move(&window[0], color, rng));
+        color = goengc_color_opposite(color);
+    }
+    memcpy(boards, window, sizeof(window));
+    *to_move = color;
+}
+
+/* Encode one sample a point at a time */
+static void reference_encode(const GoengcBoard* boards, GoengcColor to_move,
+                             uint8_t* out) {
+    const uint16_t num_planes = goengc_features_num_planes(HISTORY);
+    memset(out, 0, (size_t)num_planes * GOENGC_FEATURES_PLANE_SIZE);
+    GoengcColor opponent = goengc_color_opposite(to_move);
+    for (uint8_t y = 0; y < GOENGC_FEATURES_SIZE; y++) {
+        for (uint8_t x = 0; x < GOENGC_FEATURES_SIZE; x++) {
+            uint16_t index =
+                goengc_coord_to_index(x + GOENGC_PAD, y + GOENGC_PAD);
+            size_t point = (size_t)y * GOENGC_FEATURES_SIZE + x;
+            for (uint8_t h = 0; h <= HISTORY; h++) {
+                GoengcColor color =
+                    goengc_colorfield_get_color(&boards[h].color_field, index);
+                uint16_t base = h == 0 ? GOENGC_FEATURE_OWN
+                                       : GOENGC_FEATURE_HISTORY + 2 * (h - 1);
+                uint16_t next = h == 0 ? GOENGC_FEATURE_OPPONENT : base + 1;
+                out[base * GOENGC_FEATURES_PLANE_SIZE + point] =
+                    color == to_move;
+                out[next * GOENGC_FEATURES_PLANE_SIZE + point] =
+                    color == opponent;
+            }
+
+            GoengcColor color =
+                goengc_colorfield_get_color(&boards[0].color_field, index);
+            out[GOENGC_FEATURE_EMPTY * GOENGC_FEATURES_PLANE_SIZE + point] =
+                color == GOENGC_COLOR_EMPTY;
+            out[GOENGC_FEATURE_ON_BOARD * GOENGC_FEATURES_PLANE_SIZE + point] =
+                color != GOENGC_COLOR_OFF_BOARD;
+            out[GOENGC_FEATURE_KO * GOENGC_FEATURES_PLANE_SIZE + point] =
+                boards[0].ko_index == index && boards[0].ko_color == to_move;
+            if (color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE) {
+                uint16_t liberties = goengc_board_get_liberties(&boards[0], index);
+                uint16_t plane = liberties >= 3   ? GOENGC_FEATURE_LIBERTIES_3
+                                 : liberties == 2 ? GOENGC_FEATURE_LIBERTIES_2
+                                                  : GOENGC_FEATURE_LIBERTIES_1;
+                out[plane * GOENGC_FEATURES_PLANE_SIZE + point] = 1;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint16_t num_threads = argc > 1 ? (uint16_t)atoi(argv[1]) : 4;
+    const uint16_t num_planes = goengc_features_num_planes(HISTORY);
+    const size_t sample_size = (size_t)num_planes * GOENGC_FEATURES_PLANE_SIZE;
+
+    GoengcBoard* boards =
+        malloc((size_t)BATCH_SIZE * (HISTORY + 1) * sizeof(GoengcBoard));
+    GoengcColor* to_move = malloc(BATCH_SIZE * sizeof(GoengcColor));
+    uint8_t* expected = malloc(BATCH_SIZE * sample_size);
+    uint8_t* bytes = malloc(BATCH_SIZE * sample_size);
+    float* floats = malloc(BATCH_SIZE * sample_size * sizeof(float));
+    if (boards == NULL || to_move == NULL || expected == NULL ||
+        bytes == NULL || floats == NULL) {
+        return 1;
+    }
+
+    GoengcRng rng;
+    goengc_rng_seed(&rng, 42);
+    for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+        make_sample(&boards[(size_t)i * (HISTORY + 1)], &to_move[i], &rng);
+    }
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+        reference_encode(&boards[(size_t)i * (HISTORY + 1)], to_move[i],
+                         expected + i * sample_size);
+    }
+    double reference_ns = (now_ns() - start) / BATCH_SIZE;
+
+    printf("Feature encoding of %d %ux%u samples, %u planes\n", BATCH_SIZE,
+           GOENGC_MAX_BOARD_SIZE, GOENGC_MAX_BOARD_SIZE, num_planes);
+    printf("per point       %8.0f ns/sample\n", reference_ns);
+
+    int failed = 0;
+    uint16_t thread_counts[2] = {1, num_threads};
+    for (int t = 0; t < 2; t++) {
+        start = now_ns();
+        for (int r = 0; r < REPEATS; r++) {
+            goengc_features_encode(boards, to_move, BATCH_SIZE, HISTORY,
+                                   GOENGC_FEATURES_UINT8, thread_counts[t],
+                                   bytes);
+        }
+        double bytes_ns = (now_ns() - start) / REPEATS / BATCH_SIZE;
+
+        start = now_ns();
+        for (int r = 0; r < REPEATS; r++) {
+            goengc_features_encode(boards, to_move, BATCH_SIZE, HISTORY,
+                                   GOENGC_FEATURES_FLOAT32, thread_counts[t],
+                                   floats);
+        }
+        double floats_ns = (now_ns() - start) / REPEATS / BATCH_SIZE;
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < BATCH_SIZE * sample_size; i++) {
+            mismatches += bytes[i] != expected[i];
+            mismatches += floats[i] != (float)expected[i];
+        }
+        printf("%2u thread(s)    %8.0f ns/sample uint8  %8.0f ns/sample float\n",
+               thread_counts[t], bytes_ns, floats_ns);
+        if (mismatches != 0) {
+            fprintf(stderr, "%zu elements differ from the reference\n",
+                    mismatches);
+            failed = 1;
+        }
+    }
+
+    free(boards);
+    free(to_move);
+    free(expected);
+    free(bytes);
+    free(floats);
+    return failed;
+}
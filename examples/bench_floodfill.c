@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/floodfill.h"
+#include "goengc/types.h"
+
+typedef void (*FloodFillFn)(const GoengcColorField* restrict, GoengcVec2,
+                            GoengcBitfield* restrict, GoengcBitfield* restrict);
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Lay a single black chain along a spiral, leaving a one point wide empty
+ * corridor between its arms. This is the worst case for fills that advance
+ * one point per step. */
+static void setup_spiral(GoengcBoard* board) {
+    static const int dx[4] = {1, 0, -1, 0};
+    static const int dy[4] = {0, 1, 0, -1};
+    int size = board->board_size.x;
+    int marked[GOENGC_MAX_BOARD_SIZE][GOENGC_MAX_BOARD_SIZE];
+    memset(marked, 0, sizeof(marked));
+
+    int x = 0, y = 0, dir = 0, turns = 0;
+    marked[y][x] = 1;
+    while (turns < 2) {
+        int nx = x + dx[dir], ny = y + dy[dir];
+        int ax = nx + dx[dir], ay = ny + dy[dir];
+        int inside = nx >= 0 && ny >= 0 && nx < size && ny < size;
+        int ahead_free = ax < 0 || ay < 0 || ax >= size || ay >= size ||
+                         !marked[ay][ax];
+        if (inside && !marked[ny][nx] && ahead_free) {
+            x = nx;
+            y = ny;
+            marked[y][x] = 1;
+            turns = 0;
+        } else {
+            dir = (dir + 1) % 4;
+            turns++;
+        }
+    }
+
+    for (int py = 0; py < size; py++) {
+        for (int px = 0; px < size; px++) {
+            if (marked[py][px]) {
+                goengc_board_setup_move(
+                    board, goengc_move_create(
+                               GOENGC_COLOR_BLACK, 0,
+                               goengc_vec2_create(px + GOENGC_PAD,
+                                                  py + GOENGC_PAD)));
+            }
+        }
+    }
+}
+
+/* Time one fill function and return nanoseconds per fill */
+static double time_fill(FloodFillFn fill, const GoengcBoard* board,
+                        GoengcWorkspace* workspace, GoengcVec2 seed,
+                        int iterations) {
+    /* Warm up */
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        fill(&board->color_field, seed, &workspace->scratch1,
+             &workspace->scratch2);
+    }
+
+    double start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        fill(&board->color_field, seed, &workspace->scratch1,
+             &workspace->scratch2);
+    }
+    return (now_ns() - start) / iterations;
+}
+
+/* Compare both fill paths on one seed and print the timings */
+static int run_case(const char* name, const GoengcBoard* board,
+                    GoengcWorkspace* workspace, GoengcVec2 seed,
+                    int iterations) {
+    GoengcBitfield expected;
+    goengc_flood_fill_scan(&board->color_field, seed, &workspace->scratch1,
+                           &workspace->scratch2);
+    goengc_bitfield_copy(&expected, &workspace->scratch2);
+    goengc_flood_fill(&board->color_field, seed, &workspace->scratch1,
+                      &workspace->scratch2);
+    for (uint16_t i = 0; i < GOENGC_DATA_SIZE_SQUARED; i++) {
+        if (goengc_bitfield_get_bit(&expected, i) !=
+            goengc_bitfield_get_bit(&workspace->scratch2, i)) {
+            printf("%-16s MISMATCH at index %u\n", name, i);
+            return 1;
+        }
+    }
+
+    double scan_ns = time_fill(goengc_flood_fill_scan, board, workspace, seed,
+                               iterations);
+    double dilate_ns =
+        time_fill(goengc_flood_fill, board, workspace, seed, iterations);
+    printf("%-16s %4u points  scan %9.1f ns  dilation %9.1f ns  x%.2f\n",
+           name, goengc_bitfield_count_bits(&expected), scan_ns, dilate_ns,
+           scan_ns / dilate_ns);
+    return 0;
+}
+
+int main(void) {
+    const int iterations = 20000;
+    int failed = 0;
+    GoengcBoard board;
+    GoengcWorkspace workspace;
+
+    printf("Flood fill benchmark (%d iterations per case)\n", iterations);
+
+    goengc_board_init(&board, goengc_vec2_create(GOENGC_MAX_BOARD_SIZE,
+                                                GOENGC_MAX_BOARD_SIZE), 15,
+                      GOENGC_SCORING_AREA);
+    failed |= run_case("empty board", &board, &workspace,
+                       goengc_vec2_create(GOENGC_PAD, GOENGC_PAD), iterations);
+
+    setup_spiral(&board);
+    failed |= run_case("spiral chain", &board, &workspace,
+                       goengc_vec2_create(GOENGC_PAD, GOENGC_PAD), iterations);
+    failed |= run_case("spiral corridor", &board, &workspace,
+                       goengc_vec2_create(GOENGC_PAD, GOENGC_PAD + 1),
+                       iterations);
+
+    return failed;
+}
@@ -0,0 +1,374 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/constants.h"
+#include "goengc/ladder.h"
+#include "goengc/random.h"
+#include "goengc/types.h"
+
+#define SEED 20240611
+#define NUM_POSITIONS 200
+#define MAX_NODES 100000
+
+static GoengcBoard positions[NUM_POSITIONS];
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint16_t point(int x, int y) {
+    return goengc_coord_to_index(x + GOENGC_PAD, y + GOENGC_PAD);
+}
+
+static void put(GoengcBoard* board, GoengcColor color, int x, int y) {
+    goengc_board_setup_move(
+        board, goengc_move_create(color, 0, goengc_index_to_coord(point(x, y))));
+}
+
+/*
+ * Reference reader with the same rules as goengc_ladder_read that copies
+ * the board for every move and finds moves by walking the chain
+ */
+
+typedef struct {
+    uint32_t nodes;
+    int exhausted;
+} NaiveSearch;
+
+static GoengcLadderStatus naive_attack(const GoengcBoard* board,
+                                       uint16_t chain, NaiveSearch* search,
+                                       uint16_t depth);
+
+/* Play a move on a copy; 0 if it is illegal or a limit is reached */
+static int naive_play(const GoengcBoard* board, GoengcColor color,
+                      uint16_t index, NaiveSearch* search, uint16_t depth,
+                      GoengcBoard* next) {
+    GoengcMove move =
+        goengc_move_create(color, 0, goengc_index_to_coord(index));
+    if (!goengc_board_is_legal(board, move)) {
+        return 0;
+    }
+    if (search->nodes >= MAX_NODES || depth >= GOENGC_LADDER_MAX_DEPTH) {
+        search->exhausted = 1;
+        return 0;
+    }
+    search->nodes++;
+    *next = *board;
+    goengc_board_play(next, move);
+    return 1;
+}
+
+/* Empty neighbors of a chain, in stone order */
+static uint8_t naive_liberties(const GoengcBoard* board, uint16_t chain,
+                               uint16_t* out, uint8_t max) {
+    uint8_t count = 0;
+    uint16_t head = goengc_board_get_chain(board, chain);
+    uint16_t stone = head;
+    do {
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor = stone + GOENGC_NEIGHBOR_4[n];
+            int known = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                known |= out[i] == neighbor;
+            }
+            if (!known && count < max &&
+                goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                    GOENGC_COLOR_EMPTY) {
+                out[count++] = neighbor;
+            }
+        }
+        stone = board->chain_next[stone];
+    } while (stone != head);
+    return count;
+}
+
+static GoengcLadderStatus naive_defend(const GoengcBoard* board,
+                                       uint16_t chain, NaiveSearch* search,
+                                       uint16_t depth) {
+    GoengcColor defender =
+        goengc_colorfield_get_color(&board->color_field, chain);
+    uint16_t moves[64];
+    uint8_t count = naive_liberties(board, chain, moves, 1);
+
+    /* Liberties of adjacent attacker chains in atari */
+    uint16_t head = goengc_board_get_chain(board, chain);
+    uint16_t stone = head;
+    do {
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor = stone + GOENGC_NEIGHBOR_4[n];
+            if (goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                    goengc_color_opposite(defender) &&
+                goengc_board_get_liberties(board, neighbor) == 1) {
+                uint16_t liberty;
+                naive_liberties(board, neighbor, &liberty, 1);
+                int known = 0;
+                for (uint8_t i = 0; i < count; i++) {
+                    known |= moves[i] == liberty;
+                }
+                if (!known && count < 64) {
+                    moves[count++] = liberty;
+                }
+            }
+        }
+        stone = board->chain_next[stone];
+    } while (stone != head);
+
+    GoengcLadderStatus status = GOENGC_LADDER_CAPTURED;
+    for (uint8_t i = 0; i < count; i++) {
+        GoengcBoard next;
+        if (!naive_play(board, defender, moves[i], search, depth, &next)) {
+            if (search->exhausted) {
+                return GOENGC_LADDER_UNKNOWN;
+            }
+            continue;
+        }
+        uint16_t liberties = goengc_board_get_liberties(&next, chain);
+        GoengcLadderStatus outcome =
+            liberties >= 3   ? GOENGC_LADDER_ESCAPED
+            : liberties == 2 ? naive_attack(&next, chain, search, depth + 1)
+                             : GOENGC_LADDER_CAPTURED;
+        if (outcome == GOENGC_LADDER_ESCAPED) {
+            return outcome;
+        }
+        if (outcome == GOENGC_LADDER_UNKNOWN) {
+            status = outcome;
+        }
+    }
+    return status;
+}
+
+static GoengcLadderStatus naive_attack(const GoengcBoard* board,
+                                       uint16_t chain, NaiveSearch* search,
+                                       uint16_t depth) {
+    GoengcColor attacker = goengc_color_opposite(
+        goengc_colorfield_get_color(&board->color_field, chain));
+    uint16_t moves[2];
+    naive_liberties(board, chain, moves, 2);
+
+    GoengcLadderStatus status = GOENGC_LADDER_ESCAPED;
+    for (int i = 0; i < 2; i++) {
+        GoengcBoard next;
+        if (!naive_play(board, attacker, moves[i], search, depth, &next)) {
+            if (search->exhausted) {
+                return GOENGC_LADDER_UNKNOWN;
+            }
+            continue;
+        }
+        GoengcLadderStatus outcome =
+            goengc_board_get_liberties(&next, chain) == 1
+                ? naive_defend(&next, chain, search, depth + 1)
+                : GOENGC_LADDER_ESCAPED;
+        if (outcome == GOENGC_LADDER_CAPTURED) {
+            return outcome;
+        }
+        if (outcome == GOENGC_LADDER_UNKNOWN) {
+            status = outcome;
+        }
+    }
+    return status;
+}
+
+static GoengcLadderStatus naive_read(const GoengcBoard* board,
+                                     uint16_t chain, uint32_t* nodes) {
+    NaiveSearch search = {0, 0};
+    uint16_t liberties = goengc_board_get_liberties(board, chain);
+    GoengcLadderStatus status =
+        liberties == 1 ? naive_defend(board, chain, &search, 0)
+                       : naive_attack(board, chain, &search, 0);
+    *nodes += search.nodes;
+    return status;
+}
+
+/* A ladder from an atari in the middle of the board that runs to the lower
+ * left edge, and the same ladder with a black stone on its path */
+static int check_known(void) {
+#if GOENGC_MAX_BOARD_SIZE >= 19
+    GoengcBoard board;
+    GoengcLadderResult result;
+    goengc_board_init(&board, goengc_vec2_create(19, 19), 15,
+                      GOENGC_SCORING_AREA);
+    put(&board, GOENGC_COLOR_BLACK, 9, 9);
+    put(&board, GOENGC_COLOR_WHITE, 9, 8);
+    put(&board, GOENGC_COLOR_WHITE, 8, 9);
+    put(&board, GOENGC_COLOR_WHITE, 10, 9);
+    put(&board, GOENGC_COLOR_WHITE, 10, 10);
+
+    goengc_ladder_read(&board, point(9, 9), MAX_NODES, &result);
+    printf("ladder to the edge: status %d, %u nodes\n", result.status,
+           result.nodes);
+    if (result.status != GOENGC_LADDER_CAPTURED ||
+        result.move != GOENGC_LADDER_NO_POINT) {
+        fprintf(stderr, "the ladder should capture\n");
+        return 1;
+    }
+
+    goengc_ladder_read(&board, point(9, 9), 8, &result);
+    if (result.status != GOENGC_LADDER_UNKNOWN || result.nodes > 8) {
+        fprintf(stderr, "the node limit should stop the reading\n");
+        return 1;
+    }
+
+    put(&board, GOENGC_COLOR_BLACK, 3, 16);
+    goengc_ladder_read(&board, point(9, 9), MAX_NODES, &result);
+    printf("ladder with a breaker: status %d, %u nodes\n", result.status,
+           result.nodes);
+    if (result.status != GOENGC_LADDER_ESCAPED ||
+        result.move != point(9, 10) || result.breaker != point(3, 16)) {
+        fprintf(stderr,
+                "the stone at (3, 16) should break the ladder: move %u, "
+                "breaker %u\n",
+                result.move, result.breaker);
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+/* Positions from random games of different lengths */
+static void setup_positions(void) {
+    GoengcRng rng;
+    GoengcBitfield legal;
+    goengc_rng_seed(&rng, SEED);
+    uint8_t size = GOENGC_MAX_BOARD_SIZE;
+
+    for (uint32_t i = 0; i < NUM_POSITIONS; i++) {
+        GoengcBoard* board = &positions[i];
+        goengc_board_init(board, goengc_vec2_create(size, size), 15,
+                          GOENGC_SCORING_AREA);
+        GoengcColor color = GOENGC_COLOR_BLACK;
+        uint32_t num_moves = 1 + i * size * size / NUM_POSITIONS;
+        for (uint32_t m = 0; m < num_moves; m++) {
+            goengc_board_get_legal_moves(board, color, &legal);
+            uint16_t count = goengc_bitfield_count_bits(&legal);
+            if (count == 0) {
+                break;
+            }
+            uint16_t index = goengc_bitfield_select(
+                &legal, (uint16_t)goengc_rng_below(&rng, count));
+            goengc_board_play(
+                board,
+                goengc_move_create(color, 0, goengc_index_to_coord(index)));
+            color = goengc_color_opposite(color);
+        }
+    }
+}
+
+/* Compare every chain with the reference reader and check the moves */
+static int check_positions(uint32_t* num_chains) {
+    static GoengcBoard next;
+    uint32_t nodes = 0;
+    *num_chains = 0;
+    for (uint32_t i = 0; i < NUM_POSITIONS; i++) {
+        const GoengcBoard* board = &positions[i];
+        const GoengcBitfield* stones = &board->color_field.occupied_bits;
+        for (uint16_t index = goengc_bitfield_find_first(stones);
+             index < GOENGC_DATA_SIZE_SQUARED;
+             index = goengc_bitfield_find_next(stones, index + 1)) {
+            uint16_t liberties = goengc_board_get_liberties(board, index);
+            if (liberties > 2 || goengc_board_get_chain(board, index) != index) {
+                continue;
+            }
+            (*num_chains)++;
+
+            GoengcLadderResult result;
+            goengc_ladder_read(board, index, MAX_NODES, &result);
+            GoengcLadderStatus expected = naive_read(board, index, &nodes);
+            if (result.status != expected) {
+                fprintf(stderr, "position %u point %u: status %d, reference "
+                                "%d\n",
+                        i, index, result.status, expected);
+                return 1;
+            }
+
+            /* The reported move must decide the ladder */
+            if (result.move != GOENGC_LADDER_NO_POINT) {
+                GoengcColor color =
+                    goengc_colorfield_get_color(&board->color_field, index);
+                next = *board;
+                goengc_board_play(
+                    &next, goengc_move_create(
+                               liberties == 1 ? color
+                                              : goengc_color_opposite(color),
+                               0, goengc_index_to_coord(result.move)));
+                GoengcLadderResult after;
+                goengc_ladder_read(&next, index, MAX_NODES, &after);
+                int decided =
+                    liberties == 1
+                        ? after.status == GOENGC_LADDER_NONE ||
+                              after.status == GOENGC_LADDER_ESCAPED
+                        : after.status == GOENGC_LADDER_CAPTURED;
+                if (!decided) {
+                    fprintf(stderr, "position %u point %u: move %u does not "
+                                    "decide the ladder\n",
+                            i, index, result.move);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = argc > 1 ? (uint32_t)atoi(argv[1]) : 20;
+    if (rounds == 0) {
+        rounds = 1;
+    }
+
+    setup_positions();
+    uint32_t num_chains;
+    int failed = check_known() || check_positions(&num_chains);
+    if (failed) {
+        printf("ladders FAILED\n");
+        return 1;
+    }
+
+    /* Feature extraction over the corpus, on point sets and with copies */
+    static GoengcLadderFeatures features;
+    uint64_t nodes = 0;
+    double start = now_ns();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < NUM_POSITIONS; i++) {
+            goengc_ladder_read_all(&positions[i],
+                                   GOENGC_LADDER_DEFAULT_MAX_NODES, &features);
+            nodes += features.nodes;
+        }
+    }
+    double seconds = (now_ns() - start) / 1e9;
+    printf("%ux%u  %u positions, %u chains with 1 or 2 liberties\n",
+           GOENGC_MAX_BOARD_SIZE, GOENGC_MAX_BOARD_SIZE, NUM_POSITIONS,
+           num_chains);
+    printf("sets    %9.0f positions/s  %11.0f nodes/s\n",
+           rounds * NUM_POSITIONS / seconds, nodes / seconds);
+
+    uint32_t copied_nodes = 0;
+    start = now_ns();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < NUM_POSITIONS; i++) {
+            const GoengcBoard* board = &positions[i];
+            const GoengcBitfield* stones = &board->color_field.occupied_bits;
+            for (uint16_t index = goengc_bitfield_find_first(stones);
+                 index < GOENGC_DATA_SIZE_SQUARED;
+                 index = goengc_bitfield_find_next(stones, index + 1)) {
+                if (goengc_board_get_chain(board, index) == index &&
+                    goengc_board_get_liberties(board, index) <= 2) {
+                    naive_read(board, index, &copied_nodes);
+                }
+            }
+        }
+    }
+    seconds = (now_ns() - start) / 1e9;
+    printf("copies  %9.0f positions/s  %11.0f nodes/s\n",
+           rounds * NUM_POSITIONS / seconds, copied_nodes / seconds);
+
+    printf("ladders passed\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/mcts.h"
+#include "goengc/types.h"
+
+/* Board size of the search: 9x9, or smaller if the build is */
+#if GOENGC_MAX_BOARD_SIZE < 9
+#define SMALL_BOARD_SIZE GOENGC_MAX_BOARD_SIZE
+#else
+#define SMALL_BOARD_SIZE 9
+#endif
+
+#define TREE_MB 64
+#define VISITS_PER_THREAD 10000
+#define NUM_GAME_MOVES 4
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+    const int max_threads = argc > 1 ? atoi(argv[1]) : 16;
+    GoengcBoard root;
+    goengc_board_init(&root,
+                      goengc_vec2_create(SMALL_BOARD_SIZE, SMALL_BOARD_SIZE),
+                      15, GOENGC_SCORING_AREA);
+
+    /* Visits per second from the empty board; the work grows with the
+     * threads, so perfect scaling keeps the time constant */
+    printf("MCTS on %dx%d, %d visits per thread\n", SMALL_BOARD_SIZE,
+           SMALL_BOARD_SIZE, VISITS_PER_THREAD);
+    double base_rate = 0.0;
+    for (int num_threads = 1;
+         num_threads <= max_threads && num_threads <= GOENGC_MCTS_MAX_THREADS;
+         num_threads *= 2) {
+        GoengcMcts mcts;
+        if (goengc_mcts_init(&mcts, &root, GOENGC_COLOR_BLACK, TREE_MB,
+                             (uint64_t)num_threads) != 0) {
+            fprintf(stderr, "could not allocate the tree\n");
+            return 1;
+        }
+        uint32_t num_visits = (uint32_t)num_threads * VISITS_PER_THREAD;
+        double start = now_ns();
+        uint16_t used = goengc_mcts_search(&mcts, num_visits,
+                                           (uint16_t)num_threads);
+        double seconds = (now_ns() - start) / 1e9;
+
+        GoengcMctsStats stats;
+        goengc_mcts_get_stats(&mcts, &stats);
+        GoengcMove best = goengc_mcts_get_best_move(&mcts);
+        double rate = num_visits / seconds;
+        if (num_threads == 1) {
+            base_rate = rate;
+        }
+        printf("%2d thread(s)  %9.0f visits/s  speedup %5.2f  nodes %8u "
+               "(%6.2f of %.0f MiB)  black wins %5.1f%%  best ",
+               used, rate, rate / base_rate, stats.num_nodes,
+               stats.bytes_used / 1048576.0, stats.bytes_total / 1048576.0,
+               100.0 * stats.root_value);
+        if (best.is_pass) {
+            printf("pass\n");
+        } else {
+            printf("(%d, %d)\n", best.coord.x - GOENGC_PAD,
+                   best.coord.y - GOENGC_PAD);
+        }
+        goengc_mcts_free(&mcts);
+    }
+
+    /* A short self-play game: advancing reclaims the whole tree */
+    GoengcMcts mcts;
+    if (goengc_mcts_init(&mcts, &root, GOENGC_COLOR_BLACK, TREE_MB, 1) != 0) {
+        return 1;
+    }
+    double start = now_ns();
+    for (int i = 0; i < NUM_GAME_MOVES; i++) {
+        goengc_mcts_search(&mcts, VISITS_PER_THREAD, 1);
+        goengc_mcts_advance(&mcts, goengc_mcts_get_best_move(&mcts));
+    }
+    printf("%d self-play moves in %.2f s\n", NUM_GAME_MOVES,
+           (now_ns() - start) / 1e9);
+    goengc_mcts_free(&mcts);
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/constants.h"
+#include "goengc/pattern.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "goengc/symmetry.h"
+#include "goengc/types.h"
+
+#define SEED 20240611
+
+/* Board size of the checks and timings: 9x9, or smaller if the build is */
+#if GOENGC_MAX_BOARD_SIZE < 9
+#define SMALL_BOARD_SIZE GOENGC_MAX_BOARD_SIZE
+#else
+#define SMALL_BOARD_SIZE 9
+#endif
+
+static GoengcPatternTable flat_table;
+static GoengcPatternTable contact_table;
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Pattern code of a point computed from the colors */
+static uint16_t slow_pattern(const GoengcBoard* board, uint16_t index) {
+    uint16_t pattern = 0;
+    for (int k = 0; k < 8; k++) {
+        int32_t neighbor = index + GOENGC_NEIGHBOR_8[k];
+        if (neighbor >= 0 && neighbor < GOENGC_DATA_SIZE_SQUARED) {
+            pattern |= (uint16_t)(goengc_colorfield_get_color(
+                                      &board->color_field, (uint16_t)neighbor)
+                                  << (2 * k));
+        }
+    }
+    return pattern;
+}
+
+/* Compare the maintained codes of all points with recomputed ones */
+static int check_patterns(const GoengcBoard* board, const char* after) {
+    for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED; index++) {
+        if (goengc_board_get_pattern(board, index) !=
+            slow_pattern(board, index)) {
+            fprintf(stderr, "pattern of point %u differs after %s\n", index,
+                    after);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Check the eye test and the symmetries of the codes on one position */
+static int check_position(const GoengcBoard* board) {
+    GoengcBitfield empty;
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY, &empty);
+    for (uint16_t index = goengc_bitfield_find_first(&empty);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(&empty, index + 1)) {
+        uint16_t pattern = goengc_board_get_pattern(board, index);
+        for (GoengcColor color = GOENGC_COLOR_BLACK;
+             color <= GOENGC_COLOR_WHITE; color++) {
+            if (goengc_pattern_is_eye(pattern, color) !=
+                goengc_board_is_eye(board, index, color)) {
+                fprintf(stderr, "eye test differs at point %u\n", index);
+                return 1;
+            }
+        }
+    }
+
+    uint8_t count = goengc_symmetry_count(board->board_size);
+    for (uint8_t s = 0; s < count; s++) {
+        static GoengcBoard image;
+        goengc_board_transform(board, (GoengcSymmetry)s, &image);
+        for (uint16_t index = goengc_bitfield_find_first(&empty);
+             index < GOENGC_DATA_SIZE_SQUARED;
+             index = goengc_bitfield_find_next(&empty, index + 1)) {
+            uint16_t mapped = goengc_symmetry_apply_index(
+                index, board->board_size, (GoengcSymmetry)s);
+            if (goengc_board_get_pattern(&image, mapped) !=
+                goengc_pattern_transform(
+                    goengc_board_get_pattern(board, index),
+                    (GoengcSymmetry)s)) {
+                fprintf(stderr, "symmetry %u of point %u differs\n", s,
+                        index);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Play random games with undos and setup moves, checking the codes after
+ * every change */
+static int check_games(uint32_t num_games) {
+    static GoengcBoard board;
+    GoengcRng rng;
+    GoengcBitfield legal;
+    goengc_rng_seed(&rng, SEED);
+
+    for (uint32_t game = 0; game < num_games; game++) {
+        goengc_board_init(&board,
+                          goengc_vec2_create(SMALL_BOARD_SIZE, SMALL_BOARD_SIZE),
+                          15, GOENGC_SCORING_AREA);
+        if (check_patterns(&board, "reset")) {
+            return 1;
+        }
+        GoengcColor color = GOENGC_COLOR_BLACK;
+        for (int m = 0; m < 3 * SMALL_BOARD_SIZE * SMALL_BOARD_SIZE; m++) {
+            goengc_board_get_legal_moves(&board, color, &legal);
+            uint16_t count = goengc_bitfield_count_bits(&legal);
+            if (count == 0) {
+                break;
+            }
+            uint16_t index = goengc_bitfield_select(
+                &legal, (uint16_t)goengc_rng_below(&rng, count));
+            GoengcMove move =
+                goengc_move_create(color, 0, goengc_index_to_coord(index));
+
+            /* Take every fourth move back and play it again */
+            GoengcUndo undo;
+            goengc_board_play_undoable(&board, move, &undo);
+            if (check_patterns(&board, "play")) {
+                return 1;
+            }
+            if (m % 4 == 3) {
+                goengc_board_undo(&board, &undo);
+                if (check_patterns(&board, "undo")) {
+                    return 1;
+                }
+                goengc_board_play(&board, move);
+            }
+
+            /* Remove or recolor a random point now and then */
+            if (m % 16 == 15) {
+                uint16_t point = goengc_coord_to_index(
+                    GOENGC_PAD + goengc_rng_below(&rng, SMALL_BOARD_SIZE),
+                    GOENGC_PAD + goengc_rng_below(&rng, SMALL_BOARD_SIZE));
+                GoengcColor setup = (GoengcColor)(GOENGC_COLOR_EMPTY +
+                                                  goengc_rng_below(&rng, 3));
+                goengc_board_setup_move(
+                    &board,
+                    goengc_move_create(setup, 0, goengc_index_to_coord(point)));
+                if (check_patterns(&board, "setup")) {
+                    return 1;
+                }
+            }
+            color = goengc_color_opposite(color);
+        }
+        if (check_position(&board)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* A table with equal weights must play the same games as uniform playouts */
+static int check_flat_playouts(uint32_t num_playouts) {
+    static GoengcBoard root, uniform, patterned;
+    GoengcWorkspace workspace;
+    GoengcRng uniform_rng, pattern_rng;
+    goengc_board_init(&root,
+                      goengc_vec2_create(SMALL_BOARD_SIZE, SMALL_BOARD_SIZE),
+                      15, GOENGC_SCORING_AREA);
+    goengc_rng_seed(&uniform_rng, SEED);
+    goengc_rng_seed(&pattern_rng, SEED);
+
+    for (uint32_t i = 0; i < num_playouts; i++) {
+        uniform = root;
+        patterned = root;
+        GoengcPlayoutResult expected = goengc_playout_run(
+            &uniform, &workspace, GOENGC_COLOR_BLACK, &uniform_rng);
+        GoengcPlayoutResult result = goengc_playout_run_patterns(
+            &patterned, &workspace, GOENGC_COLOR_BLACK, &flat_table,
+            &pattern_rng);
+        if (result.score2 != expected.score2 ||
+            result.num_moves != expected.num_moves ||
+            patterned.hash != uniform.hash) {
+            fprintf(stderr, "playout %u differs from the uniform one\n", i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Edge points weighted 4, others 1: the pick frequency of the edge on the
+ * empty board must match */
+static int check_distribution(uint32_t num_picks) {
+    static GoengcPatternTable table;
+    static GoengcBoard board;
+    GoengcBitfield candidates;
+    GoengcRng rng;
+    goengc_pattern_table_init(&table, 1);
+    goengc_board_init(&board,
+                      goengc_vec2_create(SMALL_BOARD_SIZE, SMALL_BOARD_SIZE),
+                      15, GOENGC_SCORING_AREA);
+    uint32_t edge_weight = 0, total_weight = 0;
+    for (uint8_t y = 0; y < SMALL_BOARD_SIZE; y++) {
+        for (uint8_t x = 0; x < SMALL_BOARD_SIZE; x++) {
+            uint16_t index = goengc_coord_to_index(x + GOENGC_PAD,
+                                                   y + GOENGC_PAD);
+            uint16_t pattern = goengc_board_get_pattern(&board, index);
+            int edge = goengc_pattern_get_color(pattern, 0) ==
+                           GOENGC_COLOR_OFF_BOARD ||
+                       goengc_pattern_get_color(pattern, 1) ==
+                           GOENGC_COLOR_OFF_BOARD ||
+                       goengc_pattern_get_color(pattern, 2) ==
+                           GOENGC_COLOR_OFF_BOARD ||
+                       goengc_pattern_get_color(pattern, 3) ==
+                           GOENGC_COLOR_OFF_BOARD;
+            if (edge) {
+                goengc_pattern_table_set(&table, pattern, 4);
+                edge_weight += 4;
+                total_weight += 4;
+            } else {
+                total_weight += 1;
+            }
+        }
+    }
+
+    goengc_rng_seed(&rng, SEED);
+    uint32_t edge_picks = 0;
+    for (uint32_t i = 0; i < num_picks; i++) {
+        uint16_t index = goengc_pattern_pick(&board, &table, GOENGC_COLOR_BLACK,
+                                             &candidates, &rng);
+        edge_picks += goengc_pattern_table_get(&table, &board, index,
+                                               GOENGC_COLOR_BLACK) == 4;
+    }
+    double expected = (double)edge_weight / total_weight;
+    double observed = (double)edge_picks / num_picks;
+    printf("edge pick rate %.4f, expected %.4f\n", observed, expected);
+    if (fabs(observed - expected) > 0.01) {
+        fprintf(stderr, "pick frequencies do not follow the weights\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* Playouts per second from the empty board, uniform or by pattern */
+static double time_playouts(uint8_t size, const GoengcPatternTable* table,
+                            uint32_t num_playouts, double* moves) {
+    static GoengcBoard root, board;
+    GoengcWorkspace workspace;
+    GoengcRng rng;
+    goengc_board_init(&root, goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+    goengc_rng_seed(&rng, SEED);
+
+    uint64_t total_moves = 0;
+    double start = now_ns();
+    for (uint32_t i = 0; i < num_playouts; i++) {
+        board = root;
+        GoengcPlayoutResult result =
+            table != NULL
+                ? goengc_playout_run_patterns(&board, &workspace,
+                                              GOENGC_COLOR_BLACK, table, &rng)
+                : goengc_playout_run(&board, &workspace, GOENGC_COLOR_BLACK,
+                                     &rng);
+        total_moves += result.num_moves;
+    }
+    double seconds = (now_ns() - start) / 1e9;
+    *moves = (double)total_moves / num_playouts;
+    return num_playouts / seconds;
+}
+
+int main(int argc, char** argv) {
+    uint32_t num_playouts = argc > 1 ? (uint32_t)atoi(argv[1]) : 20000;
+    if (num_playouts == 0) {
+        num_playouts = 1;
+    }
+
+    goengc_pattern_table_init(&flat_table, 1);
+    /* Moves touching a stone are four times as likely as others */
+    goengc_pattern_table_init(&contact_table, 1);
+    for (uint32_t pattern = 0; pattern < GOENGC_PATTERN_COUNT; pattern++) {
+        if (contact_table.weights[pattern] == 0) {
+            continue;
+        }
+        for (int k = 0; k < 4; k++) {
+            GoengcColor color = goengc_pattern_get_color((uint16_t)pattern, k);
+            if (color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE) {
+                goengc_pattern_table_set(&contact_table, (uint16_t)pattern, 4);
+                break;
+            }
+        }
+    }
+
+    int failed = check_games(200) || check_flat_playouts(200) ||
+                 check_distribution(200000);
+
+    printf("Playouts from the empty board (area scoring, komi 7.5)\n");
+    uint8_t sizes[2] = {SMALL_BOARD_SIZE, GOENGC_MAX_BOARD_SIZE};
+    for (int s = 0; s < (sizes[0] == sizes[1] ? 1 : 2); s++) {
+        uint32_t count = s == 0 ? num_playouts : num_playouts / 10 + 1;
+        double moves;
+        double uniform = time_playouts(sizes[s], NULL, count, &moves);
+        printf("%2ux%-2u  uniform  %9.0f playouts/s  %6.1f moves\n", sizes[s],
+               sizes[s], uniform, moves);
+        double contact = time_playouts(sizes[s], &contact_table, count, &moves);
+        printf("%2ux%-2u  pattern  %9.0f playouts/s  %6.1f moves  (%.2fx)\n",
+               sizes[s], sizes[s], contact, moves, contact / uniform);
+    }
+
+    printf(failed ? "patterns FAILED\n" : "patterns passed\n");
+    return failed;
+}
@@ -0,0 +1,140 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/constants.h"
+#include "goengc/types.h"
+
+/* Throughput target for play + legality on random games on the largest
+ * supported board, in moves per second of an optimized build */
+#define TARGET_MOVES_PER_SECOND 1000000.0
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* xorshift64* generator */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/* A point whose neighbors are all own stones or off board */
+static int is_own_eye(const GoengcBoard* board, uint16_t index,
+                      GoengcColor color) {
+    for (int n = 0; n < 4; n++) {
+        GoengcColor neighbor = goengc_colorfield_get_color(
+            &board->color_field, index + GOENGC_NEIGHBOR_4[n]);
+        if (neighbor != color && neighbor != GOENGC_COLOR_OFF_BOARD) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+typedef struct {
+    uint64_t moves;
+    uint64_t legality_checks;
+    uint64_t captures;
+} PlayStats;
+
+/* Play one random game: each move scans the empty points from a random start
+ * until it finds a legal move that does not fill an own eye */
+static void play_random_game(GoengcBoard* board, uint64_t* rng,
+                             PlayStats* stats) {
+    GoengcColor color = GOENGC_COLOR_BLACK;
+    GoengcBitfield empty;
+    int passes = 0;
+    int max_moves = 3 * board->board_size.x * board->board_size.y;
+
+    goengc_board_reset(board);
+    for (int move_number = 0; move_number < max_moves && passes < 2;
+         move_number++) {
+        goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY,
+                                   &empty);
+        uint16_t start =
+            (uint16_t)(next_random(rng) % GOENGC_DATA_SIZE_SQUARED);
+        GoengcMove move = goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+
+        /* Scan [start, end) and then wrap around to [0, start) */
+        uint16_t index = goengc_bitfield_find_next(&empty, start);
+        int wrapped = 0;
+        for (;;) {
+            if (index >= GOENGC_DATA_SIZE_SQUARED) {
+                if (wrapped) {
+                    break;
+                }
+                wrapped = 1;
+                index = goengc_bitfield_find_next(&empty, 0);
+                continue;
+            }
+            if (wrapped && index >= start) {
+                break;
+            }
+
+            GoengcMove candidate =
+                goengc_move_create(color, 0, goengc_index_to_coord(index));
+            stats->legality_checks++;
+            if (goengc_board_is_legal(board, candidate) &&
+                !is_own_eye(board, index, color)) {
+                move = candidate;
+                break;
+            }
+            index = goengc_bitfield_find_next(&empty, index + 1);
+        }
+
+        passes = move.is_pass ? passes + 1 : 0;
+        stats->captures += goengc_board_play(board, move);
+        stats->moves++;
+        color = goengc_color_opposite(color);
+    }
+}
+
+int main(void) {
+    const int num_games = 2000;
+    GoengcBoard board;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    PlayStats stats = {0, 0, 0};
+
+    goengc_board_init(&board, goengc_vec2_create(GOENGC_MAX_BOARD_SIZE,
+                                                GOENGC_MAX_BOARD_SIZE), 15,
+                      GOENGC_SCORING_AREA);
+
+    /* Warm up */
+    for (int i = 0; i < num_games / 10; i++) {
+        play_random_game(&board, &rng, &stats);
+    }
+
+    stats = (PlayStats){0, 0, 0};
+    double start = now_ns();
+    for (int i = 0; i < num_games; i++) {
+        play_random_game(&board, &rng, &stats);
+    }
+    double seconds = (now_ns() - start) / 1e9;
+
+    double moves_per_second = (double)stats.moves / seconds;
+    printf("Random %ux%u games: %d\n", GOENGC_MAX_BOARD_SIZE,
+           GOENGC_MAX_BOARD_SIZE, num_games);
+    printf("  moves            %llu (%.1f per game)\n",
+           (unsigned long long)stats.moves, (double)stats.moves / num_games);
+    printf("  legality checks  %llu (%.1f per move)\n",
+           (unsigned long long)stats.legality_checks,
+           (double)stats.legality_checks / (double)stats.moves);
+    printf("  captured stones  %llu\n", (unsigned long long)stats.captures);
+    printf("  games/s          %.0f\n", num_games / seconds);
+    printf("  moves/s          %.0f (target %.0f: %s)\n", moves_per_second,
+           TARGET_MOVES_PER_SECOND,
+           moves_per_second >= TARGET_MOVES_PER_SECOND ? "met" : "missed");
+    printf("  checks/s         %.0f\n",
+           (double)stats.legality_checks / seconds);
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "goengc/types.h"
+
+/* Board size of the high-volume run: 9x9, or smaller if the build is */
+#if GOENGC_MAX_BOARD_SIZE < 9
+#define SMALL_BOARD_SIZE GOENGC_MAX_BOARD_SIZE
+#else
+#define SMALL_BOARD_SIZE 9
+#endif
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Run playouts from the empty board and report their throughput */
+static void run_size(uint8_t size, int8_t komi2, int num_playouts) {
+    GoengcBoard root;
+    GoengcBoard board;
+    GoengcWorkspace workspace;
+    GoengcRng rng;
+    goengc_board_init(&root, goengc_vec2_create(size, size), komi2,
+                      GOENGC_SCORING_AREA);
+    goengc_rng_seed(&rng, size);
+
+    /* Warm up */
+    for (int i = 0; i < num_playouts / 10; i++) {
+        board = root;
+        goengc_playout_run(&board, &workspace, GOENGC_COLOR_BLACK, &rng);
+    }
+
+    uint64_t moves = 0;
+    int black_wins = 0;
+    double start = now_ns();
+    for (int i = 0; i < num_playouts; i++) {
+        board = root;
+        GoengcPlayoutResult result =
+            goengc_playout_run(&board, &workspace, GOENGC_COLOR_BLACK, &rng);
+        moves += result.num_moves;
+        black_wins += result.score2 > 0;
+    }
+    double seconds = (now_ns() - start) / 1e9;
+
+    printf("%2ux%-2u  %7d playouts  %9.0f playouts/s  %6.1f moves/playout  "
+           "%10.0f moves/s  black wins %.1f%%\n",
+           size, size, num_playouts, num_playouts / seconds,
+           (double)moves / num_playouts, (double)moves / seconds,
+           100.0 * black_wins / num_playouts);
+}
+
+int main(void) {
+    printf("Uniform random playouts (area scoring, komi 7.5)\n");
+    run_size(SMALL_BOARD_SIZE, 15, 100000);
+#if GOENGC_MAX_BOARD_SIZE > SMALL_BOARD_SIZE
+    run_size(GOENGC_MAX_BOARD_SIZE, 15, 10000);
+#endif
+    return 0;
+}
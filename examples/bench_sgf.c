@@ -0,0 +1,192 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/random.h"
+#include "goengc/sgf.h"
+#include "goengc/types.h"
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Growable text buffer */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Text;
+
+static void text_append(Text* text, const char* data, size_t length) {
+    if (text->length + length > text->capacity) {
+        text->capacity = 2 * (text->length + length);
+        text->data = realloc(text->data, text->capacity);
+        if (text->data == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+}
+
+/* Append one random game and return the hash of its final position. Every
+ * fourth game carries a side variation that the replay must skip. */
+static uint64_t generate_game(Text* text, GoengcRng* rng, int with_variation) {
+    const uint8_t size = GOENGC_MAX_BOARD_SIZE;
+    GoengcBoard board;
+    goengc_board_init(&board, goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+
+    char node[64];
+    int length = snprintf(node, sizeof(node),
+                          "(;GM[1]FF[4]SZ[%u]KM[7.5]RU[Chinese]AB[%c%c]\n",
+                          size, 'a' + size / 2, 'a' + size / 2);
+    text_append(text, node, (size_t)length);
+    goengc_board_setup_move(
+        &board, goengc_move_create(GOENGC_COLOR_BLACK, 0,
+                                   goengc_vec2_create(GOENGC_PAD + size / 2,
+                                                      GOENGC_PAD + size / 2)));
+
+    GoengcColor color = GOENGC_COLOR_WHITE;
+    int passes = 0;
+    int max_moves = 3 * size * size;
+    for (int move_number = 0; move_number < max_moves && passes < 2;
+         move_number++) {
+        /* Draw empty points until one is legal and not an own eye */
+        GoengcBitfield candidates;
+        goengc_colorfield_get_mask(&board.color_field, GOENGC_COLOR_EMPTY,
+                                   &candidates);
+        uint16_t count = goengc_bitfield_count_bits(&candidates);
+        GoengcMove move = goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+        while (count > 0) {
+            uint16_t index = goengc_bitfield_select(
+                &candidates, goengc_rng_below(rng, count));
+            GoengcMove candidate =
+                goengc_move_create(color, 0, goengc_index_to_coord(index));
+            if (!goengc_board_is_eye(&board, index, color) &&
+                goengc_board_is_legal(&board, candidate)) {
+                move = candidate;
+                break;
+            }
+            goengc_bitfield_clear_bit(&candidates, index);
+            count--;
+        }
+
+        char letter = color == GOENGC_COLOR_BLACK ? 'B' : 'W';
+        if (move.is_pass) {
+            length = snprintf(node, sizeof(node), ";%c[]", letter);
+        } else {
+            length = snprintf(node, sizeof(node), ";%c[%c%c]", letter,
+                              'a' + move.coord.x - GOENGC_PAD,
+                              'a' + move.coord.y - GOENGC_PAD);
+        }
+        text_append(text, node, (size_t)length);
+        if (move_number % 10 == 9) {
+            text_append(text, "\n", 1);
+        }
+
+        if (with_variation && move_number == 20) {
+            /* Continue the main line in a subtree, followed by a variation
+             * that plays on an occupied point */
+            const char* branch = "(;C[main [line\\]]";
+            text_append(text, branch, strlen(branch));
+        }
+
+        goengc_board_play(&board, move);
+        passes = move.is_pass ? passes + 1 : 0;
+        color = goengc_color_opposite(color);
+    }
+
+    const char* end = with_variation ? ")(;B[aa];W[aa];B[aa]))\n" : ")\n";
+    text_append(text, end, strlen(end));
+    return board.hash;
+}
+
+/* Replay state checked against the generated games */
+typedef struct {
+    const uint64_t* hashes;
+    uint64_t num_games;
+    uint64_t mismatches;
+} Check;
+
+static int check_end_game(const GoengcBoard* board, void* user) {
+    Check* check = user;
+    check->mismatches += board->hash != check->hashes[check->num_games];
+    check->num_games++;
+    return 1;
+}
+
+/* Replay a corpus and report the throughput */
+static int report(const char* name, GoengcSgfStatus status,
+                  const GoengcSgfStats* stats, const Check* check,
+                  uint64_t expected_games, double seconds, size_t bytes) {
+    printf("%-7s %7llu games  %9llu moves  %8.0f games/s  %10.0f moves/s  "
+           "%7.1f MB/s\n",
+           name, (unsigned long long)stats->games,
+           (unsigned long long)stats->moves, stats->games / seconds,
+           stats->moves / seconds, bytes / seconds / 1e6);
+    if (status != GOENGC_SGF_OK || stats->games != expected_games ||
+        stats->skipped != 0 || check->mismatches != 0) {
+        fprintf(stderr, "%s replay failed: status %d, %llu skipped, "
+                        "%llu final positions differ\n",
+                name, (int)status, (unsigned long long)stats->skipped,
+                (unsigned long long)check->mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t num_games = argc > 1 ? strtoull(argv[1], NULL, 10) : 2000;
+    Text corpus = {NULL, 0, 0};
+    uint64_t* hashes = malloc(num_games * sizeof(uint64_t));
+    if (hashes == NULL) {
+        return 1;
+    }
+
+    GoengcRng rng;
+    goengc_rng_seed(&rng, 42);
+    for (uint64_t i = 0; i < num_games; i++) {
+        hashes[i] = generate_game(&corpus, &rng, i % 4 == 3);
+    }
+    printf("SGF replay of %llu random %ux%u games (%.1f MB)\n",
+           (unsigned long long)num_games, GOENGC_MAX_BOARD_SIZE,
+           GOENGC_MAX_BOARD_SIZE, corpus.length / 1e6);
+
+    GoengcBoard board;
+    GoengcSgfStats stats;
+    Check check = {hashes, 0, 0};
+    GoengcSgfHandler handler = {NULL, NULL, check_end_game, &check};
+    int failed = 0;
+
+    double start = now_ns();
+    GoengcSgfStatus status = goengc_sgf_replay_buffer(
+        corpus.data, corpus.length, &board, &handler, &stats);
+    failed |= report("buffer", status, &stats, &check, num_games,
+                     (now_ns() - start) / 1e9, corpus.length);
+
+    FILE* file = tmpfile();
+    if (file == NULL ||
+        fwrite(corpus.data, 1, corpus.length, file) != corpus.length) {
+        fprintf(stderr, "cannot write the corpus file\n");
+        return 1;
+    }
+    rewind(file);
+    check = (Check){hashes, 0, 0};
+    start = now_ns();
+    status = goengc_sgf_replay_file(file, &board, &handler, &stats);
+    failed |= report("file", status, &stats, &check, num_games,
+                     (now_ns() - start) / 1e9, corpus.length);
+    fclose(file);
+
+    free(corpus.data);
+    free(hashes);
+    return failed;
+}
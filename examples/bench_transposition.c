@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goengc/random.h"
+#include "goengc/transposition.h"
+#include "goengc/zobrist.h"
+
+#define TABLE_MB 64
+#define OPS_PER_THREAD 4000000
+#define MAX_THREADS 16
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* The payload every writer stores for a key, so readers can check it */
+static GoengcTranspositionData payload_of(uint64_t key) {
+    return (GoengcTranspositionData){.move = (uint16_t)(key & 0x1FF),
+                                     .value = (int16_t)(key >> 16),
+                                     .weight = (uint16_t)(key >> 32 & 0xFF),
+                                     .flags = (uint8_t)(key >> 40),
+                                     .generation = 0};
+}
+
+typedef struct {
+    GoengcTranspositionTable* table;
+    uint64_t num_keys;
+    uint64_t seed;
+    GoengcTranspositionStats stats;
+    uint64_t corrupt;
+} Worker;
+
+/* Half probes, half stores, over keys shared by all threads */
+static void* run_worker(void* arg) {
+    Worker* worker = arg;
+    GoengcRng rng;
+    goengc_rng_seed(&rng, worker->seed);
+    for (uint32_t i = 0; i < OPS_PER_THREAD; i++) {
+        uint64_t r = goengc_rng_next(&rng);
+        uint64_t key = goengc_zobrist_mix(r % worker->num_keys);
+        if (r >> 63) {
+            goengc_transposition_store(worker->table, key, payload_of(key),
+                                       &worker->stats);
+        } else {
+            GoengcTranspositionData data;
+            if (goengc_transposition_probe(worker->table, key, &data,
+                                           &worker->stats)) {
+                GoengcTranspositionData expected = payload_of(key);
+                worker->corrupt += data.move != expected.move ||
+                                   data.value != expected.value ||
+                                   data.weight != expected.weight ||
+                                   data.flags != expected.flags;
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    const int max_threads = argc > 1 ? atoi(argv[1]) : 8;
+    GoengcTranspositionTable table;
+    if (goengc_transposition_init(&table, TABLE_MB) != 0) {
+        return 1;
+    }
+    uint64_t num_entries =
+        goengc_transposition_num_buckets(&table) *
+        GOENGC_TRANSPOSITION_BUCKET_ENTRIES;
+    printf("Transposition table of %d MiB, %llu entries\n", TABLE_MB,
+           (unsigned long long)num_entries);
+
+    int failed = 0;
+    for (int num_threads = 1; num_threads <= max_threads &&
+                              num_threads <= MAX_THREADS;
+         num_threads *= 2) {
+        goengc_transposition_clear(&table);
+        goengc_transposition_new_generation(&table);
+
+        /* Twice as many keys as entries keeps the replacement busy */
+        Worker workers[MAX_THREADS] = {0};
+        pthread_t handles[MAX_THREADS];
+        double start = now_ns();
+        for (int t = 0; t < num_threads; t++) {
+            workers[t] = (Worker){&table, 2 * num_entries, (uint64_t)t + 1,
+                                  {0, 0, 0, 0, 0}, 0};
+            if (pthread_create(&handles[t], NULL, run_worker, &workers[t]) !=
+                0) {
+                return 1;
+            }
+        }
+        GoengcTranspositionStats total = {0, 0, 0, 0, 0};
+        uint64_t corrupt = 0;
+        for (int t = 0; t < num_threads; t++) {
+            pthread_join(handles[t], NULL);
+            total.probes += workers[t].stats.probes;
+            total.hits += workers[t].stats.hits;
+            total.stores += workers[t].stats.stores;
+            total.overwrites += workers[t].stats.overwrites;
+            total.collisions += workers[t].stats.collisions;
+            corrupt += workers[t].corrupt;
+        }
+        double seconds = (now_ns() - start) / 1e9;
+
+        printf("%2d thread(s)  %7.1f Mops/s  hit rate %5.1f%%  overwrites "
+               "%5.1f%%  collisions %5.1f%%\n",
+               num_threads,
+               (double)num_threads * OPS_PER_THREAD / seconds / 1e6,
+               100.0 * total.hits / total.probes,
+               100.0 * total.overwrites / total.stores,
+               100.0 * total.collisions / total.stores);
+        if (corrupt != 0) {
+            fprintf(stderr, "%llu hits returned another position's data\n",
+                    (unsigned long long)corrupt);
+            failed = 1;
+        }
+    }
+
+    goengc_transposition_free(&table);
+    return failed;
+}
@@ -0,0 +1,535 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/floodfill.h"
+#include "goengc/game.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "goengc/scoring.h"
+#include "goengc/types.h"
+
+/* Board size of the small playout run: 9x9, or smaller if the build is */
+#if GOENGC_MAX_BOARD_SIZE < 9
+#define SMALL_BOARD_SIZE GOENGC_MAX_BOARD_SIZE
+#else
+#define SMALL_BOARD_SIZE 9
+#endif
+
+/* The corpus is a fixed set of positions from seeded random games, so every
+ * run and every release measures the same work */
+#define CORPUS_SEED 20240611
+#define CORPUS_SIZE 32
+#define NUM_PLAY_MOVES (CORPUS_SIZE * 8)
+
+#define MAX_REPEATS 1000
+#define NUM_POINTS (GOENGC_MAX_BOARD_SIZE * GOENGC_MAX_BOARD_SIZE)
+
+typedef void (*BenchFn)(uint32_t iterations);
+
+typedef struct {
+    const char* name;
+    const char* unit; /* What one operation is */
+    BenchFn run;
+} Benchmark;
+
+/* Timing of one benchmark, in nanoseconds per operation */
+typedef struct {
+    uint32_t iterations; /* Operations per sample */
+    uint32_t repeats;    /* Samples */
+    double mean;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+} BenchResult;
+
+typedef struct {
+    uint32_t repeats;
+    double min_sample_ns; /* Samples are sized to last at least this long */
+    int json;
+    const char* filter;
+} BenchOptions;
+
+/* Results are folded in here so the compiler cannot drop the work */
+static volatile uint64_t sink;
+
+static const GoengcVec2 full_size = {GOENGC_MAX_BOARD_SIZE,
+                                     GOENGC_MAX_BOARD_SIZE};
+
+static GoengcBoard corpus[CORPUS_SIZE];       /* Positions mid-game */
+static GoengcColor corpus_to_move[CORPUS_SIZE];
+static GoengcBoard corpus_final[CORPUS_SIZE]; /* Played out to the end */
+static GoengcBoard fill_empty;
+static GoengcBoard fill_spiral;
+static GoengcBoard fill_chains;
+static uint16_t points[NUM_POINTS]; /* On-board indices of the full board */
+static struct {
+    uint8_t position;
+    GoengcMove move;
+} play_moves[NUM_PLAY_MOVES];
+static GoengcWorkspace workspace;
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Pick a uniformly random legal move that does not fill an own eye, or
+ * return 0 if there is none */
+static int pick_random_move(const GoengcBoard* board, GoengcColor color,
+                            GoengcRng* rng, GoengcBitfield* legal,
+                            GoengcMove* move) {
+    goengc_board_get_legal_moves(board, color, legal);
+    uint16_t count = goengc_bitfield_count_bits(legal);
+    while (count > 0) {
+        uint16_t index =
+            goengc_bitfield_select(legal, goengc_rng_below(rng, count));
+        if (!goengc_board_is_eye(board, index, color)) {
+            *move = goengc_move_create(color, 0, goengc_index_to_coord(index));
+            return 1;
+        }
+        goengc_bitfield_clear_bit(legal, index);
+        count--;
+    }
+    return 0;
+}
+
+/* Lay a single black chain along a spiral, leaving a one point wide empty
+ * corridor between its arms */
+static void setup_spiral(GoengcBoard* board) {
+    static const int dx[4] = {1, 0, -1, 0};
+    static const int dy[4] = {0, 1, 0, -1};
+    int size = board->board_size.x;
+    int marked[GOENGC_MAX_BOARD_SIZE][GOENGC_MAX_BOARD_SIZE];
+    memset(marked, 0, sizeof(marked));
+
+    int x = 0, y = 0, dir = 0, turns = 0;
+    marked[y][x] = 1;
+    while (turns < 2) {
+        int nx = x + dx[dir], ny = y + dy[dir];
+        int ax = nx + dx[dir], ay = ny + dy[dir];
+        int inside = nx >= 0 && ny >= 0 && nx < size && ny < size;
+        int ahead_free = ax < 0 || ay < 0 || ax >= size || ay >= size ||
+                         !marked[ay][ax];
+        if (inside && !marked[ny][nx] && ahead_free) {
+            x = nx;
+            y = ny;
+            marked[y][x] = 1;
+            turns = 0;
+        } else {
+            dir = (dir + 1) % 4;
+            turns++;
+        }
+    }
+
+    for (int py = 0; py < size; py++) {
+        for (int px = 0; px < size; px++) {
+            if (marked[py][px]) {
+                goengc_board_setup_move(
+                    board, goengc_move_create(
+                               GOENGC_COLOR_BLACK, 0,
+                               goengc_vec2_create(px + GOENGC_PAD,
+                                                  py + GOENGC_PAD)));
+            }
+        }
+    }
+}
+
+/* Build the corpus and the fixed boards; the same seed gives the same
+ * positions on every run */
+static void setup_corpus(void) {
+    GoengcRng rng;
+    GoengcBitfield legal;
+    goengc_rng_seed(&rng, CORPUS_SEED);
+
+    for (int i = 0; i < CORPUS_SIZE; i++) {
+        /* Spread the positions from the opening to the late middle game */
+        int num_moves = 1 + i * NUM_POINTS / CORPUS_SIZE;
+        GoengcBoard* board = &corpus[i];
+        GoengcColor color = GOENGC_COLOR_BLACK;
+        goengc_board_init(board, full_size, 15, GOENGC_SCORING_AREA);
+        for (int m = 0; m < num_moves; m++) {
+            GoengcMove move;
+            if (!pick_random_move(board, color, &rng, &legal, &move)) {
+                break;
+            }
+            goengc_board_play(board, move);
+            color = goengc_color_opposite(color);
+        }
+        corpus_to_move[i] = color;
+
+        corpus_final[i] = *board;
+        goengc_playout_run(&corpus_final[i], &workspace, color, &rng);
+    }
+
+    for (int i = 0; i < NUM_PLAY_MOVES; i++) {
+        uint8_t position = (uint8_t)(i % CORPUS_SIZE);
+        GoengcColor color = corpus_to_move[position];
+        play_moves[i].position = position;
+        if (!pick_random_move(&corpus[position], color, &rng, &legal,
+                              &play_moves[i].move)) {
+            play_moves[i].move =
+                goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+        }
+    }
+
+    for (int i = 0; i < NUM_POINTS; i++) {
+        points[i] = goengc_coord_to_index(
+            GOENGC_PAD + i % GOENGC_MAX_BOARD_SIZE,
+            GOENGC_PAD + i / GOENGC_MAX_BOARD_SIZE);
+    }
+
+    goengc_board_init(&fill_empty, full_size, 15, GOENGC_SCORING_AREA);
+    goengc_board_init(&fill_spiral, full_size, 15, GOENGC_SCORING_AREA);
+    setup_spiral(&fill_spiral);
+
+    /* Single stones on every other point of every other row: one empty
+     * region around many tiny chains */
+    goengc_board_init(&fill_chains, full_size, 15, GOENGC_SCORING_AREA);
+    for (uint8_t y = 0; y < GOENGC_MAX_BOARD_SIZE; y += 2) {
+        for (uint8_t x = 0; x < GOENGC_MAX_BOARD_SIZE; x += 2) {
+            goengc_board_setup_move(
+                &fill_chains,
+                goengc_move_create((x + y) % 4 ? GOENGC_COLOR_WHITE
+                                               : GOENGC_COLOR_BLACK,
+                                   0,
+                                   goengc_vec2_create(x + GOENGC_PAD,
+                                                      y + GOENGC_PAD)));
+        }
+    }
+}
+
+/* Micro-benchmarks */
+
+static void bench_flood_fill_empty(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_flood_fill(&fill_empty.color_field,
+                          goengc_vec2_create(GOENGC_PAD, GOENGC_PAD),
+                          &workspace.scratch1, &workspace.scratch2);
+        sink += workspace.scratch2.words[GOENGC_BITFIELD_WORDS / 2];
+    }
+}
+
+static void bench_flood_fill_spiral(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_flood_fill(&fill_spiral.color_field,
+                          goengc_vec2_create(GOENGC_PAD, GOENGC_PAD + 1),
+                          &workspace.scratch1, &workspace.scratch2);
+        sink += workspace.scratch2.words[GOENGC_BITFIELD_WORDS / 2];
+    }
+}
+
+static void bench_flood_fill_chains(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_flood_fill(&fill_chains.color_field,
+                          goengc_vec2_create(GOENGC_PAD + 1, GOENGC_PAD),
+                          &workspace.scratch1, &workspace.scratch2);
+        sink += workspace.scratch2.words[GOENGC_BITFIELD_WORDS / 2];
+    }
+}
+
+static void bench_count_bits(uint32_t iterations) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        total += goengc_bitfield_count_bits(
+            &corpus[i % CORPUS_SIZE].color_field.occupied_bits);
+    }
+    sink += total;
+}
+
+static void bench_colorfield_get(uint32_t iterations) {
+    uint64_t total = 0;
+    const GoengcColorField* field = &corpus[CORPUS_SIZE / 2].color_field;
+    for (uint32_t i = 0; i < iterations; i++) {
+        total += goengc_colorfield_get_color(field, points[i % NUM_POINTS]);
+    }
+    sink += total;
+}
+
+static void bench_colorfield_set(uint32_t iterations) {
+    static GoengcColorField field;
+    field = corpus[CORPUS_SIZE / 2].color_field;
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_colorfield_set_color(&field, points[i % NUM_POINTS],
+                                    (GoengcColor)(GOENGC_COLOR_EMPTY + i % 3));
+    }
+    sink += field.color_bits.words[GOENGC_BITFIELD_WORDS / 2];
+}
+
+static void bench_board_reset(uint32_t iterations) {
+    static GoengcBoard board;
+    board = corpus[CORPUS_SIZE - 1];
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_board_reset(&board);
+        sink += board.hash;
+    }
+}
+
+static void bench_is_legal(uint32_t iterations) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t position = i / NUM_POINTS % CORPUS_SIZE;
+        GoengcMove move = goengc_move_create(
+            corpus_to_move[position], 0,
+            goengc_index_to_coord(points[i % NUM_POINTS]));
+        total += goengc_board_is_legal(&corpus[position], move);
+    }
+    sink += total;
+}
+
+static void bench_legal_moves(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t position = i % CORPUS_SIZE;
+        goengc_board_get_legal_moves(&corpus[position],
+                                     corpus_to_move[position],
+                                     &workspace.scratch1);
+        sink += workspace.scratch1.words[GOENGC_BITFIELD_WORDS / 2];
+    }
+}
+
+static void bench_play_undo(uint32_t iterations) {
+    GoengcUndo undo;
+    for (uint32_t i = 0; i < iterations; i++) {
+        GoengcBoard* board = &corpus[play_moves[i % NUM_PLAY_MOVES].position];
+        sink += goengc_board_play_undoable(
+            board, play_moves[i % NUM_PLAY_MOVES].move, &undo);
+        goengc_board_undo(board, &undo);
+    }
+}
+
+static void bench_score(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        GoengcScore score = goengc_score(&corpus_final[i % CORPUS_SIZE], NULL,
+                                         &workspace.scratch1,
+                                         &workspace.scratch2);
+        sink += (uint16_t)score.score2;
+    }
+}
+
+/* Macro-benchmarks */
+
+static void run_playouts(uint8_t size, uint32_t iterations) {
+    GoengcBoard root;
+    GoengcBoard board;
+    GoengcRng rng;
+    goengc_board_init(&root, goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+    goengc_rng_seed(&rng, CORPUS_SEED);
+    for (uint32_t i = 0; i < iterations; i++) {
+        board = root;
+        sink += goengc_playout_run(&board, &workspace, GOENGC_COLOR_BLACK,
+                                   &rng)
+                    .num_moves;
+    }
+}
+
+static void bench_playout_small(uint32_t iterations) {
+    run_playouts(SMALL_BOARD_SIZE, iterations);
+}
+
+static void bench_playout_full(uint32_t iterations) {
+    run_playouts(GOENGC_MAX_BOARD_SIZE, iterations);
+}
+
+/* A random game with full bookkeeping: undo records, hashes and a
+ * positional superko check for every move */
+static void bench_random_game(uint32_t iterations) {
+    static GoengcGame game;
+    GoengcRng rng;
+    GoengcBitfield legal;
+    goengc_rng_seed(&rng, CORPUS_SEED);
+    for (uint32_t i = 0; i < iterations; i++) {
+        goengc_game_init(&game, full_size, 15, GOENGC_SCORING_AREA,
+                         GOENGC_SUPERKO_POSITIONAL);
+        int passes = 0;
+        while (passes < 2 && game.num_moves < GOENGC_GAME_MAX_MOVES) {
+            GoengcColor color = game.to_move;
+            GoengcMove move =
+                goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+            goengc_board_get_legal_moves(&game.board, color, &legal);
+            uint16_t count = goengc_bitfield_count_bits(&legal);
+            while (count > 0) {
+                uint16_t index =
+                    goengc_bitfield_select(&legal, goengc_rng_below(&rng, count));
+                GoengcMove candidate =
+                    goengc_move_create(color, 0, goengc_index_to_coord(index));
+                if (!goengc_board_is_eye(&game.board, index, color) &&
+                    goengc_game_get_superko_legality(&game, candidate) ==
+                        GOENGC_MOVE_LEGAL) {
+                    move = candidate;
+                    break;
+                }
+                goengc_bitfield_clear_bit(&legal, index);
+                count--;
+            }
+            passes = move.is_pass ? passes + 1 : 0;
+            goengc_game_play(&game, move);
+        }
+        sink += game.num_moves;
+    }
+}
+
+static const Benchmark benchmarks[] = {
+    {"flood_fill/empty", "fill", bench_flood_fill_empty},
+    {"flood_fill/spiral", "fill", bench_flood_fill_spiral},
+    {"flood_fill/small_chains", "fill", bench_flood_fill_chains},
+    {"bitfield/count_bits", "count", bench_count_bits},
+    {"colorfield/get_color", "point", bench_colorfield_get},
+    {"colorfield/set_color", "point", bench_colorfield_set},
+    {"board/reset", "reset", bench_board_reset},
+    {"board/is_legal", "check", bench_is_legal},
+    {"board/legal_moves", "position", bench_legal_moves},
+    {"board/play_undo", "move", bench_play_undo},
+    {"scoring/score", "position", bench_score},
+    {"playout/small", "playout", bench_playout_small},
+    {"playout/full", "playout", bench_playout_full},
+    {"game/random", "game", bench_random_game},
+};
+
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples */
+static double percentile(const double* sorted, uint32_t count, double p) {
+    uint32_t rank = (uint32_t)(p / 100.0 * count + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/* Size the samples, warm up, then time the repeats */
+static void run_benchmark(const Benchmark* bench, const BenchOptions* options,
+                          BenchResult* result) {
+    static double samples[MAX_REPEATS];
+
+    /* Double the sample until it lasts long enough to time reliably; the
+     * calibration runs double as the warm-up */
+    uint32_t iterations = 1;
+    for (;;) {
+        double start = now_ns();
+        bench->run(iterations);
+        double elapsed = now_ns() - start;
+        if (elapsed >= options->min_sample_ns || iterations >= 1u << 30) {
+            break;
+        }
+        iterations *= 2;
+    }
+    bench->run(iterations);
+
+    double total = 0.0;
+    for (uint32_t r = 0; r < options->repeats; r++) {
+        double start = now_ns();
+        bench->run(iterations);
+        samples[r] = (now_ns() - start) / iterations;
+        total += samples[r];
+    }
+    qsort(samples, options->repeats, sizeof(double), compare_doubles);
+
+    result->iterations = iterations;
+    result->repeats = options->repeats;
+    result->mean = total / options->repeats;
+    result->min = samples[0];
+    result->p50 = percentile(samples, options->repeats, 50.0);
+    result->p90 = percentile(samples, options->repeats, 90.0);
+    result->p99 = percentile(samples, options->repeats, 99.0);
+    result->max = samples[options->repeats - 1];
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--json] [--repeats N] [--min-time-ms MS] "
+            "[--filter TEXT]\n",
+            program);
+}
+
+static int parse_options(int argc, char** argv, BenchOptions* options) {
+    *options = (BenchOptions){21, 5e6, 0, NULL};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            options->json = 1;
+        } else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            int repeats = atoi(argv[++i]);
+            if (repeats < 1 || repeats > MAX_REPEATS) {
+                return -1;
+            }
+            options->repeats = (uint32_t)repeats;
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            options->min_sample_ns = atof(argv[++i]) * 1e6;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options->filter = argv[++i];
+        } else {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (parse_options(argc, argv, &options) != 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    setup_corpus();
+
+    if (options.json) {
+        printf("{\n  \"board_size\": %d,\n  \"small_board_size\": %d,\n"
+               "  \"corpus_seed\": %d,\n  \"corpus_size\": %d,\n"
+               "  \"repeats\": %u,\n  \"benchmarks\": [",
+               GOENGC_MAX_BOARD_SIZE, SMALL_BOARD_SIZE, CORPUS_SEED,
+               CORPUS_SIZE, options.repeats);
+    } else {
+        printf("goengc benchmarks: %dx%d board, corpus of %d positions "
+               "(seed %d), %u repeats\n",
+               GOENGC_MAX_BOARD_SIZE, GOENGC_MAX_BOARD_SIZE, CORPUS_SIZE,
+               CORPUS_SEED, options.repeats);
+        printf("%-24s %12s %14s %12s %12s %12s\n", "benchmark", "ns/op",
+               "ops/s", "p90", "p99", "min");
+    }
+
+    int first = 1;
+    for (size_t b = 0; b < NUM_BENCHMARKS; b++) {
+        const Benchmark* bench = &benchmarks[b];
+        if (options.filter != NULL &&
+            strstr(bench->name, options.filter) == NULL) {
+            continue;
+        }
+        BenchResult result;
+        run_benchmark(bench, &options, &result);
+
+        if (options.json) {
+            printf("%s\n    {\"name\": \"%s\", \"unit\": \"%s\", "
+                   "\"iterations\": %u, \"ns_per_op\": %.3f, "
+                   "\"ops_per_sec\": %.1f, \"mean\": %.3f, \"min\": %.3f, "
+                   "\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, "
+                   "\"max\": %.3f}",
+                   first ? "" : ",", bench->name, bench->unit,
+                   result.iterations, result.p50, 1e9 / result.p50,
+                   result.mean, result.min, result.p50, result.p90,
+                   result.p99, result.max);
+        } else {
+            printf("%-24s %12.1f %14.0f %12.1f %12.1f %12.1f  per %s\n",
+                   bench->name, result.p50, 1e9 / result.p50, result.p90,
+                   result.p99, result.min, bench->unit);
+        }
+        fflush(stdout);
+        first = 0;
+    }
+
+    if (options.json) {
+        printf("\n  ]\n}\n");
+    }
+    return 0;
+}
@@ -30,6 +30,13 @@ void print_board(const GoengcColorField* field) {
 void print_board_region(const GoengcColorField* field, int x_start, int y_start, 
                         int width, int height) {
     printf("Board state (region):\n");
+    /* Clip the region to the data area */
+    if (x_start + width > GOENGC_DATA_SIZE) {
+        width = GOENGC_DATA_SIZE - x_start;
+    }
+    if (y_start + height > GOENGC_DATA_SIZE) {
+        height = GOENGC_DATA_SIZE - y_start;
+    }
     for (int y = y_start; y < y_start + height; y++) {
         for (int x = x_start; x < x_start + width; x++) {
             uint16_t index = goengc_coord_to_index(x, y);
@@ -85,8 +92,10 @@ void print_visited_region(const GoengcBitfield* visited, int x_start, int y_star
 int main(void) {
     /* Initialize a board */
     GoengcBoard board;
+    GoengcWorkspace workspace;
     printf("Size of board structure: %zu bytes\n", sizeof(GoengcBoard));
-    GoengcVec2 board_size = goengc_vec2_create(19, 19);
+    GoengcVec2 board_size =
+        goengc_vec2_create(GOENGC_MAX_BOARD_SIZE, GOENGC_MAX_BOARD_SIZE);
     goengc_board_init(&board, board_size, 15,
                       GOENGC_SCORING_TERRITORY); /* komi = 7.5 */
 
@@ -159,29 +168,29 @@ int main(void) {
     /* Choose a starting point for flood fill (empty location inside the enclosed area) */
     GoengcVec2 seed = goengc_vec2_create(cx - 2, cy - 1);
     
-    /* Run the flood fill using the board's scratch bitfields */
-    goengc_flood_fill(&board.color_field, seed, &board.scratch1, &board.scratch2);
+    /* Run the flood fill using the workspace scratch bitfields */
+    goengc_flood_fill(&board.color_field, seed, &workspace.scratch1, &workspace.scratch2);
     
     /* Print the visited points (full board) */
-    print_visited(&board.scratch2);
+    print_visited(&workspace.scratch2);
     
     /* Count the visited points */
-    uint16_t count = goengc_bitfield_count_bits(&board.scratch2);
+    uint16_t count = goengc_bitfield_count_bits(&workspace.scratch2);
     printf("Number of connected empty points: %d\n\n", count);
     
     /* Try another flood fill from outside the enclosed area */
     GoengcVec2 outside_seed = goengc_vec2_create(cx - 5, cy - 5);
     
     /* Reset and run the flood fill from outside */
-    goengc_bitfield_clear(&board.scratch1);
-    goengc_bitfield_clear(&board.scratch2);
-    goengc_flood_fill(&board.color_field, outside_seed, &board.scratch1, &board.scratch2);
+    goengc_bitfield_clear(&workspace.scratch1);
+    goengc_bitfield_clear(&workspace.scratch2);
+    goengc_flood_fill(&board.color_field, outside_seed, &workspace.scratch1, &workspace.scratch2);
     
     /* Print the visited points (full board) */
-    print_visited(&board.scratch2);
+    print_visited(&workspace.scratch2);
     
     /* Count the visited points */
-    count = goengc_bitfield_count_bits(&board.scratch2);
+    count = goengc_bitfield_count_bits(&workspace.scratch2);
     printf("Number of connected empty points from outside: %d\n", count);
 
     return 0;
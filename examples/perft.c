@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "goengc/board.h"
+#include "goengc/perft.h"
+#include "goengc/types.h"
+
+/* Node counts of the empty square boards with Black to move, from an
+ * independent implementation of the same rules */
+typedef struct {
+    uint8_t size;
+    uint8_t depth;
+    uint64_t nodes;
+} KnownCount;
+
+static const KnownCount known_counts[] = {
+    {2, 1, 5},      {2, 2, 21},      {2, 3, 68},      {2, 4, 156},
+    {2, 5, 316},    {2, 6, 604},     {2, 7, 1168},    {2, 8, 2592},
+    {2, 9, 5768},   {3, 1, 10},      {3, 2, 91},      {3, 3, 738},
+    {3, 4, 5281},   {3, 5, 33384},   {3, 6, 179712},  {4, 1, 17},
+    {4, 2, 273},    {4, 3, 4112},    {4, 4, 57984},   {4, 5, 764016},
+    {5, 1, 26},     {5, 2, 651},     {5, 3, 15650},   {5, 4, 361041},
+    {7, 1, 50},     {7, 2, 2451},    {7, 3, 117698},  {9, 1, 82},
+    {9, 2, 6643},   {9, 3, 531522},
+};
+
+#define NUM_KNOWN_COUNTS (sizeof(known_counts) / sizeof(known_counts[0]))
+
+/* Wall-clock time in nanoseconds */
+static double now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Enumerate the tree of an empty board and report its counts and speed */
+static uint64_t run_perft(uint8_t size, uint8_t depth, uint16_t num_threads,
+                          int divide) {
+    static uint64_t divide_nodes[GOENGC_DATA_SIZE_SQUARED];
+    GoengcBoard board;
+    GoengcPerftCounts counts;
+    goengc_board_init(&board, goengc_vec2_create(size, size), 15,
+                      GOENGC_SCORING_AREA);
+
+    double start = now_ns();
+    uint16_t used =
+        goengc_perft_parallel(&board, GOENGC_COLOR_BLACK, 0, depth, num_threads,
+                              &counts, divide ? divide_nodes : NULL);
+    double seconds = (now_ns() - start) / 1e9;
+    if (used == 0) {
+        fprintf(stderr, "could not allocate the work items\n");
+        exit(1);
+    }
+
+    if (divide) {
+        for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED; index++) {
+            if (divide_nodes[index] == 0) {
+                continue;
+            }
+            if (index == GOENGC_PERFT_PASS) {
+                printf("  pass     %llu\n",
+                       (unsigned long long)divide_nodes[index]);
+            } else {
+                GoengcVec2 coord = goengc_index_to_coord(index);
+                printf("  (%2d, %2d) %llu\n", coord.x - GOENGC_PAD,
+                       coord.y - GOENGC_PAD,
+                       (unsigned long long)divide_nodes[index]);
+            }
+        }
+    }
+    printf("%2ux%-2u depth %2u  %12llu nodes  passes %10llu  kos %8llu  "
+           "suicides %10llu  %7.3f s  %10.0f nodes/s  %u thread(s)\n",
+           size, size, depth, (unsigned long long)counts.nodes,
+           (unsigned long long)counts.passes, (unsigned long long)counts.kos,
+           (unsigned long long)counts.suicides, seconds,
+           counts.nodes / (seconds > 0 ? seconds : 1e-9), used);
+    return counts.nodes;
+}
+
+int main(int argc, char** argv) {
+    /* perft SIZE DEPTH [THREADS] [--divide]: count one tree */
+    if (argc >= 3) {
+        int size = atoi(argv[1]);
+        int depth = atoi(argv[2]);
+        int num_threads = argc >= 4 && argv[3][0] != '-' ? atoi(argv[3]) : 1;
+        int divide = strcmp(argv[argc - 1], "--divide") == 0;
+        if (size < 1 || size > GOENGC_MAX_BOARD_SIZE || depth < 0 ||
+            depth > 255 || num_threads < 1) {
+            fprintf(stderr, "usage: %s [SIZE DEPTH [THREADS] [--divide]]\n",
+                    argv[0]);
+            return 1;
+        }
+        run_perft((uint8_t)size, (uint8_t)depth, (uint16_t)num_threads,
+                  divide);
+        return 0;
+    }
+
+    /* perft [THREADS]: check the known counts */
+    uint16_t num_threads = argc == 2 ? (uint16_t)atoi(argv[1]) : 1;
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    int failed = 0;
+    for (size_t i = 0; i < NUM_KNOWN_COUNTS; i++) {
+        const KnownCount* known = &known_counts[i];
+        if (known->size > GOENGC_MAX_BOARD_SIZE) {
+            continue;
+        }
+        uint64_t nodes =
+            run_perft(known->size, known->depth, num_threads, 0);
+        if (nodes != known->nodes) {
+            printf("MISMATCH: expected %llu nodes\n",
+                   (unsigned long long)known->nodes);
+            failed = 1;
+        }
+    }
+    printf(failed ? "perft FAILED\n" : "perft passed\n");
+    return failed;
+}
@@ -0,0 +1,44 @@
+#ifndef GOENGC_BATCH_H
+#define GOENGC_BATCH_H
+
+#include <stdint.h>
+
+#include "board.h"
+#include "size.h"
+#include "types.h"
+
+/* Number of playouts claimed by a worker at a time */
+#define GOENGC_BATCH_CHUNK 64
+
+/* Aggregated result of a batch of playouts */
+typedef struct {
+    uint32_t num_playouts; /* Playouts run */
+    uint32_t black_wins;   /* Playouts with a positive score */
+    uint32_t white_wins;   /* Playouts with a negative score */
+    double mean_score2;    /* Mean final score (Black minus White) * 2 */
+    /* Mean ownership per position: +1 if always Black's area, -1 if always
+     * White's area. Off-board positions are 0. */
+    float ownership[GOENGC_DATA_SIZE_SQUARED];
+} GoengcBatchResult;
+
+/**
+ * Run many random playouts from a position across several threads.
+ * Each worker owns a cache-line aligned arena (board copy, random generator
+ * and counters), so workers never share mutable data except the atomic chunk
+ * counters. Work is split into chunks of GOENGC_BATCH_CHUNK playouts; a worker
+ * that finishes its own chunks steals the remaining chunks of the others. The
+ * random generator is reseeded per chunk, so the result does not depend on
+ * the thread count or on scheduling.
+ * @param root The position to start every playout from (not modified)
+ * @param to_move The color to move first (black or white)
+ * @param num_playouts The number of playouts to run
+ * @param num_threads The number of worker threads (at least 1)
+ * @param seed Seed for the random generators
+ * @param result The aggregated result (output)
+ * @return 0 on success, -1 if workers could not be allocated or started
+ */
+int goengc_batch_run(const GoengcBoard* restrict root, GoengcColor to_move,
+                     uint32_t num_playouts, uint16_t num_threads, uint64_t seed,
+                     GoengcBatchResult* restrict result);
+
+#endif /* GOENGC_BATCH_H */
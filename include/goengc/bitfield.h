@@ -6,30 +6,70 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "instrument.h"
 #include "popcount.h"
 #include "size.h"
 
-#define GOENGC_BITFIELD_SIZE (GOENGC_DATA_SIZE_SQUARED + 7) / 8
+#define GOENGC_BITFIELD_WORD_BITS 64
+#define GOENGC_BITFIELD_WORDS \
+    ((GOENGC_DATA_SIZE_SQUARED + GOENGC_BITFIELD_WORD_BITS - 1) / \
+     GOENGC_BITFIELD_WORD_BITS)
+
+/* Mask of the bits in the last word that map to valid indices */
+#define GOENGC_BITFIELD_LAST_WORD_MASK                                    \
+    ((GOENGC_DATA_SIZE_SQUARED % GOENGC_BITFIELD_WORD_BITS) == 0          \
+         ? ~(uint64_t)0                                                   \
+         : (((uint64_t)1 << (GOENGC_DATA_SIZE_SQUARED %                   \
+                             GOENGC_BITFIELD_WORD_BITS)) -                \
+            1))
+
+/* Row shifts are done within a single word-carry step */
+_Static_assert(GOENGC_DATA_SIZE < GOENGC_BITFIELD_WORD_BITS,
+               "GOENGC_DATA_SIZE must be smaller than the bitfield word size");
 
 /**
  * A bitfield with GOENGC_DATA_SIZE_SQUARED bits.
  * Used to represent various board states.
+ * Bit i lives in words[i / 64] at position i % 64, so bit indices follow the
+ * row-major board index and whole-board operations work one word at a time.
+ * All bits outside [active_start, active_end) are guaranteed to be 0.
  */
 typedef struct {
-    /* Using uint8_t (8 bits per byte) for storage */
-    uint8_t bytes[GOENGC_BITFIELD_SIZE];
+    /* Using uint64_t (64 bits per word) for storage */
+    uint64_t words[GOENGC_BITFIELD_WORDS];
     /* Tracking the active area (min and max indices of set bits) */
     uint16_t active_start; /* First bit that might be set (inclusive) */
     uint16_t active_end;   /* Past the last bit that might be set (exclusive) */
 } GoengcBitfield;
 
+/**
+ * Get the first word covered by the active area
+ * @param bitfield The bitfield to query
+ * @return The index of the first word that might contain set bits
+ */
+static inline uint16_t goengc_bitfield_word_begin(
+    const GoengcBitfield* restrict bitfield) {
+    return bitfield->active_start / GOENGC_BITFIELD_WORD_BITS;
+}
+
+/**
+ * Get the word past the last one covered by the active area
+ * @param bitfield The bitfield to query
+ * @return The index past the last word that might contain set bits
+ */
+static inline uint16_t goengc_bitfield_word_end(
+    const GoengcBitfield* restrict bitfield) {
+    return (bitfield->active_end + GOENGC_BITFIELD_WORD_BITS - 1) /
+           GOENGC_BITFIELD_WORD_BITS;
+}
+
 /**
  * Initialize a bitfield by setting all bits to 0
  * @param bitfield The bitfield to initialize
  */
 static inline void goengc_bitfield_clear(GoengcBitfield* restrict bitfield) {
     assert(bitfield != NULL);
-    memset(bitfield->bytes, 0, GOENGC_BITFIELD_SIZE);
+    memset(bitfield->words, 0, sizeof(bitfield->words));
     bitfield->active_start = GOENGC_DATA_SIZE_SQUARED;
     bitfield->active_end = 0;
 }
@@ -40,11 +80,26 @@ static inline void goengc_bitfield_clear(GoengcBitfield* restrict bitfield) {
  */
 static inline void goengc_bitfield_fill(GoengcBitfield* restrict bitfield) {
     assert(bitfield != NULL);
-    memset(bitfield->bytes, 0xFF, GOENGC_BITFIELD_SIZE);
+    memset(bitfield->words, 0xFF, sizeof(bitfield->words));
+    /* Keep the unused tail of the last word clear so counts stay exact */
+    bitfield->words[GOENGC_BITFIELD_WORDS - 1] &=
+        GOENGC_BITFIELD_LAST_WORD_MASK;
     bitfield->active_start = 0;
     bitfield->active_end = GOENGC_DATA_SIZE_SQUARED;
 }
 
+/**
+ * Copy a bitfield
+ * @param dst The bitfield to write
+ * @param src The bitfield to copy
+ */
+static inline void goengc_bitfield_copy(GoengcBitfield* restrict dst,
+                                        const GoengcBitfield* restrict src) {
+    assert(dst != NULL);
+    assert(src != NULL);
+    memcpy(dst, src, sizeof(*dst));
+}
+
 /**
  * Set a specific bit in the bitfield
  * @param bitfield The bitfield to modify
@@ -54,9 +109,10 @@ static inline void goengc_bitfield_set_bit(GoengcBitfield* restrict bitfield,
                                            uint16_t index) {
     assert(bitfield != NULL);
     assert(index < GOENGC_DATA_SIZE_SQUARED);
-    uint16_t byte_index = index / 8;
-    uint8_t bit_pos = index % 8;
-    bitfield->bytes[byte_index] |= (1 << bit_pos);
+    GOENGC_COUNT(GOENGC_COUNTER_BITFIELD_SET_BIT, 1);
+    uint16_t word_index = index / GOENGC_BITFIELD_WORD_BITS;
+    uint8_t bit_pos = index % GOENGC_BITFIELD_WORD_BITS;
+    bitfield->words[word_index] |= (uint64_t)1 << bit_pos;
 
     /* Update active area */
     if (index < bitfield->active_start) {
@@ -76,9 +132,9 @@ static inline void goengc_bitfield_clear_bit(GoengcBitfield* restrict bitfield,
                                              uint16_t index) {
     assert(bitfield != NULL);
     assert(index < GOENGC_DATA_SIZE_SQUARED);
-    uint16_t byte_index = index / 8;
-    uint8_t bit_pos = index % 8;
-    bitfield->bytes[byte_index] &= ~(1 << bit_pos);
+    uint16_t word_index = index / GOENGC_BITFIELD_WORD_BITS;
+    uint8_t bit_pos = index % GOENGC_BITFIELD_WORD_BITS;
+    bitfield->words[word_index] &= ~((uint64_t)1 << bit_pos);
 
     /* Note: We don't update active_start/active_end for clear operations
      * since they're rarely used and we prefer a non-tight bound
@@ -94,15 +150,15 @@ static inline void goengc_bitfield_clear_bit(GoengcBitfield* restrict bitfield,
 static inline int goengc_bitfield_get_bit(
     const GoengcBitfield* restrict bitfield, uint16_t index) {
     assert(index < GOENGC_DATA_SIZE_SQUARED);
-    uint16_t byte_index = index / 8;
-    uint8_t bit_pos = index % 8;
-    return (bitfield->bytes[byte_index] & (1 << bit_pos)) ? 1 : 0;
+    uint16_t word_index = index / GOENGC_BITFIELD_WORD_BITS;
+    uint8_t bit_pos = index % GOENGC_BITFIELD_WORD_BITS;
+    return (int)((bitfield->words[word_index] >> bit_pos) & 1);
 }
 
 /**
  * Count the number of bits set in the bitfield
  * @param bitfield The bitfield to count
- * @return The number of bits set
+ * @return The number of set bits
  */
 static inline uint16_t goengc_bitfield_count_bits(
     const GoengcBitfield* restrict bitfield) {
@@ -110,16 +166,580 @@ static inline uint16_t goengc_bitfield_count_bits(
 
     uint16_t count = 0;
 
-    /* Calculate byte indices for active area */
-    uint16_t start_byte = bitfield->active_start / 8;
-    uint16_t end_byte = (bitfield->active_end + 7) / 8;
-
-    /* Count bits only in the active area */
-    for (uint16_t i = start_byte; i < end_byte; i++) {
-        count += goengc_popcount(bitfield->bytes[i]);
+    /* Count bits only in the words covering the active area */
+    uint16_t end_word = goengc_bitfield_word_end(bitfield);
+    for (uint16_t i = goengc_bitfield_word_begin(bitfield); i < end_word;
+         i++) {
+        count += goengc_popcount64(bitfield->words[i]);
     }
 
     return count;
 }
 
+/**
+ * Check whether no bit is set in the bitfield
+ * @param bitfield The bitfield to check
+ * @return 1 if no bit is set, 0 otherwise
+ */
+static inline int goengc_bitfield_is_empty(
+    const GoengcBitfield* restrict bitfield) {
+    assert(bitfield != NULL);
+
+    uint64_t any = 0;
+    uint16_t end_word = goengc_bitfield_word_end(bitfield);
+    for (uint16_t i = goengc_bitfield_word_begin(bitfield); i < end_word;
+         i++) {
+        any |= bitfield->words[i];
+    }
+
+    return any == 0;
+}
+
+/**
+ * Shrink the active area to the exact range of set bits
+ * @param bitfield The bitfield to update
+ * @return 1 if no bit is set, 0 otherwise
+ */
+static inline int goengc_bitfield_tighten(GoengcBitfield* restrict bitfield) {
+    assert(bitfield != NULL);
+
+    uint16_t begin_word = goengc_bitfield_word_begin(bitfield);
+    uint16_t end_word = goengc_bitfield_word_end(bitfield);
+
+    while (begin_word < end_word && bitfield->words[begin_word] == 0) {
+        begin_word++;
+    }
+    if (begin_word == end_word) {
+        bitfield->active_start = GOENGC_DATA_SIZE_SQUARED;
+        bitfield->active_end = 0;
+        return 1;
+    }
+    while (bitfield->words[end_word - 1] == 0) {
+        end_word--;
+    }
+
+    bitfield->active_start = begin_word * GOENGC_BITFIELD_WORD_BITS +
+                             goengc_ctz64(bitfield->words[begin_word]);
+    bitfield->active_end = end_word * GOENGC_BITFIELD_WORD_BITS -
+                           goengc_clz64(bitfield->words[end_word - 1]);
+    return 0;
+}
+
+/**
+ * Find the first set bit at or after a given index.
+ * Iterate all set bits with:
+ *   for (i = goengc_bitfield_find_next(bf, 0); i < GOENGC_DATA_SIZE_SQUARED;
+ *        i = goengc_bitfield_find_next(bf, i + 1))
+ * @param bitfield The bitfield to scan
+ * @param index The index to start scanning from (inclusive)
+ * @return The index of the set bit, or GOENGC_DATA_SIZE_SQUARED if none
+ */
+static inline uint16_t goengc_bitfield_find_next(
+    const GoengcBitfield* restrict bitfield, uint16_t index) {
+    assert(bitfield != NULL);
+
+    if (index < bitfield->active_start) {
+        index = bitfield->active_start;
+    }
+    if (index >= bitfield->active_end) {
+        return GOENGC_DATA_SIZE_SQUARED;
+    }
+
+    uint16_t word_index = index / GOENGC_BITFIELD_WORD_BITS;
+    uint16_t end_word = goengc_bitfield_word_end(bitfield);
+    if (end_word > GOENGC_BITFIELD_WORDS) {
+        end_word = GOENGC_BITFIELD_WORDS;
+    }
+
+    /* Mask off the bits below the start index in the first word */
+    uint64_t word = bitfield->words[word_index] &
+                    (~(uint64_t)0 << (index % GOENGC_BITFIELD_WORD_BITS));
+    while (word == 0) {
+        if (++word_index >= end_word) {
+            return GOENGC_DATA_SIZE_SQUARED;
+        }
+        word = bitfield->words[word_index];
+    }
+
+    return word_index * GOENGC_BITFIELD_WORD_BITS + goengc_ctz64(word);
+}
+
+/**
+ * Find the n-th set bit of the bitfield
+ * @param bitfield The bitfield to scan
+ * @param n The rank of the bit to find (0 for the first set bit), must be
+ * smaller than the number of set bits
+ * @return The index of the set bit
+ */
+static inline uint16_t goengc_bitfield_select(
+    const GoengcBitfield* restrict bitfield, uint16_t n) {
+    assert(bitfield != NULL);
+
+    uint16_t end_word = goengc_bitfield_word_end(bitfield);
+    for (uint16_t i = goengc_bitfield_word_begin(bitfield); i < end_word;
+         i++) {
+        uint8_t count = goengc_popcount64(bitfield->words[i]);
+        if (n < count) {
+            return i * GOENGC_BITFIELD_WORD_BITS +
+                   goengc_select64(bitfield->words[i], (uint8_t)n);
+        }
+        n -= count;
+    }
+
+    assert(0 && "n exceeds the number of set bits");
+    return GOENGC_DATA_SIZE_SQUARED;
+}
+
+/**
+ * Find the first set bit in the bitfield
+ * @param bitfield The bitfield to scan
+ * @return The index of the first set bit, or GOENGC_DATA_SIZE_SQUARED if none
+ */
+static inline uint16_t goengc_bitfield_find_first(
+    const GoengcBitfield* restrict bitfield) {
+    return goengc_bitfield_find_next(bitfield, 0);
+}
+
+/*
+ * Bulk bitboard algebra.
+ * The destination may alias either operand. Only the words covered by the
+ * active areas of the operands are computed, so sparse bitfields stay cheap;
+ * the remaining words of the destination are zeroed. The destination is
+ * never read, so it does not need to be initialized.
+ */
+
+/* Word range covering the active areas of a and b */
+static inline void goengc_bitfield_merge_span(const GoengcBitfield* a,
+                                              const GoengcBitfield* b,
+                                              uint16_t* begin, uint16_t* end) {
+    uint16_t lo = goengc_bitfield_word_begin(a);
+    uint16_t hi = goengc_bitfield_word_end(a);
+    uint16_t w = goengc_bitfield_word_begin(b);
+    lo = w < lo ? w : lo;
+    w = goengc_bitfield_word_end(b);
+    hi = w > hi ? w : hi;
+    if (hi > GOENGC_BITFIELD_WORDS) {
+        hi = GOENGC_BITFIELD_WORDS;
+    }
+    if (lo > hi) {
+        lo = hi;
+    }
+    *begin = lo;
+    *end = hi;
+}
+
+/* Zero the words of dst outside [begin, end) */
+static inline void goengc_bitfield_zero_outside(GoengcBitfield* dst,
+                                                uint16_t begin, uint16_t end) {
+    for (uint16_t i = 0; i < begin; i++) {
+        dst->words[i] = 0;
+    }
+    for (uint16_t i = end; i < GOENGC_BITFIELD_WORDS; i++) {
+        dst->words[i] = 0;
+    }
+}
+
+/**
+ * Compute the intersection of two bitfields (dst = a & b)
+ * @param dst The bitfield to write
+ * @param a The first operand
+ * @param b The second operand
+ */
+static inline void goengc_bitfield_and(GoengcBitfield* dst,
+                                       const GoengcBitfield* a,
+                                       const GoengcBitfield* b) {
+    assert(dst != NULL && a != NULL && b != NULL);
+
+    uint16_t start =
+        a->active_start > b->active_start ? a->active_start : b->active_start;
+    uint16_t end = a->active_end < b->active_end ? a->active_end : b->active_end;
+
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(a, b, &begin_word, &end_word);
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        dst->words[i] = a->words[i] & b->words[i];
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+
+    if (start < end) {
+        dst->active_start = start;
+        dst->active_end = end;
+    } else {
+        dst->active_start = GOENGC_DATA_SIZE_SQUARED;
+        dst->active_end = 0;
+    }
+}
+
+/**
+ * Compute the union of two bitfields (dst = a | b)
+ * @param dst The bitfield to write
+ * @param a The first operand
+ * @param b The second operand
+ */
+static inline void goengc_bitfield_or(GoengcBitfield* dst,
+                                      const GoengcBitfield* a,
+                                      const GoengcBitfield* b) {
+    assert(dst != NULL && a != NULL && b != NULL);
+
+    uint16_t start =
+        a->active_start < b->active_start ? a->active_start : b->active_start;
+    uint16_t end = a->active_end > b->active_end ? a->active_end : b->active_end;
+
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(a, b, &begin_word, &end_word);
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        dst->words[i] = a->words[i] | b->words[i];
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+
+    dst->active_start = start;
+    dst->active_end = end;
+}
+
+/**
+ * Compute the difference of two bitfields (dst = a & ~b)
+ * @param dst The bitfield to write
+ * @param a The first operand
+ * @param b The bits to remove from the first operand
+ */
+static inline void goengc_bitfield_andnot(GoengcBitfield* dst,
+                                          const GoengcBitfield* a,
+                                          const GoengcBitfield* b) {
+    assert(dst != NULL && a != NULL && b != NULL);
+
+    uint16_t start = a->active_start;
+    uint16_t end = a->active_end;
+
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(a, b, &begin_word, &end_word);
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        dst->words[i] = a->words[i] & ~b->words[i];
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+
+    dst->active_start = start;
+    dst->active_end = end;
+}
+
+/**
+ * Compute the symmetric difference of two bitfields (dst = a ^ b)
+ * @param dst The bitfield to write
+ * @param a The first operand
+ * @param b The second operand
+ */
+static inline void goengc_bitfield_xor(GoengcBitfield* dst,
+                                       const GoengcBitfield* a,
+                                       const GoengcBitfield* b) {
+    assert(dst != NULL && a != NULL && b != NULL);
+
+    uint16_t start =
+        a->active_start < b->active_start ? a->active_start : b->active_start;
+    uint16_t end = a->active_end > b->active_end ? a->active_end : b->active_end;
+
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(a, b, &begin_word, &end_word);
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        dst->words[i] = a->words[i] ^ b->words[i];
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+
+    dst->active_start = start;
+    dst->active_end = end;
+}
+
+/**
+ * Shift all bits towards higher indices (index i moves to i + amount).
+ * Bits shifted past the end of the data area are dropped.
+ * @param dst The bitfield to write (may alias src)
+ * @param src The bitfield to shift
+ * @param amount The shift distance (1 to 63)
+ */
+static inline void goengc_bitfield_shift_up(GoengcBitfield* dst,
+                                            const GoengcBitfield* src,
+                                            uint8_t amount) {
+    assert(dst != NULL && src != NULL);
+    assert(amount > 0 && amount < GOENGC_BITFIELD_WORD_BITS);
+
+    if (src->active_start >= src->active_end) {
+        goengc_bitfield_clear(dst);
+        return;
+    }
+
+    uint16_t start = src->active_start + amount;
+    uint16_t end = src->active_end + amount;
+
+    /* A shift carries into at most one neighboring word */
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(src, src, &begin_word, &end_word);
+    if (end_word < GOENGC_BITFIELD_WORDS) {
+        end_word++;
+    }
+
+    /* Walk downwards so that dst may alias src */
+    for (uint16_t i = end_word; i-- > begin_word;) {
+        uint64_t carry =
+            i > 0 ? src->words[i - 1] >> (GOENGC_BITFIELD_WORD_BITS - amount)
+                  : 0;
+        dst->words[i] = (src->words[i] << amount) | carry;
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+    dst->words[GOENGC_BITFIELD_WORDS - 1] &= GOENGC_BITFIELD_LAST_WORD_MASK;
+
+    if (end > GOENGC_DATA_SIZE_SQUARED) {
+        end = GOENGC_DATA_SIZE_SQUARED;
+    }
+    if (start < end) {
+        dst->active_start = start;
+        dst->active_end = end;
+    } else {
+        dst->active_start = GOENGC_DATA_SIZE_SQUARED;
+        dst->active_end = 0;
+    }
+}
+
+/**
+ * Shift all bits towards lower indices (index i moves to i - amount).
+ * Bits shifted before index 0 are dropped.
+ * @param dst The bitfield to write (may alias src)
+ * @param src The bitfield to shift
+ * @param amount The shift distance (1 to 63)
+ */
+static inline void goengc_bitfield_shift_down(GoengcBitfield* dst,
+                                              const GoengcBitfield* src,
+                                              uint8_t amount) {
+    assert(dst != NULL && src != NULL);
+    assert(amount > 0 && amount < GOENGC_BITFIELD_WORD_BITS);
+
+    if (src->active_end <= amount || src->active_start >= src->active_end) {
+        goengc_bitfield_clear(dst);
+        return;
+    }
+
+    uint16_t start =
+        src->active_start > amount ? src->active_start - amount : 0;
+    uint16_t end = src->active_end - amount;
+
+    /* A shift carries into at most one neighboring word */
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(src, src, &begin_word, &end_word);
+    if (begin_word > 0) {
+        begin_word--;
+    }
+
+    /* Walk upwards so that dst may alias src */
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        uint64_t carry =
+            i + 1 < GOENGC_BITFIELD_WORDS
+                ? src->words[i + 1] << (GOENGC_BITFIELD_WORD_BITS - amount)
+                : 0;
+        dst->words[i] = (src->words[i] >> amount) | carry;
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+
+    dst->active_start = start;
+    dst->active_end = end;
+}
+
+/*
+ * Directional shifts in board space. A bit at a point moves to the
+ * neighboring point in the given direction. Shifts across a row boundary
+ * land in the padding columns (GOENGC_PAD >= 1), which never belong to an
+ * on-board mask, so masking the result with any on-board bitfield (e.g. the
+ * empty or stone planes of a color field) yields exact board-space shifts.
+ */
+
+/* North: one row up (index - GOENGC_DATA_SIZE) */
+static inline void goengc_bitfield_shift_north(GoengcBitfield* dst,
+                                               const GoengcBitfield* src) {
+    goengc_bitfield_shift_down(dst, src, GOENGC_DATA_SIZE);
+}
+
+/* South: one row down (index + GOENGC_DATA_SIZE) */
+static inline void goengc_bitfield_shift_south(GoengcBitfield* dst,
+                                               const GoengcBitfield* src) {
+    goengc_bitfield_shift_up(dst, src, GOENGC_DATA_SIZE);
+}
+
+/* West: one column left (index - 1) */
+static inline void goengc_bitfield_shift_west(GoengcBitfield* dst,
+                                              const GoengcBitfield* src) {
+    goengc_bitfield_shift_down(dst, src, 1);
+}
+
+/* East: one column right (index + 1) */
+static inline void goengc_bitfield_shift_east(GoengcBitfield* dst,
+                                              const GoengcBitfield* src) {
+    goengc_bitfield_shift_up(dst, src, 1);
+}
+
+/* Shared implementation of goengc_bitfield_dilate and
+ * goengc_bitfield_neighbors */
+static inline void goengc_bitfield_grow(GoengcBitfield* restrict dst,
+                                        const GoengcBitfield* restrict src,
+                                        int include_self) {
+    assert(dst != NULL && src != NULL);
+
+    if (src->active_start >= src->active_end) {
+        goengc_bitfield_clear(dst);
+        return;
+    }
+
+    uint16_t start = src->active_start > GOENGC_DATA_SIZE
+                         ? src->active_start - GOENGC_DATA_SIZE
+                         : 0;
+    uint16_t end = src->active_end + GOENGC_DATA_SIZE;
+    if (end > GOENGC_DATA_SIZE_SQUARED) {
+        end = GOENGC_DATA_SIZE_SQUARED;
+    }
+
+    /* A row shift carries into at most one neighboring word on each side */
+    uint16_t begin_word, end_word;
+    goengc_bitfield_merge_span(src, src, &begin_word, &end_word);
+    if (begin_word > 0) {
+        begin_word--;
+    }
+    if (end_word < GOENGC_BITFIELD_WORDS) {
+        end_word++;
+    }
+
+    uint64_t self_mask = include_self ? ~(uint64_t)0 : 0;
+    for (uint16_t i = begin_word; i < end_word; i++) {
+        uint64_t word = src->words[i];
+        uint64_t prev = i > 0 ? src->words[i - 1] : 0;
+        uint64_t next = i + 1 < GOENGC_BITFIELD_WORDS ? src->words[i + 1] : 0;
+        dst->words[i] =
+            (word & self_mask) | (word << 1) |
+            (prev >> (GOENGC_BITFIELD_WORD_BITS - 1)) | (word >> 1) |
+            (next << (GOENGC_BITFIELD_WORD_BITS - 1)) |
+            (word << GOENGC_DATA_SIZE) |
+            (prev >> (GOENGC_BITFIELD_WORD_BITS - GOENGC_DATA_SIZE)) |
+            (word >> GOENGC_DATA_SIZE) |
+            (next << (GOENGC_BITFIELD_WORD_BITS - GOENGC_DATA_SIZE));
+    }
+    goengc_bitfield_zero_outside(dst, begin_word, end_word);
+    dst->words[GOENGC_BITFIELD_WORDS - 1] &= GOENGC_BITFIELD_LAST_WORD_MASK;
+
+    dst->active_start = start;
+    dst->active_end = end;
+}
+
+/**
+ * Grow a bitfield by one step in all four directions
+ * (dst = src | north | south | west | east).
+ * As with the directional shifts, the result is exact once it is masked with
+ * an on-board bitfield.
+ * @param dst The bitfield to write (must not alias src)
+ * @param src The bitfield to dilate
+ */
+static inline void goengc_bitfield_dilate(GoengcBitfield* restrict dst,
+                                          const GoengcBitfield* restrict src) {
+    goengc_bitfield_grow(dst, src, 1);
+}
+
+/**
+ * Get all points adjacent to a set bit (dst = north | south | west | east).
+ * A point is only included if one of its own neighbors is set.
+ * @param dst The bitfield to write (must not alias src)
+ * @param src The bitfield whose neighbors are collected
+ */
+static inline void goengc_bitfield_neighbors(
+    GoengcBitfield* restrict dst, const GoengcBitfield* restrict src) {
+    goengc_bitfield_grow(dst, src, 0);
+}
+
+/*
+ * Cropped layout.
+ * Outside the padded data area, board planes are often stored without
+ * padding: bit y * GOENGC_MAX_BOARD_SIZE + x is point (x, y) counted from
+ * the top-left on-board point. Rows stay contiguous in both layouts, so
+ * converting is one bit-range copy per row.
+ */
+
+/* Words of a bitfield in the cropped layout */
+#define GOENGC_BITFIELD_CROPPED_WORDS                            \
+    ((GOENGC_MAX_BOARD_SIZE * GOENGC_MAX_BOARD_SIZE +            \
+      GOENGC_BITFIELD_WORD_BITS - 1) /                           \
+     GOENGC_BITFIELD_WORD_BITS)
+
+/**
+ * Read a range of fewer than 64 bits from a word array
+ * @param words The words to read
+ * @param offset The index of the first bit
+ * @param count The number of bits (below 64)
+ * @return The bits, starting at bit 0
+ */
+static inline uint64_t goengc_bits_get(const uint64_t* words, uint16_t offset,
+                                       uint8_t count) {
+    assert(count < GOENGC_BITFIELD_WORD_BITS);
+    uint16_t word = offset / GOENGC_BITFIELD_WORD_BITS;
+    uint8_t bit = offset % GOENGC_BITFIELD_WORD_BITS;
+    uint64_t value = words[word] >> bit;
+    if (bit + count > GOENGC_BITFIELD_WORD_BITS) {
+        value |= words[word + 1] << (GOENGC_BITFIELD_WORD_BITS - bit);
+    }
+    return value & (((uint64_t)1 << count) - 1);
+}
+
+/**
+ * Set a range of fewer than 64 bits in a word array (words |= value)
+ * @param words The words to modify
+ * @param offset The index of the first bit
+ * @param count The number of bits (below 64)
+ * @param value The bits to set, with no bit at or above count
+ */
+static inline void goengc_bits_put(uint64_t* words, uint16_t offset,
+                                   uint8_t count, uint64_t value) {
+    assert(count < GOENGC_BITFIELD_WORD_BITS);
+    uint16_t word = offset / GOENGC_BITFIELD_WORD_BITS;
+    uint8_t bit = offset % GOENGC_BITFIELD_WORD_BITS;
+    words[word] |= value << bit;
+    if (bit + count > GOENGC_BITFIELD_WORD_BITS) {
+        words[word + 1] |= value >> (GOENGC_BITFIELD_WORD_BITS - bit);
+    }
+}
+
+/**
+ * Copy the on-board area of a bitfield into the cropped layout
+ * @param bitfield The bitfield to read
+ * @param width The board width
+ * @param height The board height
+ * @param cropped GOENGC_BITFIELD_CROPPED_WORDS words (output); points past
+ *                the board size are 0
+ */
+static inline void goengc_bitfield_crop(const GoengcBitfield* restrict bitfield,
+                                        uint8_t width, uint8_t height,
+                                        uint64_t* restrict cropped) {
+    assert(width <= GOENGC_MAX_BOARD_SIZE && height <= GOENGC_MAX_BOARD_SIZE);
+    memset(cropped, 0, GOENGC_BITFIELD_CROPPED_WORDS * sizeof(uint64_t));
+    for (uint8_t y = 0; y < height; y++) {
+        uint16_t from = (y + GOENGC_PAD) * GOENGC_DATA_SIZE + GOENGC_PAD;
+        goengc_bits_put(cropped, (uint16_t)(y * GOENGC_MAX_BOARD_SIZE), width,
+                        goengc_bits_get(bitfield->words, from, width));
+    }
+}
+
+/**
+ * Copy a bitfield in the cropped layout back into the padded layout
+ * @param cropped GOENGC_BITFIELD_CROPPED_WORDS words to read
+ * @param width The board width
+ * @param height The board height
+ * @param bitfield The bitfield to write (output); padding is 0
+ */
+static inline void goengc_bitfield_uncrop(const uint64_t* restrict cropped,
+                                          uint8_t width, uint8_t height,
+                                          GoengcBitfield* restrict bitfield) {
+    assert(width <= GOENGC_MAX_BOARD_SIZE && height <= GOENGC_MAX_BOARD_SIZE);
+    memset(bitfield->words, 0, sizeof(bitfield->words));
+    for (uint8_t y = 0; y < height; y++) {
+        uint16_t to = (y + GOENGC_PAD) * GOENGC_DATA_SIZE + GOENGC_PAD;
+        goengc_bits_put(
+            bitfield->words, to, width,
+            goengc_bits_get(cropped, (uint16_t)(y * GOENGC_MAX_BOARD_SIZE),
+                            width));
+    }
+    bitfield->active_start = 0;
+    bitfield->active_end = GOENGC_DATA_SIZE_SQUARED;
+    goengc_bitfield_tighten(bitfield);
+}
+
 #endif /* GOENGC_BITFIELD_H */
@@ -5,9 +5,18 @@
 
 #include "bitfield.h"
 #include "color_field.h"
+#include "history.h"
 #include "size.h"
+#include "symmetry.h"
 #include "types.h"
 
+/* Chain head of positions without a stone. Index 0 is always padding, so it
+ * never heads a chain. */
+#define GOENGC_NO_CHAIN 0
+
+/* Ko index when no point is forbidden by simple ko */
+#define GOENGC_NO_KO 0
+
 /* Scoring system enumeration */
 typedef enum {
     GOENGC_SCORING_TERRITORY = 0,
@@ -23,13 +32,74 @@ typedef struct {
 
     /* Board state */
     GoengcColorField color_field; /* Colors at each position */
-    int8_t
+    int16_t
         num_captures; /* Number of captures by Black minus captures by White */
+    uint16_t ko_index;  /* Point retaking a ko, GOENGC_NO_KO if none */
+    GoengcColor ko_color; /* Color that may not play at ko_index */
+    uint64_t hash; /* Zobrist hash of the stones on the board */
+    /* Hash of the position transformed by each symmetry, maintained with the
+     * hash; entry GOENGC_SYMMETRY_IDENTITY equals hash. Entries past
+     * goengc_symmetry_count are hashes of the transposed board size. */
+    uint64_t symmetry_hashes[GOENGC_NUM_SYMMETRIES];
+
+    /* Chain tracking, maintained incrementally by play and setup moves.
+     * Chains are identified by the index of a representative stone (the
+     * head). The per-position arrays are only valid at stone positions, the
+     * per-chain arrays only at head positions. */
+    GoengcIndex chain_head[GOENGC_DATA_SIZE_SQUARED]; /* Head of the chain,
+                                                         GOENGC_NO_CHAIN if
+                                                         no stone */
+    GoengcIndex chain_next[GOENGC_DATA_SIZE_SQUARED]; /* Next stone in the
+                                                         chain (circular) */
+    GoengcIndex chain_liberties[GOENGC_DATA_SIZE_SQUARED]; /* Liberty count */
+    GoengcIndex chain_size[GOENGC_DATA_SIZE_SQUARED];      /* Stone count */
+
+    /* 3x3 pattern code of each point: the color of neighbor k of
+     * GOENGC_NEIGHBOR_8 in bits 2k and 2k + 1 (see pattern.h). Maintained
+     * incrementally for the 8 neighbors of every point that changes color;
+     * neighbors outside the data area read as off board. */
+    uint16_t patterns[GOENGC_DATA_SIZE_SQUARED];
+} GoengcBoard;
 
-    /* Utility bitfields for flood fill and counting operations */
+/* Scratch space for operations that need temporary bitfields (flood fills,
+ * playouts). Kept out of GoengcBoard so that copying a position only copies
+ * its state; use one workspace per thread. */
+typedef struct {
     GoengcBitfield scratch1;
     GoengcBitfield scratch2;
-} GoengcBoard;
+} GoengcWorkspace;
+
+/* Record of a move played with goengc_board_play_undoable: the chain
+ * changes the move made, so that undo can reverse them without rebuilding
+ * chains */
+typedef struct {
+    GoengcMove move; /* The move played */
+    /* Distinct chains next to the played point before the move, with their
+     * liberty counts */
+    uint16_t adjacent[4];
+    uint16_t adjacent_liberties[4];
+    uint8_t num_adjacent;
+    /* Chains the move merged, in merge order: absorbed[i] was spliced into
+     * the chain headed by merged_into[i] */
+    uint16_t merged_into[4];
+    uint16_t absorbed[4];
+    uint8_t num_merges;
+    /* Heads of the removed chains; their stone lists and sizes are left
+     * intact on the board */
+    uint16_t captured[4];
+    uint8_t num_captured;
+    /* Chain entries of the played point before the move. An empty point
+     * keeps the entries it had as a stone, which may still be needed to put
+     * a captured chain back when an earlier move is undone. */
+    uint16_t point_next;
+    uint16_t point_size;
+    uint16_t point_liberties;
+    uint64_t hash;        /* Hash before the move */
+    int16_t num_captures; /* Capture balance before the move */
+    uint16_t ko_index;    /* Ko point before the move */
+    GoengcColor ko_color; /* Ko color before the move */
+    int suicide;          /* 1 if the removed stones are the mover's own */
+} GoengcUndo;
 
 /**
  * Initialize a Go board with the given parameters
@@ -59,13 +129,57 @@ void goengc_board_reset(GoengcBoard* restrict board);
 void goengc_board_setup_move(GoengcBoard* restrict board, GoengcMove move);
 
 /**
- * Check if a move is legal
+ * Replace the stones on the board with those of a color field, e.g. one
+ * loaded from a dataset record.
+ * Recomputes the hash and rebuilds all chains. Clears ko; the capture count
+ * and the board configuration are kept.
+ *
+ * @param board The board to modify
+ * @param color_field The colors to copy; its on-board area must match the
+ *                    board size
+ */
+void goengc_board_set_colors(GoengcBoard* restrict board,
+                             const GoengcColorField* restrict color_field);
+
+/**
+ * Copy a board transformed by a symmetry
+ * Stones, chains, hashes and ko are transformed; komi, scoring and the
+ * capture count are copied.
+ * @param src The board to transform
+ * @param symmetry The symmetry to apply
+ * @param dst The transformed board (output; must not alias src)
+ */
+void goengc_board_transform(const GoengcBoard* restrict src,
+                            GoengcSymmetry symmetry,
+                            GoengcBoard* restrict dst);
+
+/**
+ * Get a hash shared by all symmetric images of the position: the smallest
+ * of the hashes under the symmetries of the board size
+ * @param board The board to query
+ * @return The canonical hash
+ */
+static inline uint64_t goengc_board_get_canonical_hash(
+    const GoengcBoard* restrict board) {
+    uint8_t count = goengc_symmetry_count(board->board_size);
+    uint64_t canonical = board->symmetry_hashes[GOENGC_SYMMETRY_IDENTITY];
+    for (uint8_t s = 1; s < count; s++) {
+        if (board->symmetry_hashes[s] < canonical) {
+            canonical = board->symmetry_hashes[s];
+        }
+    }
+    return canonical;
+}
+
+/**
+ * Check if a move is legal under simple ko.
+ * Only reads the chain counts around the point; the board is not modified.
  * @param board The board to check
  * @param move The move to check
  * @return The legality status of the move
  */
-GoengcMoveLegality goengc_board_get_move_legality(GoengcBoard* restrict board,
-                                                  GoengcMove move);
+GoengcMoveLegality goengc_board_get_move_legality(
+    const GoengcBoard* restrict board, GoengcMove move);
 
 /**
  * Convenience function to check if a move is legal
@@ -73,13 +187,198 @@ GoengcMoveLegality goengc_board_get_move_legality(GoengcBoard* restrict board,
  * @param move The move to check
  * @return 1 if legal, 0 if illegal
  */
-int goengc_board_is_legal(GoengcBoard* restrict board, GoengcMove move);
+int goengc_board_is_legal(const GoengcBoard* restrict board, GoengcMove move);
+
+/**
+ * Compute the Zobrist hash of the position after a move without playing it.
+ * Costs one key per stone captured by the move.
+ * @param board The board to query
+ * @param move A move that is legal under simple ko
+ * @return The position hash after the move
+ */
+uint64_t goengc_board_get_hash_after_move(const GoengcBoard* restrict board,
+                                          GoengcMove move);
+
+/**
+ * Add the current position to a superko history
+ * @param board The board to record
+ * @param history The history to add to
+ * @param to_move The color to move next (used for situational superko)
+ * @return 1 if the position is stored, 0 if the history is full
+ */
+int goengc_board_record_position(const GoengcBoard* restrict board,
+                                 GoengcHistory* restrict history,
+                                 GoengcColor to_move);
+
+/**
+ * Check if a move is legal under simple ko and the superko rule of a history.
+ * The board is not modified; the superko check is one hash lookup.
+ * @param board The board to check
+ * @param history The positions of the game so far
+ * @param move The move to check
+ * @return The legality status of the move
+ */
+GoengcMoveLegality goengc_board_get_superko_legality(
+    const GoengcBoard* restrict board, const GoengcHistory* restrict history,
+    GoengcMove move);
+
+/**
+ * Get all points where a color can legally play under simple ko, in one pass
+ * over the board's bitfields instead of one legality check per point.
+ * A point is legal if it is empty and is adjacent to an empty point, to a
+ * friendly chain with more than one liberty or to an opponent chain in atari,
+ * and it is not the ko point for the color.
+ * @param board The board to query
+ * @param color The color to move (black or white)
+ * @param legal Bitfield to store the legal points (output)
+ */
+void goengc_board_get_legal_moves(const GoengcBoard* restrict board,
+                                  GoengcColor color,
+                                  GoengcBitfield* restrict legal);
 
 /**
- * Play a move on the board
+ * Get all points where a color can legally play under simple ko and the
+ * superko rule of a history.
+ * Points passing the simple ko mask cost one hash lookup each.
+ * @param board The board to query
+ * @param history The positions of the game so far
+ * @param color The color to move (black or white)
+ * @param legal Bitfield to store the legal points (output)
+ */
+void goengc_board_get_superko_legal_moves(const GoengcBoard* restrict board,
+                                          const GoengcHistory* restrict history,
+                                          GoengcColor color,
+                                          GoengcBitfield* restrict legal);
+
+/**
+ * Check if an empty point is a real single-point eye of a color.
+ * All four neighbors must be stones of the color or off board, and the
+ * diagonals may hold at most one opponent stone (none on the edge).
+ * @param board The board to query
+ * @param index The index of the point
+ * @param color The color owning the eye (black or white)
+ * @return 1 if the point is an eye of the color, 0 otherwise
+ */
+int goengc_board_is_eye(const GoengcBoard* restrict board, uint16_t index,
+                        GoengcColor color);
+
+/**
+ * Play a move on the board.
+ * Removes captured opponent chains, updates num_captures and the ko point.
+ * The move should be legal; a suicidal move removes the player's own chain
+ * and counts it as captured by the opponent.
+ * @param board The board to modify
+ * @param move The move to play
+ * @return The number of stones captured by the move
+ */
+uint16_t goengc_board_play(GoengcBoard* restrict board, GoengcMove move);
+
+/**
+ * Play a move on the board like goengc_board_play and record what it changed
  * @param board The board to modify
  * @param move The move to play
+ * @param undo Record to take the move back with (output)
+ * @return The number of stones captured by the move
+ */
+uint16_t goengc_board_play_undoable(GoengcBoard* restrict board,
+                                    GoengcMove move,
+                                    GoengcUndo* restrict undo);
+
+/**
+ * Take back the last move played with goengc_board_play_undoable.
+ * The captured stones are put back on their intact stone lists, merged
+ * chains are split by reversing their list splices and adjacent chains get
+ * their recorded liberty counts back. The cost is that of the move: the
+ * captured stones and the stones of the smaller chains of merges, no
+ * chain is rebuilt or recounted.
+ * @param board The board to restore; must be in the position the move left
+ * @param undo The record of the move
+ */
+void goengc_board_undo(GoengcBoard* restrict board,
+                       const GoengcUndo* restrict undo);
+
+/**
+ * Get the chain a position belongs to
+ * @param board The board to query
+ * @param index The index of the position
+ * @return The index of the chain's head stone, or GOENGC_NO_CHAIN if there is
+ * no stone at the position
+ */
+static inline uint16_t goengc_board_get_chain(
+    const GoengcBoard* restrict board, uint16_t index) {
+    assert(board != NULL);
+    assert(index < GOENGC_DATA_SIZE_SQUARED);
+    return board->chain_head[index];
+}
+
+/**
+ * Get the 3x3 pattern code of a point
+ * @param board The board to query
+ * @param index The index of the point
+ * @return The colors of the point's 8 neighbors, 2 bits each
+ */
+static inline uint16_t goengc_board_get_pattern(
+    const GoengcBoard* restrict board, uint16_t index) {
+    assert(board != NULL);
+    assert(index < GOENGC_DATA_SIZE_SQUARED);
+    return board->patterns[index];
+}
+
+/**
+ * Get the number of liberties of the chain at a position
+ * @param board The board to query
+ * @param index The index of a stone
+ * @return The number of distinct empty points adjacent to the chain
+ */
+static inline uint16_t goengc_board_get_liberties(
+    const GoengcBoard* restrict board, uint16_t index) {
+    assert(board != NULL);
+    assert(board->chain_head[index] != GOENGC_NO_CHAIN);
+    return board->chain_liberties[board->chain_head[index]];
+}
+
+/**
+ * Get the number of stones of the chain at a position
+ * @param board The board to query
+ * @param index The index of a stone
+ * @return The number of stones in the chain
+ */
+static inline uint16_t goengc_board_get_chain_size(
+    const GoengcBoard* restrict board, uint16_t index) {
+    assert(board != NULL);
+    assert(board->chain_head[index] != GOENGC_NO_CHAIN);
+    return board->chain_size[board->chain_head[index]];
+}
+
+/**
+ * Check if the chain at a position is in atari
+ * @param board The board to query
+ * @param index The index of a stone
+ * @return 1 if the chain has exactly one liberty, 0 otherwise
+ */
+static inline int goengc_board_is_atari(const GoengcBoard* restrict board,
+                                        uint16_t index) {
+    return goengc_board_get_liberties(board, index) == 1;
+}
+
+/**
+ * Get the stones of the chain at a position
+ * @param board The board to query
+ * @param index The index of a stone
+ * @param stones Bitfield to store the chain's stones (output)
+ */
+void goengc_board_get_chain_stones(const GoengcBoard* restrict board,
+                                   uint16_t index,
+                                   GoengcBitfield* restrict stones);
+
+/**
+ * Get the liberties of the chain at a position
+ * @param board The board to query
+ * @param index The index of a stone
+ * @param liberties Bitfield to store the chain's liberties (output)
  */
-void goengc_board_play(GoengcBoard* restrict board, GoengcMove move);
+void goengc_board_get_chain_liberties(const GoengcBoard* restrict board,
+                                      uint16_t index,
+                                      GoengcBitfield* restrict liberties);
 
 #endif /* GOENGC_BOARD_H */
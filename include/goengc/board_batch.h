@@ -0,0 +1,174 @@
+#ifndef GOENGC_BOARD_BATCH_H
+#define GOENGC_BOARD_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "board.h"
+#include "color_field.h"
+#include "scoring.h"
+#include "types.h"
+
+/* Boards per group. Within a group, word w of every board's plane is stored
+ * contiguously, so one AVX-512 vector or two AVX2 vectors hold word w of all
+ * boards of the group. */
+#define GOENGC_BOARD_BATCH_LANES 8
+
+/* Words of one group of a plane */
+#define GOENGC_BOARD_BATCH_GROUP_WORDS \
+    (GOENGC_BITFIELD_WORDS * GOENGC_BOARD_BATCH_LANES)
+
+/* Kernel implementations */
+typedef enum {
+    GOENGC_BOARD_BATCH_AUTO = 0,   /* The widest one the processor supports */
+    GOENGC_BOARD_BATCH_SCALAR = 1, /* Portable C */
+    GOENGC_BOARD_BATCH_AVX2 = 2,
+    GOENGC_BOARD_BATCH_AVX512 = 3
+} GoengcBoardBatchKernel;
+
+/* Per-board scoring parameters */
+typedef struct {
+    int16_t num_captures; /* Black's captures minus White's */
+    int8_t komi2;
+    uint8_t scoring; /* GoengcScoring */
+} GoengcBoardBatchInfo;
+
+/**
+ * The color fields of many boards in struct-of-arrays layout.
+ * A plane is a word array of num_groups * GOENGC_BOARD_BATCH_GROUP_WORDS
+ * words; word w of board b is at goengc_board_batch_word_index(b, w).
+ * Lanes past num_boards are off-board everywhere and stay so.
+ * Boards may have different sizes; the kernels only use the planes.
+ */
+typedef struct {
+    uint32_t num_boards;
+    uint32_t num_groups;
+    uint64_t* occupied; /* Plane of occupied_bits */
+    uint64_t* color;    /* Plane of color_bits */
+    GoengcBoardBatchInfo* info;
+} GoengcBoardBatch;
+
+/**
+ * Get the position of a board's word in a plane
+ * @param board The board number
+ * @param word The word of the board's bitfield
+ * @return The index into the plane
+ */
+static inline size_t goengc_board_batch_word_index(uint32_t board,
+                                                   uint16_t word) {
+    return ((size_t)(board / GOENGC_BOARD_BATCH_LANES) *
+                GOENGC_BITFIELD_WORDS +
+            word) *
+               GOENGC_BOARD_BATCH_LANES +
+           board % GOENGC_BOARD_BATCH_LANES;
+}
+
+/**
+ * Get the number of words of a plane
+ * @param batch The batch
+ * @return The number of words
+ */
+static inline size_t goengc_board_batch_plane_words(
+    const GoengcBoardBatch* restrict batch) {
+    return (size_t)batch->num_groups * GOENGC_BOARD_BATCH_GROUP_WORDS;
+}
+
+/**
+ * Allocate a batch of empty slots (off board everywhere)
+ * @param batch The batch to initialize (output)
+ * @param num_boards The number of boards (at least 1)
+ * @return 0 on success, -1 if the memory could not be allocated
+ */
+int goengc_board_batch_init(GoengcBoardBatch* restrict batch,
+                            uint32_t num_boards);
+
+/**
+ * Free the memory of a batch
+ * @param batch The batch to free
+ */
+void goengc_board_batch_free(GoengcBoardBatch* restrict batch);
+
+/**
+ * Allocate a plane for the batch, aligned for vector loads
+ * @param batch The batch the plane belongs to
+ * @return The plane (release it with free), or NULL
+ */
+uint64_t* goengc_board_batch_alloc_plane(const GoengcBoardBatch* restrict batch);
+
+/**
+ * Copy a board's position and scoring parameters into a slot
+ * @param batch The batch to modify
+ * @param index The slot
+ * @param board The board to copy
+ */
+void goengc_board_batch_set(GoengcBoardBatch* restrict batch, uint32_t index,
+                            const GoengcBoard* restrict board);
+
+/**
+ * Extract one board's bitfield from a plane
+ * @param batch The batch the plane belongs to
+ * @param plane The plane
+ * @param index The slot
+ * @param bitfield The board's bitfield (output)
+ */
+void goengc_board_batch_get_bitfield(const GoengcBoardBatch* restrict batch,
+                                     const uint64_t* restrict plane,
+                                     uint32_t index,
+                                     GoengcBitfield* restrict bitfield);
+
+/**
+ * Choose the kernel implementation for all batches.
+ * Not safe while other threads run kernels.
+ * @param kernel The kernel to use; AUTO, or one the processor lacks, picks
+ *               the widest supported one
+ * @return The kernel in use
+ */
+GoengcBoardBatchKernel goengc_board_batch_select_kernel(
+    GoengcBoardBatchKernel kernel);
+
+/**
+ * Extract the points of a color on every board, as
+ * goengc_colorfield_get_mask does for one board
+ * @param batch The batch
+ * @param color The color to extract
+ * @param mask The plane to write (output)
+ */
+void goengc_board_batch_get_mask(const GoengcBoardBatch* restrict batch,
+                                 GoengcColor color, uint64_t* restrict mask);
+
+/**
+ * Grow regions to every point of a mask that is 4-connected to them, on
+ * every board at once, as goengc_flood_fill_region does for one board
+ * @param batch The batch
+ * @param mask The plane of the points the regions may grow into
+ * @param region The plane of the seeds, which must lie within mask
+ *               (input), and of the filled regions (output)
+ */
+void goengc_board_batch_flood_fill(const GoengcBoardBatch* restrict batch,
+                                   const uint64_t* restrict mask,
+                                   uint64_t* restrict region);
+
+/**
+ * Find the liberties of all chains of a color on every board
+ * @param batch The batch
+ * @param color The color of the chains (black or white)
+ * @param liberties The plane of the empty points next to the color's
+ *                  stones (output), or NULL
+ * @param counts The number of those points per board (output; num_boards
+ *               entries)
+ */
+void goengc_board_batch_count_liberties(const GoengcBoardBatch* restrict batch,
+                                        GoengcColor color,
+                                        uint64_t* restrict liberties,
+                                        uint16_t* restrict counts);
+
+/**
+ * Score every board as goengc_score does with all stones alive
+ * @param batch The batch
+ * @param scores The score of each board (output; num_boards entries)
+ */
+void goengc_board_batch_score(const GoengcBoardBatch* restrict batch,
+                              GoengcScore* restrict scores);
+
+#endif /* GOENGC_BOARD_BATCH_H */
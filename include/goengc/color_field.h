@@ -98,4 +98,131 @@ static inline void goengc_colorfield_set_color(GoengcColorField* restrict field,
     }
 }
 
+/**
+ * All color classes of a color field as separate bitfields
+ */
+typedef struct {
+    GoengcBitfield black;     /* occupied & ~color */
+    GoengcBitfield white;     /* occupied & color */
+    GoengcBitfield empty;     /* ~occupied & color */
+    GoengcBitfield off_board; /* ~occupied & ~color */
+} GoengcColorMasks;
+
+/**
+ * Get the bitfield of all positions with a given color.
+ * Each class is a single bitwise expression over the two planes, evaluated
+ * one word at a time.
+ * @param field The color field to query
+ * @param color The color to extract
+ * @param mask The bitfield to write (output)
+ */
+static inline void goengc_colorfield_get_mask(
+    const GoengcColorField* restrict field, GoengcColor color,
+    GoengcBitfield* restrict mask) {
+    assert(field != NULL);
+    assert(mask != NULL);
+
+    const uint64_t* occupied = field->occupied_bits.words;
+    const uint64_t* white = field->color_bits.words;
+
+    switch (color) {
+        case GOENGC_COLOR_BLACK:
+            for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+                mask->words[i] = occupied[i] & ~white[i];
+            }
+            mask->active_start = field->occupied_bits.active_start;
+            mask->active_end = field->occupied_bits.active_end;
+            break;
+        case GOENGC_COLOR_WHITE:
+            for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+                mask->words[i] = occupied[i] & white[i];
+            }
+            mask->active_start = field->occupied_bits.active_start;
+            mask->active_end = field->occupied_bits.active_end;
+            break;
+        case GOENGC_COLOR_EMPTY:
+            for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+                mask->words[i] = ~occupied[i] & white[i];
+            }
+            mask->active_start = field->color_bits.active_start;
+            mask->active_end = field->color_bits.active_end;
+            break;
+        case GOENGC_COLOR_OFF_BOARD:
+        default:
+            for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+                mask->words[i] = ~occupied[i] & ~white[i];
+            }
+            mask->words[GOENGC_BITFIELD_WORDS - 1] &=
+                GOENGC_BITFIELD_LAST_WORD_MASK;
+            mask->active_start = 0;
+            mask->active_end = GOENGC_DATA_SIZE_SQUARED;
+            break;
+    }
+}
+
+/**
+ * Get the bitfield of all positions that are empty or have a given color
+ * @param field The color field to query
+ * @param color The stone color to include (black or white)
+ * @param mask The bitfield to write (output)
+ */
+static inline void goengc_colorfield_get_empty_or_color_mask(
+    const GoengcColorField* restrict field, GoengcColor color,
+    GoengcBitfield* restrict mask) {
+    assert(field != NULL);
+    assert(mask != NULL);
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    const uint64_t* occupied = field->occupied_bits.words;
+    const uint64_t* white = field->color_bits.words;
+
+    if (color == GOENGC_COLOR_WHITE) {
+        /* White and empty both have the color bit set */
+        for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+            mask->words[i] = white[i];
+        }
+        mask->active_start = field->color_bits.active_start;
+        mask->active_end = field->color_bits.active_end;
+    } else {
+        /* Black and empty have exactly one of the two bits set */
+        for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+            mask->words[i] = occupied[i] ^ white[i];
+        }
+        mask->active_start = 0;
+        mask->active_end = GOENGC_DATA_SIZE_SQUARED;
+    }
+}
+
+/**
+ * Get the bitfields of all color classes in one pass over the two planes
+ * @param field The color field to query
+ * @param masks The color class bitfields to write (output)
+ */
+static inline void goengc_colorfield_get_masks(
+    const GoengcColorField* restrict field, GoengcColorMasks* restrict masks) {
+    assert(field != NULL);
+    assert(masks != NULL);
+
+    const uint64_t* occupied = field->occupied_bits.words;
+    const uint64_t* white = field->color_bits.words;
+
+    for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+        masks->black.words[i] = occupied[i] & ~white[i];
+        masks->white.words[i] = occupied[i] & white[i];
+        masks->empty.words[i] = ~occupied[i] & white[i];
+        masks->off_board.words[i] = ~occupied[i] & ~white[i];
+    }
+    masks->off_board.words[GOENGC_BITFIELD_WORDS - 1] &=
+        GOENGC_BITFIELD_LAST_WORD_MASK;
+
+    masks->black.active_start = field->occupied_bits.active_start;
+    masks->black.active_end = field->occupied_bits.active_end;
+    masks->white.active_start = field->occupied_bits.active_start;
+    masks->white.active_end = field->occupied_bits.active_end;
+    masks->empty.active_start = field->color_bits.active_start;
+    masks->empty.active_end = field->color_bits.active_end;
+    masks->off_board.active_start = 0;
+    masks->off_board.active_end = GOENGC_DATA_SIZE_SQUARED;
+}
+
 #endif /* GOENGC_COLORFIELD_H */
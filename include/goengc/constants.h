@@ -11,4 +11,16 @@
  */
 extern const int16_t GOENGC_NEIGHBOR_4[4];
 
+/**
+ * 1D index deltas for the diagonal neighbors
+ * Order is [North-West, South-West, South-East, North-East]
+ */
+extern const int16_t GOENGC_NEIGHBOR_DIAGONAL[4];
+
+/**
+ * 1D index deltas for the 8-connected neighbors: GOENGC_NEIGHBOR_4 followed
+ * by GOENGC_NEIGHBOR_DIAGONAL. Neighbor k ^ 2 is opposite to neighbor k.
+ */
+extern const int16_t GOENGC_NEIGHBOR_8[8];
+
 #endif /* GOENGC_CONSTANTS_H */
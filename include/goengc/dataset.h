@@ -0,0 +1,184 @@
+#ifndef GOENGC_DATASET_H
+#define GOENGC_DATASET_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bitfield.h"
+#include "board.h"
+#include "color_field.h"
+#include "size.h"
+#include "types.h"
+
+/* Points of the largest supported board; records store the planes for this
+ * area in the cropped layout (see bitfield.h) */
+#define GOENGC_DATASET_POINTS (GOENGC_MAX_BOARD_SIZE * GOENGC_MAX_BOARD_SIZE)
+#define GOENGC_DATASET_PLANE_WORDS GOENGC_BITFIELD_CROPPED_WORDS
+
+/* Packed point values of ko_point and next_move */
+#define GOENGC_DATASET_NO_POINT 0xFFFF /* No ko, or next move unknown */
+#define GOENGC_DATASET_PASS 0xFFFE     /* The next move is a pass */
+
+/* Identification of a dataset file */
+#define GOENGC_DATASET_MAGIC "GOENGCDS"
+#define GOENGC_DATASET_VERSION 1
+#define GOENGC_DATASET_HEADER_SIZE 64
+
+/**
+ * A training position of fixed size.
+ * The planes use the two-plane encoding of GoengcColorField, restricted to
+ * the on-board area of the largest board: bit y * GOENGC_MAX_BOARD_SIZE + x
+ * is point (x, y) without padding. Points past a smaller board's edge keep
+ * the off-board encoding (0 in both planes). Multi-byte fields are stored in
+ * the byte order of the writing machine.
+ */
+typedef struct {
+    uint64_t occupied[GOENGC_DATASET_PLANE_WORDS]; /* occupied_bits */
+    uint64_t color[GOENGC_DATASET_PLANE_WORDS];    /* color_bits */
+    uint8_t board_width;  /* Board size along x */
+    uint8_t board_height; /* Board size along y */
+    uint8_t to_move;      /* GoengcColor to move (black or white) */
+    int8_t komi2;         /* Compensation points for white * 2 */
+    uint8_t scoring;      /* GoengcScoring */
+    uint8_t reserved0;    /* Must be 0 */
+    uint16_t ko_point;    /* Point to_move may not play, or NO_POINT */
+    uint16_t next_move;   /* Packed move played next, PASS or NO_POINT */
+    int16_t result2;      /* Final score (Black minus White) * 2 */
+    uint32_t reserved1;   /* Must be 0 */
+} GoengcDatasetRecord;
+
+_Static_assert(sizeof(GoengcDatasetRecord) % sizeof(uint64_t) == 0,
+               "Dataset records must keep their planes 8-byte aligned");
+
+/* Writer appending records to a dataset file */
+typedef struct {
+    FILE* file;
+    uint64_t num_records;
+} GoengcDatasetWriter;
+
+/* Read-only memory mapping of a dataset file */
+typedef struct {
+    const GoengcDatasetRecord* records;
+    uint64_t num_records;
+    void* mapping;       /* Start of the mapped file */
+    size_t mapping_size; /* Length of the mapping in bytes */
+} GoengcDatasetReader;
+
+/**
+ * Pack a board index into a record point
+ * @param index The padded board index of an on-board point
+ * @return The point y * GOENGC_MAX_BOARD_SIZE + x without padding
+ */
+static inline uint16_t goengc_dataset_pack_index(uint16_t index) {
+    GoengcVec2 coord = goengc_index_to_coord(index);
+    return (uint16_t)((coord.y - GOENGC_PAD) * GOENGC_MAX_BOARD_SIZE +
+                      (coord.x - GOENGC_PAD));
+}
+
+/**
+ * Unpack a record point into a board index
+ * @param point A point other than GOENGC_DATASET_PASS and NO_POINT
+ * @return The padded board index of the point
+ */
+static inline uint16_t goengc_dataset_unpack_point(uint16_t point) {
+    assert(point < GOENGC_DATASET_POINTS);
+    return goengc_coord_to_index(
+        (uint8_t)(point % GOENGC_MAX_BOARD_SIZE + GOENGC_PAD),
+        (uint8_t)(point / GOENGC_MAX_BOARD_SIZE + GOENGC_PAD));
+}
+
+/**
+ * Fill a record from a board position
+ * A ko is stored only if it forbids a point to the side to move.
+ * @param board The position
+ * @param to_move The color to move (black or white)
+ * @param next_move The move played from the position; a pass, or a move
+ *                  with color GOENGC_COLOR_EMPTY if unknown
+ * @param result2 The final score of the game (Black minus White) * 2
+ * @param record The record to fill (output)
+ */
+void goengc_dataset_record_from_board(const GoengcBoard* restrict board,
+                                      GoengcColor to_move, GoengcMove next_move,
+                                      int16_t result2,
+                                      GoengcDatasetRecord* restrict record);
+
+/**
+ * Unpack the planes of a record into a color field
+ * Padding becomes off-board.
+ * @param record The record to read
+ * @param color_field The colors of the position (output)
+ */
+void goengc_dataset_record_get_colors(
+    const GoengcDatasetRecord* restrict record,
+    GoengcColorField* restrict color_field);
+
+/**
+ * Load a record into a board
+ * Sets size, komi, scoring, stones, hash, chains and ko; the capture count
+ * is 0, since records do not store it.
+ * @param record The record to read
+ * @param board The board to fill (output)
+ */
+void goengc_dataset_record_to_board(const GoengcDatasetRecord* restrict record,
+                                    GoengcBoard* restrict board);
+
+/**
+ * Create a dataset file, replacing any existing one
+ * @param writer The writer to open (output)
+ * @param path The file to create
+ * @return 0 on success, -1 if the file could not be created
+ */
+int goengc_dataset_writer_open(GoengcDatasetWriter* restrict writer,
+                               const char* path);
+
+/**
+ * Append a record
+ * @param writer An open writer
+ * @param record The record to append
+ * @return 0 on success, -1 on a write error
+ */
+int goengc_dataset_writer_add(GoengcDatasetWriter* restrict writer,
+                              const GoengcDatasetRecord* restrict record);
+
+/**
+ * Write the record count into the header and close the file
+ * @param writer An open writer; closed even if writing fails
+ * @return 0 on success, -1 on a write error
+ */
+int goengc_dataset_writer_close(GoengcDatasetWriter* restrict writer);
+
+/**
+ * Map a dataset file into memory for random access
+ * The file must have been written with the same GOENGC_MAX_BOARD_SIZE and
+ * byte order. Pages are read on first access and the kernel is told not to
+ * read ahead, so sampling a file larger than memory stays cheap.
+ * @param reader The reader to open (output)
+ * @param path The file to map
+ * @return 0 on success, -1 if the file cannot be mapped or has a
+ *         mismatching header
+ */
+int goengc_dataset_reader_open(GoengcDatasetReader* restrict reader,
+                               const char* path);
+
+/**
+ * Unmap a dataset file
+ * Records obtained from the reader are invalid afterwards.
+ * @param reader An open reader
+ */
+void goengc_dataset_reader_close(GoengcDatasetReader* restrict reader);
+
+/**
+ * Get a record of a mapped file without copying it
+ * @param reader An open reader
+ * @param i The index of the record, below num_records
+ * @return The record inside the mapping
+ */
+static inline const GoengcDatasetRecord* goengc_dataset_reader_get(
+    const GoengcDatasetReader* restrict reader, uint64_t i) {
+    assert(i < reader->num_records);
+    return &reader->records[i];
+}
+
+#endif /* GOENGC_DATASET_H */
@@ -0,0 +1,78 @@
+#ifndef GOENGC_FEATURES_H
+#define GOENGC_FEATURES_H
+
+#include <stdint.h>
+
+#include "board.h"
+#include "size.h"
+#include "types.h"
+
+/* Height and width of every plane; boards smaller than the maximum size sit
+ * in the top-left corner and the rest of the plane is 0 */
+#define GOENGC_FEATURES_SIZE GOENGC_MAX_BOARD_SIZE
+#define GOENGC_FEATURES_PLANE_SIZE (GOENGC_FEATURES_SIZE * GOENGC_FEATURES_SIZE)
+
+/* Largest number of earlier positions per sample */
+#define GOENGC_FEATURES_MAX_HISTORY 7
+
+/* Smallest number of samples worth handing to an extra thread */
+#define GOENGC_FEATURES_MIN_THREAD_BATCH 32
+
+/* Feature planes, in output order. The history planes follow: for each
+ * earlier position, the stones of the side to move, then those of the
+ * opponent. */
+typedef enum {
+    GOENGC_FEATURE_OWN = 0,         /* Stones of the side to move */
+    GOENGC_FEATURE_OPPONENT = 1,    /* Stones of the opponent */
+    GOENGC_FEATURE_EMPTY = 2,       /* Empty points */
+    GOENGC_FEATURE_LIBERTIES_1 = 3, /* Stones of chains with 1 liberty */
+    GOENGC_FEATURE_LIBERTIES_2 = 4, /* Stones of chains with 2 liberties */
+    GOENGC_FEATURE_LIBERTIES_3 = 5, /* Stones of chains with 3 or more */
+    GOENGC_FEATURE_KO = 6,          /* Point the side to move may not retake */
+    GOENGC_FEATURE_ON_BOARD = 7,    /* Points on the board */
+    GOENGC_FEATURE_HISTORY = 8      /* First history plane */
+} GoengcFeaturePlane;
+
+/* Element type of the output buffer */
+typedef enum {
+    GOENGC_FEATURES_UINT8 = 0,  /* uint8_t, 0 or 1 */
+    GOENGC_FEATURES_FLOAT32 = 1 /* float, 0.0f or 1.0f */
+} GoengcFeatureFormat;
+
+/**
+ * Get the number of planes per sample
+ * @param history The number of earlier positions per sample
+ * @return The number of planes
+ */
+static inline uint16_t goengc_features_num_planes(uint8_t history) {
+    return GOENGC_FEATURE_HISTORY + 2 * history;
+}
+
+/**
+ * Encode a batch of positions as stacked feature planes.
+ * The output is laid out NCHW: element
+ * ((sample * num_planes + plane) * GOENGC_FEATURES_SIZE + y) *
+ * GOENGC_FEATURES_SIZE + x, with num_planes from goengc_features_num_planes.
+ * Planes are built a row at a time from the color planes and chain data of
+ * the boards and expanded from bits to elements with SIMD where available.
+ * Batches of at least twice GOENGC_FEATURES_MIN_THREAD_BATCH are split over
+ * up to num_threads threads; the calling thread encodes a share itself, and
+ * if a thread cannot be started its share is encoded on the calling thread.
+ * @param boards (1 + history) boards per sample: the position, then the
+ *               positions before it, most recent first. Pass the oldest
+ *               position again where a game is shorter than the history.
+ * @param to_move The color to move per sample (black or white)
+ * @param batch_size The number of samples
+ * @param history The number of earlier positions per sample, at most
+ *                GOENGC_FEATURES_MAX_HISTORY
+ * @param format The element type of the output
+ * @param num_threads The largest number of threads to use (at least 1)
+ * @param output batch_size * num_planes * GOENGC_FEATURES_PLANE_SIZE
+ *               elements (output)
+ */
+void goengc_features_encode(const GoengcBoard* boards,
+                            const GoengcColor* to_move, uint32_t batch_size,
+                            uint8_t history, GoengcFeatureFormat format,
+                            uint16_t num_threads, void* output);
+
+#endif /* GOENGC_FEATURES_H */
@@ -9,7 +9,11 @@
 #include "types.h"
 
 /**
- * Perform a 4-connected flood fill from a seed position
+ * Perform a 4-connected flood fill from a seed position.
+ * The region is grown with goengc_flood_fill_region: sweeps over the words of
+ * the bitfield in alternating directions seed each word with the points
+ * reached from its neighbor words and dilate it to saturation within the
+ * word, until a sweep reaches no new point.
  * @param color_field The color field to operate on
  * @param seed The starting coordinate for the flood fill
  * @param same_color Scratch bitfield to track positions with the same color
@@ -19,4 +23,29 @@ void goengc_flood_fill(const GoengcColorField* restrict color_field,
                        GoengcVec2 seed, GoengcBitfield* restrict same_color,
                        GoengcBitfield* restrict visited);
 
+/**
+ * Grow a region to every point of a mask that is 4-connected to it.
+ * All seeds are grown at once, so any number of connected components of the
+ * mask are filled in a single pass at the cost of one flood fill.
+ * @param mask The points the region may grow into
+ * @param region The seed points, which must lie within mask (input), and the
+ * filled region (output)
+ */
+void goengc_flood_fill_region(const GoengcBitfield* restrict mask,
+                              GoengcBitfield* restrict region);
+
+/**
+ * Perform a 4-connected flood fill from a seed position by scanning the
+ * frontier range point by point.
+ * Produces the same result as goengc_flood_fill; kept as a reference
+ * implementation for verification and benchmarking.
+ * @param color_field The color field to operate on
+ * @param seed The starting coordinate for the flood fill
+ * @param same_color Scratch bitfield to track positions with the same color
+ * @param visited Bitfield to store visited positions (output)
+ */
+void goengc_flood_fill_scan(const GoengcColorField* restrict color_field,
+                            GoengcVec2 seed, GoengcBitfield* restrict same_color,
+                            GoengcBitfield* restrict visited);
+
 #endif /* GOENGC_FLOODFILL_H */
@@ -0,0 +1,81 @@
+#ifndef GOENGC_GAME_H
+#define GOENGC_GAME_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "history.h"
+#include "types.h"
+
+/* Longest game (in moves, passes included) a GoengcGame can record; its
+ * positions, the starting one included, fit in a GoengcHistory */
+#define GOENGC_GAME_MAX_MOVES (GOENGC_HISTORY_MAX_POSITIONS - 1)
+
+/**
+ * A board together with the bounded history of the moves played on it.
+ * Every move keeps its undo record, so moves can be taken back in order, and
+ * the positions of the game are kept in a hash set for superko checks.
+ */
+typedef struct {
+    GoengcBoard board;   /* Current position */
+    GoengcSuperko rule;  /* Superko rule for repetition checks */
+    GoengcColor to_move; /* Color to move in the current position */
+    uint16_t num_moves;  /* Number of moves in the history */
+    GoengcUndo moves[GOENGC_GAME_MAX_MOVES]; /* Moves played, oldest first */
+    GoengcHistory history; /* Hashes of the positions of the game */
+    /* 1 if the position after the move was not in history before it, so
+     * that undo removes each hash with the move that added it */
+    uint8_t new_position[GOENGC_GAME_MAX_MOVES];
+} GoengcGame;
+
+/**
+ * Initialize a game on an empty board with Black to move
+ * @param game The game to initialize
+ * @param board_size Size of the board
+ * @param komi2 Komi * 2
+ * @param scoring The scoring system
+ * @param rule The superko rule
+ */
+void goengc_game_init(GoengcGame* restrict game, GoengcVec2 board_size,
+                      int8_t komi2, GoengcScoring scoring, GoengcSuperko rule);
+
+/**
+ * Play a move and append it to the history
+ * @param game The game to modify
+ * @param move The move to play; should be legal
+ * @return 1 if the move is played, 0 if the history is full
+ */
+int goengc_game_play(GoengcGame* restrict game, GoengcMove move);
+
+/**
+ * Take back the last move of the history
+ * @param game The game to modify
+ * @return 1 if a move is taken back, 0 if the history is empty
+ */
+int goengc_game_undo(GoengcGame* restrict game);
+
+/**
+ * Check if a move is legal under simple ko and the game's superko rule.
+ * The position after the move costs one lookup in the game's history.
+ * @param game The game to check
+ * @param move The move to check
+ * @return The legality of the move
+ */
+GoengcMoveLegality goengc_game_get_superko_legality(
+    const GoengcGame* restrict game, GoengcMove move);
+
+/**
+ * Get a move of the history
+ * @param game The game to query
+ * @param ply The number of the move, 0 for the first move
+ * @return The move
+ */
+static inline GoengcMove goengc_game_get_move(const GoengcGame* restrict game,
+                                              uint16_t ply) {
+    assert(game != NULL);
+    assert(ply < game->num_moves);
+    return game->moves[ply].move;
+}
+
+#endif /* GOENGC_GAME_H */
@@ -0,0 +1,101 @@
+#ifndef GOENGC_HISTORY_H
+#define GOENGC_HISTORY_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "size.h"
+
+/* Longest game (in positions) the history is sized for */
+#define GOENGC_HISTORY_MAX_POSITIONS \
+    (3 * GOENGC_MAX_BOARD_SIZE * GOENGC_MAX_BOARD_SIZE)
+
+/* Table size as a power of two, keeping the load factor at most 1/2 */
+#if GOENGC_MAX_BOARD_SIZE <= 9
+#define GOENGC_HISTORY_BITS 10
+#elif GOENGC_MAX_BOARD_SIZE <= 13
+#define GOENGC_HISTORY_BITS 11
+#elif GOENGC_MAX_BOARD_SIZE <= 19
+#define GOENGC_HISTORY_BITS 12
+#else
+#define GOENGC_HISTORY_BITS 13
+#endif
+#define GOENGC_HISTORY_SLOTS (1 << GOENGC_HISTORY_BITS)
+
+_Static_assert(GOENGC_HISTORY_SLOTS >= 2 * GOENGC_HISTORY_MAX_POSITIONS,
+               "History table must have room for twice the positions");
+
+/* Superko rule enumeration */
+typedef enum {
+    GOENGC_SUPERKO_POSITIONAL = 0, /* Stones on the board only */
+    GOENGC_SUPERKO_SITUATIONAL = 1 /* Stones and side to move */
+} GoengcSuperko;
+
+/**
+ * A set of the hashes of all positions of a game, for superko checks.
+ * Open addressing with linear probing; the value 0 marks a free slot and is
+ * tracked by a separate flag.
+ */
+typedef struct {
+    uint64_t slots[GOENGC_HISTORY_SLOTS];
+    uint16_t count;        /* Number of stored hashes */
+    uint8_t contains_zero; /* 1 if the hash 0 has been added */
+    GoengcSuperko rule;    /* Which hashes are recorded */
+} GoengcHistory;
+
+/**
+ * Initialize an empty history
+ * @param history The history to initialize
+ * @param rule The superko rule the history is used for
+ */
+void goengc_history_init(GoengcHistory* restrict history, GoengcSuperko rule);
+
+/**
+ * Add a hash to the history
+ * @param history The history to modify
+ * @param hash The hash to add
+ * @return 1 if the hash is stored, 0 if the history is full
+ */
+int goengc_history_add(GoengcHistory* restrict history, uint64_t hash);
+
+/**
+ * Remove a hash from the history, moving later entries of its probe run
+ * back into the freed slot so that no lookup needs tombstones
+ * @param history The history to modify
+ * @param hash The hash to remove
+ * @return 1 if the hash was present, 0 otherwise
+ */
+int goengc_history_remove(GoengcHistory* restrict history, uint64_t hash);
+
+/* Slot a hash starts probing from */
+static inline uint16_t goengc_history_slot(uint64_t hash) {
+    /* Use the high bits, the low bits of XOR-combined keys are weaker */
+    return (uint16_t)(hash >> (64 - GOENGC_HISTORY_BITS));
+}
+
+/**
+ * Check if a hash has been added to the history
+ * @param history The history to query
+ * @param hash The hash to look up
+ * @return 1 if the hash is present, 0 otherwise
+ */
+static inline int goengc_history_contains(
+    const GoengcHistory* restrict history, uint64_t hash) {
+    assert(history != NULL);
+
+    if (hash == 0) {
+        return history->contains_zero;
+    }
+    for (uint16_t slot = goengc_history_slot(hash);;
+         slot = (slot + 1) & (GOENGC_HISTORY_SLOTS - 1)) {
+        if (history->slots[slot] == hash) {
+            return 1;
+        }
+        if (history->slots[slot] == 0) {
+            return 0;
+        }
+    }
+}
+
+#endif /* GOENGC_HISTORY_H */
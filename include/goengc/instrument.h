@@ -0,0 +1,118 @@
+#ifndef GOENGC_INSTRUMENT_H
+#define GOENGC_INSTRUMENT_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Hot-path counters. Set at build time (CMake option GOENGC_INSTRUMENT);
+ * when 0, GOENGC_COUNT compiles to nothing and snapshots are all zero. */
+#ifndef GOENGC_INSTRUMENT
+#define GOENGC_INSTRUMENT 0
+#endif
+
+/* Counted events */
+typedef enum {
+    GOENGC_COUNTER_FLOOD_FILL_CALLS = 0,    /* Flood fills run */
+    GOENGC_COUNTER_FLOOD_FILL_ITERATIONS,   /* Sweeps or frontier passes */
+    GOENGC_COUNTER_FLOOD_FILL_FRONTIER,     /* Frontier width, summed over
+                                               iterations (words for the
+                                               dilation fill, points for
+                                               the scan fill) */
+    GOENGC_COUNTER_FLOOD_FILL_BITS,         /* Points in the filled regions */
+    GOENGC_COUNTER_BITFIELD_SET_BIT,        /* goengc_bitfield_set_bit calls */
+    GOENGC_COUNTER_BOARD_PLAYS,             /* Moves played, passes included */
+    GOENGC_COUNTER_BOARD_CAPTURES,          /* Opponent stones captured */
+    GOENGC_COUNTER_BOARD_UNDOS,             /* Moves taken back */
+    GOENGC_COUNTER_LEGALITY_CHECKS,         /* Single-move legality checks */
+    GOENGC_COUNTER_LEGALITY_NON_EMPTY,      /* Rejected: point occupied */
+    GOENGC_COUNTER_LEGALITY_SUICIDAL,       /* Rejected: suicide */
+    GOENGC_COUNTER_LEGALITY_KO,             /* Rejected: ko */
+    GOENGC_NUM_COUNTERS
+} GoengcCounter;
+
+/* Counter totals at one point in time */
+typedef struct {
+    uint64_t counts[GOENGC_NUM_COUNTERS];
+} GoengcInstrumentSnapshot;
+
+#if GOENGC_INSTRUMENT
+
+/* Counters of one thread. Only the owning thread writes them, with a plain
+ * load and store; the atomics just make the reads of a snapshot
+ * well-defined, so counting takes no lock and no bus-locked instruction. */
+typedef struct GoengcInstrumentBlock {
+    _Atomic uint64_t counts[GOENGC_NUM_COUNTERS];
+    struct GoengcInstrumentBlock* next; /* Registry of live threads */
+    int registered;
+} GoengcInstrumentBlock;
+
+extern _Thread_local GoengcInstrumentBlock goengc_instrument_block;
+
+/**
+ * Add the calling thread's counters to the registry that snapshots read.
+ * Called on the thread's first count.
+ */
+void goengc_instrument_register(void);
+
+/**
+ * Add to a counter of the calling thread
+ * @param counter The counter to increase
+ * @param amount The amount to add
+ */
+static inline void goengc_instrument_add(GoengcCounter counter,
+                                         uint64_t amount) {
+    GoengcInstrumentBlock* block = &goengc_instrument_block;
+    if (!block->registered) {
+        goengc_instrument_register();
+    }
+    atomic_store_explicit(
+        &block->counts[counter],
+        atomic_load_explicit(&block->counts[counter], memory_order_relaxed) +
+            amount,
+        memory_order_relaxed);
+}
+
+#define GOENGC_COUNT(counter, amount) \
+    goengc_instrument_add((counter), (uint64_t)(amount))
+
+#else
+
+#define GOENGC_COUNT(counter, amount) ((void)0)
+
+#endif /* GOENGC_INSTRUMENT */
+
+/**
+ * Check if the library was built with instrumentation
+ * @return 1 if the counters are compiled in, 0 otherwise
+ */
+int goengc_instrument_enabled(void);
+
+/**
+ * Sum the counters of all threads, including threads that have exited
+ * @param snapshot The totals (output)
+ */
+void goengc_instrument_snapshot(GoengcInstrumentSnapshot* snapshot);
+
+/**
+ * Set all counters of all threads to zero.
+ * Counts made concurrently by other threads may be lost.
+ */
+void goengc_instrument_reset(void);
+
+/**
+ * Get the name of a counter
+ * @param counter The counter
+ * @return A short name such as "flood_fill.calls"
+ */
+const char* goengc_counter_name(GoengcCounter counter);
+
+/**
+ * Write a snapshot as text, one counter per line, with per-call averages
+ * @param snapshot The snapshot to write
+ * @param stream The stream to write to
+ */
+void goengc_instrument_print(const GoengcInstrumentSnapshot* snapshot,
+                             FILE* stream);
+
+#endif /* GOENGC_INSTRUMENT_H */
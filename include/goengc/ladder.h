@@ -0,0 +1,84 @@
+#ifndef GOENGC_LADDER_H
+#define GOENGC_LADDER_H
+
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "board.h"
+#include "types.h"
+
+/* Point of a result without a move or breaker. Index 0 is always padding. */
+#define GOENGC_LADDER_NO_POINT 0
+
+/* Node limit for callers without latency requirements of their own */
+#define GOENGC_LADDER_DEFAULT_MAX_NODES 1000
+
+/* Depth at which a line is given up as unknown; a ladder without captures
+ * cannot outlast the board's points */
+#define GOENGC_LADDER_MAX_DEPTH \
+    (GOENGC_MAX_BOARD_SIZE * GOENGC_MAX_BOARD_SIZE)
+
+/* Outcome of reading a ladder */
+typedef enum {
+    GOENGC_LADDER_NONE = 0,     /* No stone, or 3 or more liberties */
+    GOENGC_LADDER_CAPTURED = 1, /* The ladder captures the chain */
+    GOENGC_LADDER_ESCAPED = 2,  /* The chain gets out of the ladder */
+    GOENGC_LADDER_UNKNOWN = 3   /* Node or depth limit reached */
+} GoengcLadderStatus;
+
+/* Result of reading the ladder of one chain */
+typedef struct {
+    GoengcLadderStatus status;
+    /* First move of the deciding line: the attacker's capturing atari for a
+     * chain with 2 liberties, the defender's escape for a chain in atari;
+     * GOENGC_LADDER_NO_POINT otherwise */
+    uint16_t move;
+    /* For an escape, a stone that is already on the board and breaks the
+     * ladder: a defender stone the chain connects to, or an attacker stone
+     * the chain captures. GOENGC_LADDER_NO_POINT if there is none (the chain
+     * escapes into open space) or the chain does not escape. */
+    uint16_t breaker;
+    uint32_t nodes; /* Moves played while reading */
+} GoengcLadderResult;
+
+/* Ladder results of all chains with 1 or 2 liberties, as point sets */
+typedef struct {
+    GoengcBitfield captured; /* Stones of chains the ladder captures */
+    GoengcBitfield escaped;  /* Stones of chains that escape */
+    GoengcBitfield unknown;  /* Stones of chains whose reading hit a limit */
+    GoengcBitfield moves;    /* Capturing ataris and escape moves */
+    GoengcBitfield breakers; /* Stones breaking the ladders that fail */
+    uint32_t nodes;          /* Moves played while reading, summed */
+} GoengcLadderFeatures;
+
+/**
+ * Read the ladder of the chain at a point.
+ * A chain in atari is read with its owner to move: the ladder captures it
+ * if no extension or capture of an adjacent attacker chain gets it to 3
+ * liberties. A chain with 2 liberties is read with the opponent to move:
+ * the ladder captures it if an atari starts a ladder that captures it.
+ * The reading plays on point sets of the stones and the chain, a few hundred
+ * bytes per node, and does not modify or copy the board. Chains and
+ * liberties come from bitfield flood fills and neighbor masks. The board's
+ * rules apply: captures, no suicide and simple ko.
+ * @param board The board to read
+ * @param index The index of a stone of the chain
+ * @param max_nodes The number of moves the reading may play
+ * @param result The outcome (output)
+ */
+void goengc_ladder_read(const GoengcBoard* restrict board, uint16_t index,
+                        uint32_t max_nodes,
+                        GoengcLadderResult* restrict result);
+
+/**
+ * Read the ladders of all chains with 1 or 2 liberties, each with its own
+ * node limit
+ * @param board The board to read
+ * @param max_nodes The number of moves the reading of one chain may play
+ * @param features The ladder results as point sets (output)
+ */
+void goengc_ladder_read_all(const GoengcBoard* restrict board,
+                            uint32_t max_nodes,
+                            GoengcLadderFeatures* restrict features);
+
+#endif /* GOENGC_LADDER_H */
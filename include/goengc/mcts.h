@@ -0,0 +1,165 @@
+#ifndef GOENGC_MCTS_H
+#define GOENGC_MCTS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "random.h"
+#include "types.h"
+
+/* Fixed-point scale of node values: a win adds this much */
+#define GOENGC_MCTS_VALUE_ONE 65536
+
+/* Node index of the root */
+#define GOENGC_MCTS_ROOT 0
+
+/* Move value of a pass; index 0 is padding, so no move uses it */
+#define GOENGC_MCTS_PASS 0
+
+/* Largest number of threads of one search, the caller included */
+#define GOENGC_MCTS_MAX_THREADS 64
+
+/* Expansion state of a node */
+typedef enum {
+    GOENGC_MCTS_LEAF = 0,      /* Children not created yet */
+    GOENGC_MCTS_EXPANDING = 1, /* A thread is creating the children */
+    GOENGC_MCTS_EXPANDED = 2   /* Children are ready to read */
+} GoengcMctsState;
+
+/**
+ * A search tree node. The children of a node are consecutive in the arena,
+ * so a node only stores the index of the first one.
+ * Visits are counted when a thread descends through a node and the value
+ * only when it returns, so an in-flight visit counts as a loss until then
+ * (virtual loss): concurrent threads spread over different paths.
+ */
+typedef struct {
+    _Atomic uint64_t value;  /* Wins of the player who moved into the node,
+                                in units of 1 / GOENGC_MCTS_VALUE_ONE */
+    _Atomic uint32_t visits; /* Visits, in-flight ones included */
+    uint32_t first_child;    /* Arena index, valid once expanded */
+    uint16_t num_children;   /* Valid once expanded */
+    uint16_t move;           /* Board index of the move into the node, or
+                                GOENGC_MCTS_PASS */
+    _Atomic uint8_t state;   /* GoengcMctsState */
+} GoengcMctsNode;
+
+/**
+ * Leaf evaluator: estimate the probability that Black wins a position.
+ * Called concurrently from all search threads.
+ * @param board A private copy of the position; may be modified
+ * @param workspace Scratch space of the calling thread
+ * @param to_move The color to move
+ * @param rng The random generator of the calling thread
+ * @param user The pointer given to goengc_mcts_set_evaluator
+ * @return The probability that Black wins, between 0 and 1
+ */
+typedef float (*GoengcMctsEvaluator)(GoengcBoard* restrict board,
+                                     GoengcWorkspace* restrict workspace,
+                                     GoengcColor to_move,
+                                     GoengcRng* restrict rng, void* user);
+
+/* Search tree over a root position */
+typedef struct {
+    GoengcBoard root_board;
+    GoengcColor root_to_move;
+    uint8_t root_passes; /* Consecutive passes that led to the root */
+
+    GoengcMctsNode* nodes;       /* The arena */
+    uint32_t capacity;           /* Nodes in the arena */
+    _Atomic uint32_t num_nodes;  /* Nodes handed out, may exceed capacity */
+
+    GoengcMctsEvaluator evaluate;
+    void* user;
+    float exploration; /* UCT exploration constant */
+    uint64_t seed;     /* Seed of the thread random generators */
+} GoengcMcts;
+
+/* Summary of a tree */
+typedef struct {
+    uint32_t num_nodes;   /* Nodes in use */
+    uint32_t capacity;    /* Nodes in the arena */
+    size_t bytes_used;    /* Memory of the nodes in use */
+    size_t bytes_total;   /* Memory of the arena */
+    uint32_t root_visits; /* Visits of the root */
+    float root_value;     /* Win rate of the side to move at the root */
+} GoengcMctsStats;
+
+/**
+ * Create a search over a position, with an arena as large as a memory
+ * budget allows. Random playouts are the default evaluator.
+ * @param mcts The search to initialize (output)
+ * @param root The root position (copied)
+ * @param to_move The color to move at the root
+ * @param size_mb The memory budget of the arena in MiB (at least 1)
+ * @param seed Seed for the random generators
+ * @return 0 on success, -1 if the arena could not be allocated
+ */
+int goengc_mcts_init(GoengcMcts* restrict mcts, const GoengcBoard* root,
+                     GoengcColor to_move, size_t size_mb, uint64_t seed);
+
+/**
+ * Free the arena of a search
+ * @param mcts The search to free
+ */
+void goengc_mcts_free(GoengcMcts* restrict mcts);
+
+/**
+ * Replace the leaf evaluator
+ * @param mcts The search to modify
+ * @param evaluate The evaluator
+ * @param user Passed to every call of the evaluator
+ */
+void goengc_mcts_set_evaluator(GoengcMcts* restrict mcts,
+                               GoengcMctsEvaluator evaluate, void* user);
+
+/**
+ * Default evaluator: one uniformly random playout (see goengc_playout_run)
+ * @return 1 if Black wins the playout, 0 if White does, 0.5 on a tie
+ */
+float goengc_mcts_evaluate_playout(GoengcBoard* restrict board,
+                                   GoengcWorkspace* restrict workspace,
+                                   GoengcColor to_move, GoengcRng* restrict rng,
+                                   void* user);
+
+/**
+ * Grow the tree by a number of visits.
+ * Children are all legal moves that do not fill an own single-point eye,
+ * plus a pass; two passes in a row end the game and are scored by area.
+ * Superko is not checked. Once the arena is full, leaves are evaluated
+ * without being expanded.
+ * @param mcts The search to run
+ * @param num_visits The number of visits to add
+ * @param num_threads The number of threads, the caller included (at least 1)
+ * @return The number of threads that took part
+ */
+uint16_t goengc_mcts_search(GoengcMcts* restrict mcts, uint32_t num_visits,
+                            uint16_t num_threads);
+
+/**
+ * Get the most visited move at the root
+ * @param mcts The search to query
+ * @return The move, a pass if the root has no children
+ */
+GoengcMove goengc_mcts_get_best_move(const GoengcMcts* restrict mcts);
+
+/**
+ * Play a move at the root and start a new tree below it.
+ * The arena is reclaimed in O(1) by resetting its allocation index; the
+ * statistics of the previous tree are dropped.
+ * @param mcts The search to modify
+ * @param move A legal move of the side to move
+ */
+void goengc_mcts_advance(GoengcMcts* restrict mcts, GoengcMove move);
+
+/**
+ * Summarize the tree and its memory use
+ * @param mcts The search to query
+ * @param stats The summary (output)
+ */
+void goengc_mcts_get_stats(const GoengcMcts* restrict mcts,
+                           GoengcMctsStats* restrict stats);
+
+#endif /* GOENGC_MCTS_H */
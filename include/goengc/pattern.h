@@ -0,0 +1,157 @@
+#ifndef GOENGC_PATTERN_H
+#define GOENGC_PATTERN_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "board.h"
+#include "random.h"
+#include "symmetry.h"
+#include "types.h"
+
+/* Number of distinct 3x3 pattern codes. A code holds the GoengcColor of the
+ * 8 neighbors of a point, neighbor k of GOENGC_NEIGHBOR_8 in bits 2k and
+ * 2k + 1; the point itself is not part of it. The board keeps the code of
+ * every point (goengc_board_get_pattern). */
+#define GOENGC_PATTERN_COUNT 65536
+
+/* Consecutive weight rejections after which goengc_pattern_pick switches
+ * from rejection sampling to an exact pass over the candidates */
+#define GOENGC_PATTERN_MAX_REJECTIONS 16
+
+/**
+ * Move weights by pattern, for Black to move. White's moves are looked up
+ * with the colors of the pattern swapped, so one table serves both colors.
+ */
+typedef struct {
+    uint16_t weights[GOENGC_PATTERN_COUNT];
+    uint16_t max_weight; /* Upper bound of the weights */
+} GoengcPatternTable;
+
+/**
+ * Get the color of one neighbor from a pattern code
+ * @param pattern The pattern code
+ * @param neighbor The neighbor, as an index into GOENGC_NEIGHBOR_8
+ * @return The color of the neighbor
+ */
+static inline GoengcColor goengc_pattern_get_color(uint16_t pattern,
+                                                   int neighbor) {
+    assert(neighbor >= 0 && neighbor < 8);
+    return (GoengcColor)((pattern >> (2 * neighbor)) & 3);
+}
+
+/**
+ * Exchange black and white stones in a pattern code
+ * @param pattern The pattern code
+ * @return The code with the stone colors swapped
+ */
+static inline uint16_t goengc_pattern_swap_colors(uint16_t pattern) {
+    /* Stones have the high bit of their pair set; flip their low bit */
+    return (uint16_t)(pattern ^ ((pattern >> 1) & 0x5555));
+}
+
+/**
+ * Check if the point of a pattern is a real single-point eye of a color,
+ * as goengc_board_is_eye decides it
+ * @param pattern The pattern code of an empty point
+ * @param color The color owning the eye (black or white)
+ * @return 1 if the point is an eye of the color, 0 otherwise
+ */
+static inline int goengc_pattern_is_eye(uint16_t pattern, GoengcColor color) {
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    for (int n = 0; n < 4; n++) {
+        GoengcColor neighbor = goengc_pattern_get_color(pattern, n);
+        if (neighbor != color && neighbor != GOENGC_COLOR_OFF_BOARD) {
+            return 0;
+        }
+    }
+
+    GoengcColor opponent = goengc_color_opposite(color);
+    uint8_t num_opponent = 0;
+    uint8_t num_off_board = 0;
+    for (int n = 4; n < 8; n++) {
+        GoengcColor diagonal = goengc_pattern_get_color(pattern, n);
+        num_opponent += diagonal == opponent;
+        num_off_board += diagonal == GOENGC_COLOR_OFF_BOARD;
+    }
+    return num_off_board > 0 ? num_opponent == 0 : num_opponent < 2;
+}
+
+/**
+ * Transform a pattern code by a board symmetry
+ * @param pattern The pattern code
+ * @param symmetry The symmetry to apply
+ * @return The code of the transformed neighborhood
+ */
+uint16_t goengc_pattern_transform(uint16_t pattern, GoengcSymmetry symmetry);
+
+/**
+ * Give every pattern the same weight, except Black's own single-point eyes,
+ * which get weight 0 so that they are never filled
+ * @param table The table to initialize
+ * @param weight The weight of the other patterns
+ */
+void goengc_pattern_table_init(GoengcPatternTable* restrict table,
+                               uint16_t weight);
+
+/**
+ * Set the weight of one pattern
+ * @param table The table to modify
+ * @param pattern The pattern code, for Black to move
+ * @param weight The weight; 0 excludes the pattern from sampling
+ */
+void goengc_pattern_table_set(GoengcPatternTable* restrict table,
+                              uint16_t pattern, uint16_t weight);
+
+/**
+ * Set the weight of a pattern and of its images under all 8 symmetries
+ * @param table The table to modify
+ * @param pattern The pattern code, for Black to move
+ * @param weight The weight; 0 excludes the patterns from sampling
+ */
+void goengc_pattern_table_set_symmetric(GoengcPatternTable* restrict table,
+                                        uint16_t pattern, uint16_t weight);
+
+/**
+ * Get the weight of a move at a point of the board
+ * @param table The weights
+ * @param board The board to query
+ * @param index The index of the point
+ * @param color The color to move (black or white)
+ * @return The weight of the point's pattern for that color
+ */
+static inline uint16_t goengc_pattern_table_get(
+    const GoengcPatternTable* restrict table,
+    const GoengcBoard* restrict board, uint16_t index, GoengcColor color) {
+    assert(table != NULL);
+    uint16_t pattern = goengc_board_get_pattern(board, index);
+    if (color == GOENGC_COLOR_WHITE) {
+        pattern = goengc_pattern_swap_colors(pattern);
+    }
+    return table->weights[pattern];
+}
+
+/**
+ * Pick a legal move with probability proportional to its pattern weight.
+ * Empty points are drawn uniformly and accepted with probability
+ * weight / max_weight, the same draws as a uniform random pick when all
+ * weights are equal. Only accepted points are checked for legality. After
+ * GOENGC_PATTERN_MAX_REJECTIONS rejections in a row, the remaining
+ * candidates are weighed exactly in one pass.
+ * @param board The board to query
+ * @param table The weights
+ * @param color The color to move (black or white)
+ * @param candidates Scratch bitfield
+ * @param rng The random number generator to draw from
+ * @return The index of the point, or GOENGC_DATA_SIZE_SQUARED if no legal
+ *         point has a positive weight
+ */
+uint16_t goengc_pattern_pick(const GoengcBoard* restrict board,
+                             const GoengcPatternTable* restrict table,
+                             GoengcColor color,
+                             GoengcBitfield* restrict candidates,
+                             GoengcRng* restrict rng);
+
+#endif /* GOENGC_PATTERN_H */
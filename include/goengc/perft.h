@@ -0,0 +1,67 @@
+#ifndef GOENGC_PERFT_H
+#define GOENGC_PERFT_H
+
+#include <stdint.h>
+
+#include "board.h"
+#include "types.h"
+
+/* Index of the pass in a divide array; index 0 is padding, so no point
+ * uses it */
+#define GOENGC_PERFT_PASS 0
+
+/* Largest number of threads of one parallel run, the caller included */
+#define GOENGC_PERFT_MAX_THREADS 64
+
+/**
+ * Counts of a move tree enumeration.
+ * The tree holds every sequence of legal moves: each empty point that is
+ * legal under simple ko (suicide is illegal), plus a pass. Two passes in a
+ * row end the game, so such a position has no moves.
+ * The breakdown covers the last ply only.
+ */
+typedef struct {
+    uint64_t nodes;    /* Move sequences of exactly the requested depth */
+    uint64_t passes;   /* Sequences that end with a pass */
+    uint64_t kos;      /* Points rejected by the ko rule on the last ply */
+    uint64_t suicides; /* Points rejected as suicide on the last ply */
+} GoengcPerftCounts;
+
+/**
+ * Enumerate the move tree below a position on one thread.
+ * Moves are checked with goengc_board_get_move_legality and made with
+ * goengc_board_play_undoable and goengc_board_undo. The last ply is counted
+ * without being played.
+ * @param board The position; restored before returning
+ * @param to_move The color to move
+ * @param passes Consecutive passes that led to the position (0 to 2)
+ * @param depth The number of plies to enumerate
+ * @param counts Counts to add the tree to (input and output)
+ */
+void goengc_perft(GoengcBoard* restrict board, GoengcColor to_move,
+                  uint8_t passes, uint8_t depth,
+                  GoengcPerftCounts* restrict counts);
+
+/**
+ * Enumerate the move tree below a position on several threads.
+ * The subtrees below the first two plies are handed out to the threads one
+ * at a time, so large and small subtrees balance out.
+ * @param board The position
+ * @param to_move The color to move
+ * @param passes Consecutive passes that led to the position (0 to 2)
+ * @param depth The number of plies to enumerate
+ * @param num_threads The number of threads, the caller included (at least 1)
+ * @param counts The counts of the tree (output)
+ * @param divide Nodes below each first move, indexed by board index with
+ *               the pass at GOENGC_PERFT_PASS, or NULL (output;
+ *               GOENGC_DATA_SIZE_SQUARED entries)
+ * @return The number of threads that took part, 0 if memory for the work
+ *         items could not be allocated
+ */
+uint16_t goengc_perft_parallel(const GoengcBoard* restrict board,
+                               GoengcColor to_move, uint8_t passes,
+                               uint8_t depth, uint16_t num_threads,
+                               GoengcPerftCounts* restrict counts,
+                               uint64_t* restrict divide);
+
+#endif /* GOENGC_PERFT_H */
@@ -0,0 +1,54 @@
+#ifndef GOENGC_PLAYOUT_H
+#define GOENGC_PLAYOUT_H
+
+#include <stdint.h>
+
+#include "board.h"
+#include "pattern.h"
+#include "random.h"
+#include "types.h"
+
+/* Result of a playout */
+typedef struct {
+    int16_t score2;     /* Final score (Black minus White) * 2, komi included */
+    uint16_t num_moves; /* Moves played, including passes */
+} GoengcPlayoutResult;
+
+/**
+ * Play a position out to the end with uniformly random legal moves.
+ * Moves never fill a single-point eye of the player's own color. The playout
+ * ends after two consecutive passes or 3 moves per board point. The board is
+ * modified in place (copy it first to keep the start position); nothing is
+ * allocated. The final position is scored with goengc_score, treating all
+ * stones as alive; on return the workspace holds Black's area in scratch1 and
+ * White's area in scratch2.
+ * @param board The board to play on
+ * @param workspace Scratch space for move selection and scoring
+ * @param to_move The color to move first (black or white)
+ * @param rng The random number generator to draw moves from
+ * @return The final score and the number of moves played
+ */
+GoengcPlayoutResult goengc_playout_run(GoengcBoard* restrict board,
+                                       GoengcWorkspace* restrict workspace,
+                                       GoengcColor to_move,
+                                       GoengcRng* restrict rng);
+
+/**
+ * Play a position out like goengc_playout_run, drawing each move with
+ * probability proportional to its 3x3 pattern weight (goengc_pattern_pick).
+ * Own eyes are only avoided as far as the table gives them weight 0, as
+ * goengc_pattern_table_init does. With a table of equal weights the game is
+ * the same as goengc_playout_run's for the same generator state.
+ * @param board The board to play on
+ * @param workspace Scratch space for move selection and scoring
+ * @param to_move The color to move first (black or white)
+ * @param table The move weights
+ * @param rng The random number generator to draw moves from
+ * @return The final score and the number of moves played
+ */
+GoengcPlayoutResult goengc_playout_run_patterns(
+    GoengcBoard* restrict board, GoengcWorkspace* restrict workspace,
+    GoengcColor to_move, const GoengcPatternTable* restrict table,
+    GoengcRng* restrict rng);
+
+#endif /* GOENGC_PLAYOUT_H */
@@ -4,19 +4,110 @@
 #include <assert.h>
 #include <stdint.h>
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 /**
- * Lookup table for the population count (number of set bits) of all possible
- * uint8_t values
+ * Get the population count (number of set bits) for a uint64_t value.
+ * Uses the compiler builtin where available (a single POPCNT instruction when
+ * the target supports it), otherwise a branch-free SWAR reduction.
+ * @param value The value to count bits in
+ * @return The number of set bits (0-64)
  */
-extern const uint8_t GOENGC_POPCOUNT_TABLE[256];
+static inline uint8_t goengc_popcount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_popcountll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return (uint8_t)__popcnt64(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) +
+            ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (uint8_t)((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
 
 /**
- * Get the population count (number of set bits) for a uint8_t value
- * @param value The value to count bits in
- * @return The number of set bits (0-8)
+ * Get the index of the lowest set bit of a uint64_t value
+ * @param value The value to scan, must not be 0
+ * @return The index of the lowest set bit (0-63)
+ */
+static inline uint8_t goengc_ctz64(uint64_t value) {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (uint8_t)index;
+#else
+    /* Isolate the lowest set bit and count the bits below it */
+    return goengc_popcount64((value & (0 - value)) - 1);
+#endif
+}
+
+/**
+ * Get the number of leading zero bits of a uint64_t value
+ * @param value The value to scan, must not be 0
+ * @return The number of zero bits above the highest set bit (0-63)
+ */
+static inline uint8_t goengc_clz64(uint64_t value) {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (uint8_t)(63 - index);
+#else
+    /* Smear the highest set bit downwards and count the zeros above it */
+    value |= value >> 1;
+    value |= value >> 2;
+    value |= value >> 4;
+    value |= value >> 8;
+    value |= value >> 16;
+    value |= value >> 32;
+    return (uint8_t)(64 - goengc_popcount64(value));
+#endif
+}
+
+/**
+ * Get the index of the n-th lowest set bit of a uint64_t value
+ * @param value The value to scan
+ * @param n The rank of the bit to find (0 for the lowest set bit), must be
+ * smaller than the number of set bits
+ * @return The index of the bit (0-63)
  */
-static inline uint8_t goengc_popcount(uint8_t value) {
-    return GOENGC_POPCOUNT_TABLE[value];
+static inline uint8_t goengc_select64(uint64_t value, uint8_t n) {
+    assert(n < goengc_popcount64(value));
+#if defined(__BMI2__)
+    /* Deposit a single bit at the n-th set position */
+    return goengc_ctz64(_pdep_u64((uint64_t)1 << n, value));
+#else
+    /* Narrow down by halves, then clear the remaining lower bits */
+    uint8_t offset = 0;
+    uint8_t low = goengc_popcount64(value & 0xFFFFFFFFULL);
+    if (n >= low) {
+        n -= low;
+        value >>= 32;
+        offset = 32;
+    }
+    low = goengc_popcount64(value & 0xFFFFULL);
+    if (n >= low) {
+        n -= low;
+        value >>= 16;
+        offset += 16;
+    }
+    while (n-- > 0) {
+        value &= value - 1;
+    }
+    return offset + goengc_ctz64(value);
+#endif
 }
 
 #endif /* GOENGC_POPCOUNT_H */
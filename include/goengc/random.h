@@ -0,0 +1,58 @@
+#ifndef GOENGC_RANDOM_H
+#define GOENGC_RANDOM_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A small, fast pseudo random number generator (xorshift64*).
+ * Plain value type: each thread or playout owns its own state.
+ */
+typedef struct {
+    uint64_t state; /* Never 0 */
+} GoengcRng;
+
+/**
+ * Seed a generator
+ * @param rng The generator to seed
+ * @param seed Any value; different seeds give different sequences
+ */
+static inline void goengc_rng_seed(GoengcRng* restrict rng, uint64_t seed) {
+    assert(rng != NULL);
+    /* Spread the seed (splitmix64) so that nearby seeds diverge at once */
+    seed += 0x9E3779B97F4A7C15ULL;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+    seed ^= seed >> 31;
+    rng->state = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * Get the next 64 random bits
+ * @param rng The generator to advance
+ * @return A random value
+ */
+static inline uint64_t goengc_rng_next(GoengcRng* restrict rng) {
+    assert(rng != NULL);
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Get a random value in [0, bound) without a division
+ * @param rng The generator to advance
+ * @param bound The exclusive upper bound, must be > 0
+ * @return A random value smaller than bound
+ */
+static inline uint32_t goengc_rng_below(GoengcRng* restrict rng,
+                                        uint32_t bound) {
+    assert(bound > 0);
+    return (uint32_t)(((goengc_rng_next(rng) >> 32) * (uint64_t)bound) >> 32);
+}
+
+#endif /* GOENGC_RANDOM_H */
@@ -0,0 +1,40 @@
+#ifndef GOENGC_SCORING_H
+#define GOENGC_SCORING_H
+
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "board.h"
+
+/* Result of scoring a position */
+typedef struct {
+    int16_t black;  /* Black's points under the board's scoring system */
+    int16_t white;  /* White's points under the board's scoring system */
+    int16_t dame;   /* Empty points that belong to neither color */
+    int16_t score2; /* (black - white) * 2 - komi2 */
+} GoengcScore;
+
+/**
+ * Score a position under the board's scoring system.
+ * Every empty region is labeled in two bit-parallel region fills: one grown
+ * from the points next to Black's stones and one from the points next to
+ * White's. A region reached only from Black's side is Black's, only from
+ * White's side is White's, and reached from both (or neither) is dame.
+ * Dead stones are removed first: their points join the surrounding regions
+ * and they count as prisoners for the opponent.
+ * Area scoring counts living stones plus territory; territory scoring counts
+ * territory plus captures and prisoners. Komi is applied in score2.
+ * @param board The board to score
+ * @param dead Stones to treat as dead, or NULL if all stones are alive
+ * @param black_area Bitfield to store Black's living stones and territory
+ * (output)
+ * @param white_area Bitfield to store White's living stones and territory
+ * (output)
+ * @return The score
+ */
+GoengcScore goengc_score(const GoengcBoard* restrict board,
+                         const GoengcBitfield* restrict dead,
+                         GoengcBitfield* restrict black_area,
+                         GoengcBitfield* restrict white_area);
+
+#endif /* GOENGC_SCORING_H */
@@ -0,0 +1,80 @@
+#ifndef GOENGC_SGF_H
+#define GOENGC_SGF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "board.h"
+#include "types.h"
+
+/* Outcome of replaying SGF input */
+typedef enum {
+    GOENGC_SGF_OK = 0,      /* All input was read */
+    GOENGC_SGF_STOPPED = 1, /* A callback asked to stop */
+    GOENGC_SGF_SYNTAX = 2,  /* Malformed input; earlier games were replayed */
+    GOENGC_SGF_IO = 3       /* Reading the file failed or memory ran out */
+} GoengcSgfStatus;
+
+/* Counters of a replay */
+typedef struct {
+    uint64_t games;   /* Games replayed to the end of their main line */
+    uint64_t moves;   /* Moves played, passes included */
+    uint64_t skipped; /* Games with an unsupported size or an illegal move */
+} GoengcSgfStats;
+
+/**
+ * Callbacks of a replay. Any of them may be NULL; returning 0 from one stops
+ * the replay. The board passed in is the replay board and must not be
+ * modified.
+ */
+typedef struct {
+    /* Called once the root node (size, komi, rules, setup) is applied */
+    int (*begin_game)(const GoengcBoard* board, void* user);
+    /* Called after each move of the main line; ply counts from 0 */
+    int (*position)(const GoengcBoard* board, GoengcMove move, uint16_t ply,
+                    void* user);
+    /* Called after the last move of a game that was not skipped */
+    int (*end_game)(const GoengcBoard* board, void* user);
+    void* user; /* Passed to every callback */
+} GoengcSgfHandler;
+
+/**
+ * Replay every game of an SGF collection held in memory.
+ * The input is parsed in place without copies. Only the main line (the first
+ * variation at each branch) is replayed; other variations are skipped. The
+ * root node's SZ (square or "x:y"), KM and RU (Japanese and Korean rules
+ * select territory scoring, anything else area scoring) configure the board.
+ * AB, AW and AE map to goengc_board_setup_move in any node, B and W to
+ * goengc_board_play; an empty value or "tt" on boards up to 19x19 is a
+ * pass. A game whose size exceeds GOENGC_MAX_BOARD_SIZE, or that plays on an
+ * occupied or off-board point, is cut off there and counted as skipped.
+ * @param data The SGF text
+ * @param size The length of the text in bytes
+ * @param board The board to replay on; reused for every game
+ * @param handler The callbacks, or NULL
+ * @param stats The counters of the replay (output)
+ * @return The outcome of the replay
+ */
+GoengcSgfStatus goengc_sgf_replay_buffer(const char* data, size_t size,
+                                         GoengcBoard* restrict board,
+                                         const GoengcSgfHandler* handler,
+                                         GoengcSgfStats* restrict stats);
+
+/**
+ * Replay every game of an SGF collection read from a stream, as
+ * goengc_sgf_replay_buffer does.
+ * The stream is read in large blocks and every complete game tree in the
+ * buffer is replayed before the next read, so memory use is bounded by the
+ * block size and the largest single game, not by the input size.
+ * @param file The stream to read
+ * @param board The board to replay on; reused for every game
+ * @param handler The callbacks, or NULL
+ * @param stats The counters of the replay (output)
+ * @return The outcome of the replay
+ */
+GoengcSgfStatus goengc_sgf_replay_file(FILE* file, GoengcBoard* restrict board,
+                                       const GoengcSgfHandler* handler,
+                                       GoengcSgfStats* restrict stats);
+
+#endif /* GOENGC_SGF_H */
@@ -1,7 +1,17 @@
 #ifndef GOENGC_SIZE_H
 #define GOENGC_SIZE_H
 
+/* Largest supported board side. Set at build time (CMake option
+ * GOENGC_BOARD_SIZE) to specialize the library for a board size: bitfields,
+ * board arrays and every loop over the data area are sized from it. */
+#ifndef GOENGC_MAX_BOARD_SIZE
 #define GOENGC_MAX_BOARD_SIZE 19
+#endif
+
+#if GOENGC_MAX_BOARD_SIZE < 2 || GOENGC_MAX_BOARD_SIZE > 25
+#error "GOENGC_MAX_BOARD_SIZE must be between 2 and 25"
+#endif
+
 #define GOENGC_PAD 1
 #define GOENGC_DATA_SIZE (GOENGC_MAX_BOARD_SIZE + 2 * GOENGC_PAD)
 #define GOENGC_DATA_SIZE_SQUARED (GOENGC_DATA_SIZE * GOENGC_DATA_SIZE)
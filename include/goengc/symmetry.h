@@ -0,0 +1,163 @@
+#ifndef GOENGC_SYMMETRY_H
+#define GOENGC_SYMMETRY_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "bitfield.h"
+#include "color_field.h"
+#include "size.h"
+#include "types.h"
+
+#define GOENGC_NUM_SYMMETRIES 8
+
+/* Symmetry flags: an optional transpose, then optional mirrors of the
+ * transposed board */
+#define GOENGC_SYMMETRY_FLIP_X_BIT 1    /* x -> width - 1 - x */
+#define GOENGC_SYMMETRY_FLIP_Y_BIT 2    /* y -> height - 1 - y */
+#define GOENGC_SYMMETRY_TRANSPOSE_BIT 4 /* (x, y) -> (y, x), applied first */
+
+/* The rotations and reflections of a board, with y pointing down.
+ * The first four keep the board's width and height, so they are the only
+ * symmetries of a non-square board. */
+typedef enum {
+    GOENGC_SYMMETRY_IDENTITY = 0,
+    GOENGC_SYMMETRY_FLIP_X = 1,        /* Mirror left and right */
+    GOENGC_SYMMETRY_FLIP_Y = 2,        /* Mirror top and bottom */
+    GOENGC_SYMMETRY_ROTATE_180 = 3,
+    GOENGC_SYMMETRY_TRANSPOSE = 4,     /* Mirror along the main diagonal */
+    GOENGC_SYMMETRY_ROTATE_90 = 5,     /* Clockwise */
+    GOENGC_SYMMETRY_ROTATE_270 = 6,    /* Clockwise */
+    GOENGC_SYMMETRY_ANTI_TRANSPOSE = 7 /* Mirror along the anti-diagonal */
+} GoengcSymmetry;
+
+/**
+ * Get the symmetry that undoes another one
+ * @param symmetry The symmetry to invert
+ * @return The inverse symmetry
+ */
+static inline GoengcSymmetry goengc_symmetry_inverse(GoengcSymmetry symmetry) {
+    /* Only the rotations by 90 degrees are not their own inverse */
+    if (symmetry == GOENGC_SYMMETRY_ROTATE_90) {
+        return GOENGC_SYMMETRY_ROTATE_270;
+    }
+    if (symmetry == GOENGC_SYMMETRY_ROTATE_270) {
+        return GOENGC_SYMMETRY_ROTATE_90;
+    }
+    return symmetry;
+}
+
+/**
+ * Get the number of symmetries of a board size
+ * Symmetries below the returned count map the board onto itself.
+ * @param board_size The board size
+ * @return 8 for a square board, 4 otherwise
+ */
+static inline uint8_t goengc_symmetry_count(GoengcVec2 board_size) {
+    return board_size.x == board_size.y ? GOENGC_NUM_SYMMETRIES
+                                        : GOENGC_NUM_SYMMETRIES / 2;
+}
+
+/**
+ * Get the size of a board after a symmetry
+ * @param board_size The board size
+ * @param symmetry The symmetry to apply
+ * @return The size of the transformed board
+ */
+static inline GoengcVec2 goengc_symmetry_board_size(GoengcVec2 board_size,
+                                                    GoengcSymmetry symmetry) {
+    return (symmetry & GOENGC_SYMMETRY_TRANSPOSE_BIT)
+               ? goengc_vec2_create(board_size.y, board_size.x)
+               : board_size;
+}
+
+/**
+ * Map an on-board index through a symmetry
+ * @param index The index of an on-board point
+ * @param board_size The board size
+ * @param symmetry The symmetry to apply
+ * @return The index of the point on the transformed board
+ */
+static inline uint16_t goengc_symmetry_apply_index(uint16_t index,
+                                                   GoengcVec2 board_size,
+                                                   GoengcSymmetry symmetry) {
+    uint8_t x = index % GOENGC_DATA_SIZE - GOENGC_PAD;
+    uint8_t y = index / GOENGC_DATA_SIZE - GOENGC_PAD;
+    assert(x < board_size.x && y < board_size.y);
+
+    uint8_t width = board_size.x;
+    uint8_t height = board_size.y;
+    if (symmetry & GOENGC_SYMMETRY_TRANSPOSE_BIT) {
+        uint8_t swap = x;
+        x = y;
+        y = swap;
+        width = board_size.y;
+        height = board_size.x;
+    }
+    if (symmetry & GOENGC_SYMMETRY_FLIP_X_BIT) {
+        x = width - 1 - x;
+    }
+    if (symmetry & GOENGC_SYMMETRY_FLIP_Y_BIT) {
+        y = height - 1 - y;
+    }
+    return (y + GOENGC_PAD) * GOENGC_DATA_SIZE + x + GOENGC_PAD;
+}
+
+/**
+ * Map an on-board index through every symmetry at once
+ * Cheaper than eight calls to goengc_symmetry_apply_index: the point is
+ * split into coordinates once and each image is two additions away.
+ * @param index The index of an on-board point
+ * @param board_size The board size
+ * @param images The index of the point under each symmetry (output)
+ */
+static inline void goengc_symmetry_apply_index_all(
+    uint16_t index, GoengcVec2 board_size,
+    uint16_t images[GOENGC_NUM_SYMMETRIES]) {
+    uint16_t x = index % GOENGC_DATA_SIZE - GOENGC_PAD;
+    uint16_t y = index / GOENGC_DATA_SIZE - GOENGC_PAD;
+    assert(x < board_size.x && y < board_size.y);
+
+    /* Mirrored coordinates, and each coordinate as a row offset */
+    uint16_t fx = board_size.x - 1 - x;
+    uint16_t fy = board_size.y - 1 - y;
+    const uint16_t origin = GOENGC_PAD * GOENGC_DATA_SIZE + GOENGC_PAD;
+    images[GOENGC_SYMMETRY_IDENTITY] = origin + y * GOENGC_DATA_SIZE + x;
+    images[GOENGC_SYMMETRY_FLIP_X] = origin + y * GOENGC_DATA_SIZE + fx;
+    images[GOENGC_SYMMETRY_FLIP_Y] = origin + fy * GOENGC_DATA_SIZE + x;
+    images[GOENGC_SYMMETRY_ROTATE_180] = origin + fy * GOENGC_DATA_SIZE + fx;
+    images[GOENGC_SYMMETRY_TRANSPOSE] = origin + x * GOENGC_DATA_SIZE + y;
+    images[GOENGC_SYMMETRY_ROTATE_90] = origin + x * GOENGC_DATA_SIZE + fy;
+    images[GOENGC_SYMMETRY_ROTATE_270] = origin + fx * GOENGC_DATA_SIZE + y;
+    images[GOENGC_SYMMETRY_ANTI_TRANSPOSE] =
+        origin + fx * GOENGC_DATA_SIZE + fy;
+}
+
+/**
+ * Apply a symmetry to the on-board area of a bitfield.
+ * Rows are moved and reversed as whole words, and transposes use a bit
+ * matrix transpose, so the cost does not depend on the number of set bits.
+ * Bits outside the board are dropped.
+ * @param src The bitfield to transform
+ * @param board_size The board size of src
+ * @param symmetry The symmetry to apply
+ * @param dst The transformed bitfield, on a board of size
+ *            goengc_symmetry_board_size (output; must not alias src)
+ */
+void goengc_bitfield_transform(const GoengcBitfield* restrict src,
+                               GoengcVec2 board_size, GoengcSymmetry symmetry,
+                               GoengcBitfield* restrict dst);
+
+/**
+ * Apply a symmetry to a color field, as goengc_bitfield_transform does for
+ * each plane
+ * @param src The color field to transform
+ * @param board_size The board size of src
+ * @param symmetry The symmetry to apply
+ * @param dst The transformed color field (output; must not alias src)
+ */
+void goengc_colorfield_transform(const GoengcColorField* restrict src,
+                                 GoengcVec2 board_size, GoengcSymmetry symmetry,
+                                 GoengcColorField* restrict dst);
+
+#endif /* GOENGC_SYMMETRY_H */
@@ -0,0 +1,143 @@
+#ifndef GOENGC_TRANSPOSITION_H
+#define GOENGC_TRANSPOSITION_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Entries per bucket; a bucket fills one cache line */
+#define GOENGC_TRANSPOSITION_BUCKET_ENTRIES 4
+#define GOENGC_TRANSPOSITION_BUCKET_SIZE 64
+
+/* Move value of an entry without a best move */
+#define GOENGC_TRANSPOSITION_NO_MOVE 0xFFFF
+
+/* Payload of a table entry */
+typedef struct {
+    uint16_t move;      /* Best move as a board index, or NO_MOVE */
+    int16_t value;      /* Caller-defined, e.g. a score or scaled win rate */
+    uint16_t weight;    /* Search depth or visit count; heavier entries
+                           survive replacement */
+    uint8_t flags;      /* Caller-defined, e.g. the bound type */
+    uint8_t generation; /* Search generation; set by the table */
+} GoengcTranspositionData;
+
+/* An entry stores the key XORed with the packed payload next to the
+ * payload. Readers recompute the key from both words, so an entry torn by
+ * a concurrent writer fails verification instead of returning data of
+ * another position. */
+typedef struct {
+    _Atomic uint64_t check; /* key ^ data */
+    _Atomic uint64_t data;  /* Packed GoengcTranspositionData, 0 if empty */
+} GoengcTranspositionEntry;
+
+typedef struct {
+    _Alignas(GOENGC_TRANSPOSITION_BUCKET_SIZE) GoengcTranspositionEntry
+        entries[GOENGC_TRANSPOSITION_BUCKET_ENTRIES];
+} GoengcTranspositionBucket;
+
+_Static_assert(sizeof(GoengcTranspositionBucket) ==
+                   GOENGC_TRANSPOSITION_BUCKET_SIZE,
+               "A bucket must fill exactly one cache line");
+
+/* Hash table shared by all search threads without locks */
+typedef struct {
+    GoengcTranspositionBucket* buckets;
+    uint64_t mask;                /* Number of buckets - 1 */
+    _Atomic uint8_t generation;   /* Current search generation, never 0 */
+} GoengcTranspositionTable;
+
+/* Counters of one thread's table accesses; sum them across threads */
+typedef struct {
+    uint64_t probes;     /* Lookups */
+    uint64_t hits;       /* Lookups that found the position */
+    uint64_t stores;     /* Writes */
+    uint64_t overwrites; /* Writes that evicted another position */
+    uint64_t collisions; /* Writes into a bucket full of other positions of
+                            the current generation */
+} GoengcTranspositionStats;
+
+/**
+ * Allocate a table as large as a memory budget allows
+ * The bucket count is the largest power of two that fits the budget.
+ * @param table The table to initialize (output)
+ * @param size_mb The memory budget in MiB (at least 1)
+ * @return 0 on success, -1 if the memory could not be allocated
+ */
+int goengc_transposition_init(GoengcTranspositionTable* restrict table,
+                              size_t size_mb);
+
+/**
+ * Free the memory of a table
+ * @param table The table to free
+ */
+void goengc_transposition_free(GoengcTranspositionTable* restrict table);
+
+/**
+ * Remove all entries. Not safe while other threads use the table.
+ * @param table The table to clear
+ */
+void goengc_transposition_clear(GoengcTranspositionTable* restrict table);
+
+/**
+ * Start a new search generation
+ * Entries of earlier generations stay readable but are replaced first.
+ * @param table The table to update
+ */
+void goengc_transposition_new_generation(
+    GoengcTranspositionTable* restrict table);
+
+/**
+ * Look up a position
+ * @param table The table to search
+ * @param key The position key, e.g. goengc_zobrist_situation of the board
+ *            hash or the canonical hash
+ * @param data The payload of the position (output, only written on a hit)
+ * @param stats The counters of the calling thread, or NULL
+ * @return 1 if the position was found, 0 otherwise
+ */
+int goengc_transposition_probe(const GoengcTranspositionTable* table,
+                               uint64_t key,
+                               GoengcTranspositionData* restrict data,
+                               GoengcTranspositionStats* restrict stats);
+
+/**
+ * Store a position, replacing its old entry if present.
+ * Otherwise the entry replaced is an empty one, else the one with the
+ * oldest generation, else the one with the smallest weight.
+ * @param table The table to write
+ * @param key The position key
+ * @param data The payload to store; its generation is ignored
+ * @param stats The counters of the calling thread, or NULL
+ */
+void goengc_transposition_store(GoengcTranspositionTable* table, uint64_t key,
+                                GoengcTranspositionData data,
+                                GoengcTranspositionStats* restrict stats);
+
+/**
+ * Get the number of buckets a table has
+ * @param table The table to query
+ * @return The number of buckets
+ */
+static inline uint64_t goengc_transposition_num_buckets(
+    const GoengcTranspositionTable* restrict table) {
+    return table->mask + 1;
+}
+
+/**
+ * Hint the processor to load the bucket of a key, to overlap the cache miss
+ * with other work before the probe
+ * @param table The table to probe later
+ * @param key The position key
+ */
+static inline void goengc_transposition_prefetch(
+    const GoengcTranspositionTable* restrict table, uint64_t key) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&table->buckets[key & table->mask]);
+#else
+    (void)table;
+    (void)key;
+#endif
+}
+
+#endif /* GOENGC_TRANSPOSITION_H */
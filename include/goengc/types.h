@@ -6,6 +6,15 @@
 
 #include "size.h"
 
+/* Compact storage type for data indices and per-chain counts. Builds for
+ * boards up to 14x14 fit every index into a byte, which halves the chain
+ * arrays of GoengcBoard. */
+#if GOENGC_DATA_SIZE_SQUARED <= 256
+typedef uint8_t GoengcIndex;
+#else
+typedef uint16_t GoengcIndex;
+#endif
+
 /* Enum for stone colors using bit field representation
  * Bit meanings:
  * - 1st bit: empty(0) / occupied(1)
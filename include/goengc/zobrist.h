@@ -0,0 +1,66 @@
+#ifndef GOENGC_ZOBRIST_H
+#define GOENGC_ZOBRIST_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "size.h"
+#include "types.h"
+
+/* Key mixed into a position hash when White is to move */
+#define GOENGC_ZOBRIST_WHITE_TO_MOVE 0x5851F42D4C957F2DULL
+
+/**
+ * Mix a 64-bit value into a well distributed 64-bit key (splitmix64 finalizer)
+ * @param value The value to mix
+ * @return The mixed key
+ */
+static inline uint64_t goengc_zobrist_mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * Get the Zobrist key of a stone.
+ * Keys are derived from the position and color on the fly, so no table has to
+ * be initialized and any board size works.
+ * @param color The stone color (black or white)
+ * @param index The index of the position
+ * @return The key to XOR into the position hash
+ */
+static inline uint64_t goengc_zobrist_stone(GoengcColor color, uint16_t index) {
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+    assert(index < GOENGC_DATA_SIZE_SQUARED);
+    return goengc_zobrist_mix(((uint64_t)index << 1) |
+                              (uint64_t)(color == GOENGC_COLOR_WHITE));
+}
+
+/**
+ * Get the hash of an empty board of a given size.
+ * Boards of different sizes never share the hash of the empty position.
+ * @param board_size The board size
+ * @return The hash of the empty board
+ */
+static inline uint64_t goengc_zobrist_empty_board(GoengcVec2 board_size) {
+    return goengc_zobrist_mix(((uint64_t)board_size.x << 40) |
+                              ((uint64_t)board_size.y << 48) |
+                              ((uint64_t)1 << 56));
+}
+
+/**
+ * Add the side-to-move component to a position hash
+ * @param position_hash The hash of the stones on the board
+ * @param to_move The color to move next
+ * @return The hash of the situation (position and side to move)
+ */
+static inline uint64_t goengc_zobrist_situation(uint64_t position_hash,
+                                                GoengcColor to_move) {
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+    return to_move == GOENGC_COLOR_WHITE
+               ? position_hash ^ GOENGC_ZOBRIST_WHITE_TO_MOVE
+               : position_hash;
+}
+
+#endif /* GOENGC_ZOBRIST_H */
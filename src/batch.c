@@ -0,0 +1,177 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/batch.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "workers.h"
+
+/* Per-thread arena. The chunk queue is written by thieves, so it sits on its
+ * own cache line, away from the data the owner updates on every playout. */
+typedef struct {
+    /* Chunk queue of this worker */
+    _Alignas(GOENGC_CACHE_LINE) atomic_uint_fast32_t next_chunk;
+    uint32_t end_chunk;
+
+    /* Private state of the owning thread */
+    _Alignas(GOENGC_CACHE_LINE) GoengcBoard board;
+    GoengcRng rng;
+    GoengcWorkspace workspace;
+    uint32_t num_playouts;
+    uint32_t black_wins;
+    uint32_t white_wins;
+    int64_t score2_sum;
+    int32_t ownership[GOENGC_DATA_SIZE_SQUARED];
+} GoengcBatchWorker;
+
+/* Shared read-only job description */
+typedef struct {
+    const GoengcBoard* root;
+    GoengcColor to_move;
+    uint32_t num_playouts;
+    uint64_t seed;
+    uint16_t num_workers;
+    GoengcBatchWorker* workers;
+} GoengcBatchJob;
+
+/* Claim a chunk from a worker's queue */
+static int goengc_batch_claim(GoengcBatchWorker* worker, uint32_t* chunk) {
+    if (atomic_load_explicit(&worker->next_chunk, memory_order_relaxed) >=
+        worker->end_chunk) {
+        return 0;
+    }
+    uint32_t claimed = (uint32_t)atomic_fetch_add_explicit(
+        &worker->next_chunk, 1, memory_order_relaxed);
+    if (claimed >= worker->end_chunk) {
+        return 0;
+    }
+    *chunk = claimed;
+    return 1;
+}
+
+/* Run the playouts of one chunk in a worker's arena */
+static void goengc_batch_run_chunk(const GoengcBatchJob* job,
+                                   GoengcBatchWorker* worker, uint32_t chunk) {
+    uint32_t first = chunk * GOENGC_BATCH_CHUNK;
+    uint32_t last = first + GOENGC_BATCH_CHUNK;
+    if (last > job->num_playouts) {
+        last = job->num_playouts;
+    }
+
+    goengc_rng_seed(&worker->rng, job->seed ^ ((uint64_t)chunk << 32));
+    for (uint32_t i = first; i < last; i++) {
+        memcpy(&worker->board, job->root, sizeof(worker->board));
+        GoengcPlayoutResult playout = goengc_playout_run(
+            &worker->board, &worker->workspace, job->to_move, &worker->rng);
+
+        worker->num_playouts++;
+        worker->black_wins += playout.score2 > 0;
+        worker->white_wins += playout.score2 < 0;
+        worker->score2_sum += playout.score2;
+
+        /* The playout leaves the final areas in the workspace */
+        const GoengcBitfield* black_area = &worker->workspace.scratch1;
+        const GoengcBitfield* white_area = &worker->workspace.scratch2;
+        for (uint16_t index = goengc_bitfield_find_first(black_area);
+             index < GOENGC_DATA_SIZE_SQUARED;
+             index = goengc_bitfield_find_next(black_area, index + 1)) {
+            worker->ownership[index]++;
+        }
+        for (uint16_t index = goengc_bitfield_find_first(white_area);
+             index < GOENGC_DATA_SIZE_SQUARED;
+             index = goengc_bitfield_find_next(white_area, index + 1)) {
+            worker->ownership[index]--;
+        }
+    }
+}
+
+/* Worker: drain the own queue, then steal from the others */
+static void goengc_batch_worker(void* context, uint16_t id) {
+    GoengcBatchJob* job = context;
+    GoengcBatchWorker* self = &job->workers[id];
+    uint32_t chunk;
+
+    for (uint16_t k = 0; k < job->num_workers; k++) {
+        GoengcBatchWorker* victim =
+            &job->workers[(id + k) % job->num_workers];
+        while (goengc_batch_claim(victim, &chunk)) {
+            goengc_batch_run_chunk(job, self, chunk);
+        }
+    }
+}
+
+int goengc_batch_run(const GoengcBoard* restrict root, GoengcColor to_move,
+                     uint32_t num_playouts, uint16_t num_threads, uint64_t seed,
+                     GoengcBatchResult* restrict result) {
+    assert(root != NULL);
+    assert(result != NULL);
+    assert(num_threads > 0);
+
+    GoengcBatchWorker* workers = aligned_alloc(
+        GOENGC_CACHE_LINE, (size_t)num_threads * sizeof(GoengcBatchWorker));
+    if (workers == NULL) {
+        return -1;
+    }
+
+    /* Deal the chunks out in contiguous ranges */
+    GoengcBatchJob job = {.root = root,
+                          .to_move = to_move,
+                          .num_playouts = num_playouts,
+                          .seed = seed,
+                          .num_workers = num_threads,
+                          .workers = workers};
+    uint32_t num_chunks =
+        (num_playouts + GOENGC_BATCH_CHUNK - 1) / GOENGC_BATCH_CHUNK;
+    for (uint16_t i = 0; i < num_threads; i++) {
+        GoengcBatchWorker* worker = &workers[i];
+        atomic_init(&worker->next_chunk,
+                    (uint_fast32_t)((uint64_t)num_chunks * i / num_threads));
+        worker->end_chunk =
+            (uint32_t)((uint64_t)num_chunks * (i + 1) / num_threads);
+        worker->num_playouts = 0;
+        worker->black_wins = 0;
+        worker->white_wins = 0;
+        worker->score2_sum = 0;
+        memset(worker->ownership, 0, sizeof(worker->ownership));
+    }
+
+    /* Every playout runs even if a thread does not start, but the status
+     * reports it */
+    int status =
+        goengc_workers_run(goengc_batch_worker, &job, num_threads) ==
+                num_threads
+            ? 0
+            : -1;
+
+    /* Aggregate the arenas */
+    int64_t score2_sum = 0;
+    int64_t ownership[GOENGC_DATA_SIZE_SQUARED];
+    memset(ownership, 0, sizeof(ownership));
+    memset(result, 0, sizeof(*result));
+    for (uint16_t i = 0; i < num_threads; i++) {
+        result->num_playouts += workers[i].num_playouts;
+        result->black_wins += workers[i].black_wins;
+        result->white_wins += workers[i].white_wins;
+        score2_sum += workers[i].score2_sum;
+        for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED; index++) {
+            ownership[index] += workers[i].ownership[index];
+        }
+    }
+    if (result->num_playouts > 0) {
+        result->mean_score2 = (double)score2_sum / result->num_playouts;
+        for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED; index++) {
+            result->ownership[index] =
+                (float)ownership[index] / (float)result->num_playouts;
+        }
+    }
+
+    free(workers);
+    return status;
+}
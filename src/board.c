@@ -4,15 +4,456 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "goengc/bitfield.h"
 #include "goengc/color_field.h"
+#include "goengc/constants.h"
+#include "goengc/history.h"
+#include "goengc/instrument.h"
+#include "goengc/symmetry.h"
 #include "goengc/types.h"
+#include "goengc/zobrist.h"
+
+/* Check if a color is a stone color */
+static inline int goengc_is_stone(GoengcColor color) {
+    return color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE;
+}
+
+/* Check if a chain head is among the first count entries of heads */
+static inline int goengc_contains_head(const uint16_t* heads, uint8_t count,
+                                       uint16_t head) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (heads[i] == head) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Toggle a stone in the hash and in the hash of every symmetric image */
+static inline void goengc_board_toggle_stone(GoengcBoard* restrict board,
+                                             GoengcColor color,
+                                             uint16_t index) {
+    uint16_t images[GOENGC_NUM_SYMMETRIES];
+    goengc_symmetry_apply_index_all(index, board->board_size, images);
+
+    board->hash ^= goengc_zobrist_stone(color, index);
+    board->symmetry_hashes[GOENGC_SYMMETRY_IDENTITY] = board->hash;
+    for (uint8_t s = 1; s < GOENGC_NUM_SYMMETRIES; s++) {
+        board->symmetry_hashes[s] ^= goengc_zobrist_stone(color, images[s]);
+    }
+}
+
+/* Set the hashes to those of the empty board */
+static void goengc_board_clear_hashes(GoengcBoard* restrict board) {
+    board->hash = goengc_zobrist_empty_board(board->board_size);
+    for (uint8_t s = 0; s < GOENGC_NUM_SYMMETRIES; s++) {
+        board->symmetry_hashes[s] = goengc_zobrist_empty_board(
+            goengc_symmetry_board_size(board->board_size, (GoengcSymmetry)s));
+    }
+}
+
+/* Change the color of a point and the pattern codes of its 8 neighbors. The
+ * point is neighbor k ^ 2 of its neighbor k. */
+static inline void goengc_board_set_color(GoengcBoard* restrict board,
+                                          uint16_t index, GoengcColor color) {
+    GoengcColor previous =
+        goengc_colorfield_get_color(&board->color_field, index);
+    goengc_colorfield_set_color(&board->color_field, index, color);
+
+    uint16_t change = (uint16_t)(previous ^ color);
+    for (int k = 0; k < 8; k++) {
+        board->patterns[index + GOENGC_NEIGHBOR_8[k]] ^=
+            (uint16_t)(change << (2 * (k ^ 2)));
+    }
+}
+
+/* Spread the 8 bits of a byte to bit 0 of the 8 bytes of a word */
+static inline uint64_t goengc_spread_byte(uint64_t byte) {
+    uint64_t lanes = (byte * 0x0101010101010101) & 0x8040201008040201;
+    return ((lanes + 0x7F7F7F7F7F7F7F7F) >> 7) & 0x0101010101010101;
+}
+
+/* Word i of a plane shifted so that bit j holds the plane's bit j + shift;
+ * the plane has a zero word before and after its GOENGC_BITFIELD_WORDS words,
+ * and the shift is less than a word either way */
+static inline uint64_t goengc_shifted_word(const uint64_t* plane, uint16_t i,
+                                           int16_t shift) {
+    if (shift >= 0) {
+        uint64_t word = plane[i + 1] >> shift;
+        return shift == 0 ? word
+                          : word | plane[i + 2]
+                                       << (GOENGC_BITFIELD_WORD_BITS - shift);
+    }
+    return (plane[i + 1] << -shift) |
+           (plane[i] >> (GOENGC_BITFIELD_WORD_BITS + shift));
+}
+
+/**
+ * Recompute the pattern codes of all points from the two bit planes of the
+ * color field, 64 points at a time. For each neighbor, the planes shifted by
+ * its offset give one bit of each code per point; spreading each byte of
+ * them to one bit per byte builds the codes of 8 points in two words.
+ * @param board The board to update
+ */
+static void goengc_board_rebuild_patterns(GoengcBoard* restrict board) {
+    /* Neighbors outside the data area read as off board, both bits 0 */
+    uint64_t color[GOENGC_BITFIELD_WORDS + 2];
+    uint64_t occupied[GOENGC_BITFIELD_WORDS + 2];
+    color[0] = occupied[0] = 0;
+    color[GOENGC_BITFIELD_WORDS + 1] = occupied[GOENGC_BITFIELD_WORDS + 1] = 0;
+    memcpy(&color[1], board->color_field.color_bits.words,
+           sizeof(board->color_field.color_bits.words));
+    memcpy(&occupied[1], board->color_field.occupied_bits.words,
+           sizeof(board->color_field.occupied_bits.words));
+
+    for (uint16_t i = 0; i < GOENGC_BITFIELD_WORDS; i++) {
+        uint64_t shifted[16];
+        for (int k = 0; k < 8; k++) {
+            shifted[2 * k] =
+                goengc_shifted_word(color, i, GOENGC_NEIGHBOR_8[k]);
+            shifted[2 * k + 1] =
+                goengc_shifted_word(occupied, i, GOENGC_NEIGHBOR_8[k]);
+        }
+
+        for (uint16_t byte = 0; byte < 8; byte++) {
+            uint16_t base =
+                (uint16_t)(i * GOENGC_BITFIELD_WORD_BITS + 8 * byte);
+            if (base >= GOENGC_DATA_SIZE_SQUARED) {
+                break;
+            }
+            uint64_t low = 0;  /* Bits 0-7 of the codes, one byte per point */
+            uint64_t high = 0; /* Bits 8-15 */
+            for (int b = 0; b < 8; b++) {
+                low |= goengc_spread_byte((shifted[b] >> (8 * byte)) & 0xFF)
+                       << b;
+                high |=
+                    goengc_spread_byte((shifted[b + 8] >> (8 * byte)) & 0xFF)
+                    << b;
+            }
+            for (uint16_t j = 0; j < 8 && base + j < GOENGC_DATA_SIZE_SQUARED;
+                 j++) {
+                board->patterns[base + j] =
+                    (uint16_t)(((low >> (8 * j)) & 0xFF) |
+                               (((high >> (8 * j)) & 0xFF) << 8));
+            }
+        }
+    }
+}
+
+/* Offsets of the neighbors of GOENGC_NEIGHBOR_8 */
+static const int8_t goengc_board_neighbor_dx[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+static const int8_t goengc_board_neighbor_dy[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+
+/* Set the pattern codes of the empty board. A neighbor is empty if both its
+ * row and its column are on the board and off board otherwise, so each code
+ * is the AND of a mask of its row and a mask of its column. */
+static void goengc_board_set_empty_patterns(GoengcBoard* restrict board) {
+    uint16_t rows[GOENGC_DATA_SIZE];
+    uint16_t columns[GOENGC_DATA_SIZE];
+    for (int16_t i = 0; i < GOENGC_DATA_SIZE; i++) {
+        rows[i] = 0;
+        columns[i] = 0;
+        for (int k = 0; k < 8; k++) {
+            int16_t y = (int16_t)(i + goengc_board_neighbor_dy[k]);
+            int16_t x = (int16_t)(i + goengc_board_neighbor_dx[k]);
+            if (y >= GOENGC_PAD && y < board->board_size.y + GOENGC_PAD) {
+                rows[i] |= (uint16_t)(GOENGC_COLOR_EMPTY << (2 * k));
+            }
+            if (x >= GOENGC_PAD && x < board->board_size.x + GOENGC_PAD) {
+                columns[i] |= (uint16_t)(GOENGC_COLOR_EMPTY << (2 * k));
+            }
+        }
+    }
+
+    for (uint16_t y = 0; y < GOENGC_DATA_SIZE; y++) {
+        for (uint16_t x = 0; x < GOENGC_DATA_SIZE; x++) {
+            board->patterns[y * GOENGC_DATA_SIZE + x] = rows[y] & columns[x];
+        }
+    }
+}
+
+/* Count the liberties of a chain by walking its stones */
+static uint16_t goengc_board_count_liberties(const GoengcBoard* restrict board,
+                                             uint16_t head) {
+    uint64_t counted[GOENGC_BITFIELD_WORDS];
+    memset(counted, 0, sizeof(counted));
+    uint16_t liberties = 0;
+
+    uint16_t stone = head;
+    do {
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor = stone + GOENGC_NEIGHBOR_4[n];
+            uint16_t word = neighbor / GOENGC_BITFIELD_WORD_BITS;
+            uint64_t bit = (uint64_t)1 << (neighbor % GOENGC_BITFIELD_WORD_BITS);
+            if (goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                    GOENGC_COLOR_EMPTY &&
+                !(counted[word] & bit)) {
+                counted[word] |= bit;
+                liberties++;
+            }
+        }
+        stone = board->chain_next[stone];
+    } while (stone != head);
+
+    return liberties;
+}
+
+/* Check if an empty point is adjacent to a chain, ignoring one position */
+static inline int goengc_board_touches_chain(const GoengcBoard* restrict board,
+                                             uint16_t index, uint16_t head,
+                                             uint16_t ignore) {
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        if (neighbor != ignore && board->chain_head[neighbor] == head) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Merge two chains, relabeling the smaller one, and record the splice in
+ * undo if it is not NULL. Returns the new head. */
+static uint16_t goengc_board_merge_chains(GoengcBoard* restrict board,
+                                          uint16_t head_a, uint16_t head_b,
+                                          GoengcUndo* restrict undo) {
+    if (board->chain_size[head_a] < board->chain_size[head_b]) {
+        uint16_t swap = head_a;
+        head_a = head_b;
+        head_b = swap;
+    }
+
+    uint16_t stone = head_b;
+    do {
+        board->chain_head[stone] = head_a;
+        stone = board->chain_next[stone];
+    } while (stone != head_b);
+
+    /* Splice the circular stone lists */
+    uint16_t next = board->chain_next[head_a];
+    board->chain_next[head_a] = board->chain_next[head_b];
+    board->chain_next[head_b] = next;
+
+    board->chain_size[head_a] += board->chain_size[head_b];
+    if (undo != NULL) {
+        undo->merged_into[undo->num_merges] = head_a;
+        undo->absorbed[undo->num_merges++] = head_b;
+    }
+    return head_a;
+}
+
+/**
+ * Put a stone on an empty point and update the chains around it.
+ * Does not remove chains left without liberties.
+ * @param board The board to modify
+ * @param index The index of the empty point
+ * @param color The color of the stone
+ * @param opponents Heads of the distinct adjacent opponent chains (output)
+ * @param undo Record of the adjacent chains and merges to fill in, or NULL
+ * @return The number of entries written to opponents
+ */
+static uint8_t goengc_board_place_stone(GoengcBoard* restrict board,
+                                        uint16_t index, GoengcColor color,
+                                        uint16_t opponents[4],
+                                        GoengcUndo* restrict undo) {
+    assert(goengc_colorfield_get_color(&board->color_field, index) ==
+           GOENGC_COLOR_EMPTY);
+
+    goengc_board_set_color(board, index, color);
+    goengc_board_toggle_stone(board, color, index);
+
+    uint16_t friends[4];
+    uint8_t num_friends = 0;
+    uint8_t num_opponents = 0;
+    uint16_t liberties = 0;
+
+    /* The point stops being a liberty of every distinct adjacent chain */
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        GoengcColor neighbor_color =
+            goengc_colorfield_get_color(&board->color_field, neighbor);
+        if (neighbor_color == GOENGC_COLOR_EMPTY) {
+            liberties++;
+        } else if (goengc_is_stone(neighbor_color)) {
+            uint16_t head = board->chain_head[neighbor];
+            if (goengc_contains_head(friends, num_friends, head) ||
+                goengc_contains_head(opponents, num_opponents, head)) {
+                continue;
+            }
+            if (neighbor_color == color) {
+                friends[num_friends++] = head;
+            } else {
+                opponents[num_opponents++] = head;
+            }
+            if (undo != NULL) {
+                undo->adjacent[undo->num_adjacent] = head;
+                undo->adjacent_liberties[undo->num_adjacent++] =
+                    board->chain_liberties[head];
+            }
+            board->chain_liberties[head]--;
+        }
+    }
+
+    /* Start a new single stone chain */
+    board->chain_head[index] = index;
+    board->chain_next[index] = index;
+    board->chain_size[index] = 1;
+    board->chain_liberties[index] = liberties;
+
+    if (num_friends == 1) {
+        /* Extending one chain: only liberties of the new stone that the chain
+         * did not already have are added */
+        uint16_t head = friends[0];
+        uint16_t added = 0;
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+            if (goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                    GOENGC_COLOR_EMPTY &&
+                !goengc_board_touches_chain(board, neighbor, head, index)) {
+                added++;
+            }
+        }
+        added += board->chain_liberties[head];
+        head = goengc_board_merge_chains(board, head, index, undo);
+        board->chain_liberties[head] = added;
+    } else if (num_friends > 1) {
+        /* Joining several chains: shared liberties make a recount simpler */
+        uint16_t head = index;
+        for (uint8_t i = 0; i < num_friends; i++) {
+            head = goengc_board_merge_chains(board, head, friends[i], undo);
+        }
+        board->chain_liberties[head] =
+            goengc_board_count_liberties(board, head);
+    }
+
+    return num_opponents;
+}
+
+/**
+ * Remove all stones of a chain and give the freed points back as liberties
+ * to the adjacent chains
+ * @param board The board to modify
+ * @param head The head of the chain to remove
+ * @return The number of stones removed
+ */
+static uint16_t goengc_board_remove_chain(GoengcBoard* restrict board,
+                                          uint16_t head) {
+    GoengcColor color = goengc_colorfield_get_color(&board->color_field, head);
+
+    if (board->chain_size[head] == 1) {
+        /* Fast path for the common single stone capture: no list walks and
+         * no other stone of the chain can be among the neighbors */
+        goengc_board_set_color(board, head, GOENGC_COLOR_EMPTY);
+        goengc_board_toggle_stone(board, color, head);
+        board->chain_head[head] = GOENGC_NO_CHAIN;
+
+        uint16_t seen[4];
+        uint8_t num_seen = 0;
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor_head =
+                board->chain_head[head + GOENGC_NEIGHBOR_4[n]];
+            if (neighbor_head != GOENGC_NO_CHAIN &&
+                !goengc_contains_head(seen, num_seen, neighbor_head)) {
+                seen[num_seen++] = neighbor_head;
+                board->chain_liberties[neighbor_head]++;
+            }
+        }
+        return 1;
+    }
+
+    uint16_t stone = head;
+    do {
+        goengc_board_set_color(board, stone, GOENGC_COLOR_EMPTY);
+        goengc_board_toggle_stone(board, color, stone);
+        stone = board->chain_next[stone];
+    } while (stone != head);
+
+    stone = head;
+    do {
+        uint16_t seen[4];
+        uint8_t num_seen = 0;
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor_head =
+                board->chain_head[stone + GOENGC_NEIGHBOR_4[n]];
+            if (neighbor_head != GOENGC_NO_CHAIN && neighbor_head != head &&
+                !goengc_contains_head(seen, num_seen, neighbor_head)) {
+                seen[num_seen++] = neighbor_head;
+                board->chain_liberties[neighbor_head]++;
+            }
+        }
+        stone = board->chain_next[stone];
+    } while (stone != head);
+
+    uint16_t size = board->chain_size[head];
+    stone = head;
+    do {
+        uint16_t next = board->chain_next[stone];
+        board->chain_head[stone] = GOENGC_NO_CHAIN;
+        stone = next;
+    } while (stone != head);
+
+    return size;
+}
+
+/**
+ * Label the chain containing a stone whose chain is not labeled yet, making
+ * that stone its head, and count its stones and liberties
+ * @param board The board to modify
+ * @param index The stone to start from
+ */
+static void goengc_board_build_chain(GoengcBoard* restrict board,
+                                     uint16_t index) {
+    GoengcColor color = goengc_colorfield_get_color(&board->color_field, index);
+    uint16_t stack[GOENGC_DATA_SIZE_SQUARED];
+
+    /* Collect the chain with a depth-first walk, linking stones into a
+     * circular list as they are found */
+    uint16_t size = 0;
+    uint16_t top = 0;
+    uint16_t last = index;
+    board->chain_head[index] = index;
+    board->chain_next[index] = index;
+    stack[top++] = index;
+    while (top > 0) {
+        uint16_t stone = stack[--top];
+        size++;
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor = stone + GOENGC_NEIGHBOR_4[n];
+            if (board->chain_head[neighbor] == GOENGC_NO_CHAIN &&
+                goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                    color) {
+                board->chain_head[neighbor] = index;
+                board->chain_next[neighbor] = index;
+                board->chain_next[last] = neighbor;
+                last = neighbor;
+                stack[top++] = neighbor;
+            }
+        }
+    }
+
+    board->chain_size[index] = size;
+    board->chain_liberties[index] = goengc_board_count_liberties(board, index);
+}
+
+/* Recompute all chains from the color field */
+static void goengc_board_rebuild_chains(GoengcBoard* restrict board) {
+    memset(board->chain_head, 0, sizeof(board->chain_head));
+
+    const GoengcBitfield* stones = &board->color_field.occupied_bits;
+    for (uint16_t index = goengc_bitfield_find_next(stones, 0);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(stones, index + 1)) {
+        if (board->chain_head[index] == GOENGC_NO_CHAIN) {
+            goengc_board_build_chain(board, index);
+        }
+    }
+}
 
 void goengc_board_init(GoengcBoard* restrict board, GoengcVec2 board_size,
                        int8_t komi2, GoengcScoring scoring) {
     assert(board != NULL);
     assert(board_size.x > 0 && board_size.y > 0);
-    assert(board_size.x <= GOENGC_DATA_SIZE);
-    assert(board_size.y <= GOENGC_DATA_SIZE);
+    assert(board_size.x <= GOENGC_MAX_BOARD_SIZE);
+    assert(board_size.y <= GOENGC_MAX_BOARD_SIZE);
 
     /* Initialize board configuration */
     board->board_size = board_size;
@@ -38,6 +479,13 @@ void goengc_board_reset(GoengcBoard* restrict board) {
     }
 
     board->num_captures = 0;
+    board->ko_index = GOENGC_NO_KO;
+    board->ko_color = GOENGC_COLOR_EMPTY;
+    goengc_board_clear_hashes(board);
+    goengc_board_set_empty_patterns(board);
+
+    /* No stones, no chains */
+    memset(board->chain_head, 0, sizeof(board->chain_head));
 }
 
 void goengc_board_setup_move(GoengcBoard* restrict board, GoengcMove move) {
@@ -48,25 +496,498 @@ void goengc_board_setup_move(GoengcBoard* restrict board, GoengcMove move) {
 
     if (!move.is_pass) {
         uint16_t index = goengc_coord_to_index(move.coord.x, move.coord.y);
-        goengc_colorfield_set_color(&board->color_field, index, move.color);
+        GoengcColor previous =
+            goengc_colorfield_get_color(&board->color_field, index);
+        if (previous == move.color) {
+            return;
+        }
+
+        if (previous == GOENGC_COLOR_EMPTY) {
+            /* Adding a stone never splits a chain */
+            uint16_t opponents[4];
+            goengc_board_place_stone(board, index, move.color, opponents,
+                                     NULL);
+        } else {
+            /* Removing or recoloring a stone may split its chain */
+            goengc_board_set_color(board, index, move.color);
+            goengc_board_toggle_stone(board, previous, index);
+            if (move.color != GOENGC_COLOR_EMPTY) {
+                goengc_board_toggle_stone(board, move.color, index);
+            }
+            goengc_board_rebuild_chains(board);
+        }
     }
 }
 
-/* Stub implementation - to be filled in later */
-GoengcMoveLegality goengc_board_get_move_legality(GoengcBoard* restrict board,
-                                                  GoengcMove move) {
+void goengc_board_set_colors(GoengcBoard* restrict board,
+                             const GoengcColorField* restrict color_field) {
     assert(board != NULL);
-    /* Implementation to be added later */
-    return GOENGC_MOVE_LEGAL; /* Default return to avoid compiler warnings */
+    assert(color_field != NULL);
+
+    board->color_field = *color_field;
+    board->ko_index = GOENGC_NO_KO;
+    board->ko_color = GOENGC_COLOR_EMPTY;
+
+    goengc_board_clear_hashes(board);
+    const GoengcBitfield* stones = &board->color_field.occupied_bits;
+    for (uint16_t i = goengc_bitfield_find_next(stones, 0);
+         i < GOENGC_DATA_SIZE_SQUARED;
+         i = goengc_bitfield_find_next(stones, i + 1)) {
+        goengc_board_toggle_stone(
+            board, goengc_colorfield_get_color(&board->color_field, i), i);
+    }
+
+    goengc_board_rebuild_chains(board);
+    goengc_board_rebuild_patterns(board);
 }
 
-int goengc_board_is_legal(GoengcBoard* restrict board, GoengcMove move) {
+void goengc_board_transform(const GoengcBoard* restrict src,
+                            GoengcSymmetry symmetry,
+                            GoengcBoard* restrict dst) {
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    dst->board_size = goengc_symmetry_board_size(src->board_size, symmetry);
+    dst->komi2 = src->komi2;
+    dst->scoring = src->scoring;
+    dst->num_captures = src->num_captures;
+
+    GoengcColorField color_field;
+    goengc_colorfield_transform(&src->color_field, src->board_size, symmetry,
+                                &color_field);
+    goengc_board_set_colors(dst, &color_field);
+
+    if (src->ko_index != GOENGC_NO_KO) {
+        dst->ko_index = goengc_symmetry_apply_index(src->ko_index,
+                                                    src->board_size, symmetry);
+        dst->ko_color = src->ko_color;
+    }
+}
+
+/* Legality check behind goengc_board_get_move_legality */
+static inline GoengcMoveLegality goengc_board_check_move(
+    const GoengcBoard* restrict board, GoengcMove move) {
+    if (move.is_pass) {
+        return GOENGC_MOVE_LEGAL;
+    }
+
+    uint16_t index = goengc_coord_to_index(move.coord.x, move.coord.y);
+    if (goengc_colorfield_get_color(&board->color_field, index) !=
+        GOENGC_COLOR_EMPTY) {
+        return GOENGC_MOVE_NON_EMPTY;
+    }
+    if (index == board->ko_index && move.color == board->ko_color) {
+        return GOENGC_MOVE_KO;
+    }
+
+    /* The stone has a liberty if any neighbor is empty, is a friendly chain
+     * with a liberty besides this point, or is an opponent chain in atari
+     * that gets captured */
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        GoengcColor color =
+            goengc_colorfield_get_color(&board->color_field, neighbor);
+        if (color == GOENGC_COLOR_EMPTY) {
+            return GOENGC_MOVE_LEGAL;
+        }
+        if (goengc_is_stone(color)) {
+            uint16_t liberties =
+                board->chain_liberties[board->chain_head[neighbor]];
+            if ((color == move.color) == (liberties > 1)) {
+                return GOENGC_MOVE_LEGAL;
+            }
+        }
+    }
+
+    return GOENGC_MOVE_SUICIDAL;
+}
+
+GoengcMoveLegality goengc_board_get_move_legality(
+    const GoengcBoard* restrict board, GoengcMove move) {
+    assert(board != NULL);
+    assert(move.color == GOENGC_COLOR_BLACK || move.color == GOENGC_COLOR_WHITE);
+
+    GoengcMoveLegality legality = goengc_board_check_move(board, move);
+    GOENGC_COUNT(GOENGC_COUNTER_LEGALITY_CHECKS, 1);
+    GOENGC_COUNT(GOENGC_COUNTER_LEGALITY_NON_EMPTY,
+                 legality == GOENGC_MOVE_NON_EMPTY);
+    GOENGC_COUNT(GOENGC_COUNTER_LEGALITY_SUICIDAL,
+                 legality == GOENGC_MOVE_SUICIDAL);
+    GOENGC_COUNT(GOENGC_COUNTER_LEGALITY_KO, legality == GOENGC_MOVE_KO);
+    return legality;
+}
+
+int goengc_board_is_legal(const GoengcBoard* restrict board, GoengcMove move) {
     assert(board != NULL);
     return goengc_board_get_move_legality(board, move) == GOENGC_MOVE_LEGAL;
 }
 
-/* Stub implementation - to be filled in later */
-void goengc_board_play(GoengcBoard* restrict board, GoengcMove move) {
+uint64_t goengc_board_get_hash_after_move(const GoengcBoard* restrict board,
+                                          GoengcMove move) {
     assert(board != NULL);
-    /* Implementation to be added later */
+
+    if (move.is_pass) {
+        return board->hash;
+    }
+
+    uint16_t index = goengc_coord_to_index(move.coord.x, move.coord.y);
+    GoengcColor opponent = goengc_color_opposite(move.color);
+    uint64_t hash = board->hash ^ goengc_zobrist_stone(move.color, index);
+
+    /* Remove the keys of the opponent chains the move captures */
+    uint16_t captured[4];
+    uint8_t num_captured = 0;
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        uint16_t head = board->chain_head[neighbor];
+        if (goengc_colorfield_get_color(&board->color_field, neighbor) ==
+                opponent &&
+            board->chain_liberties[head] == 1 &&
+            !goengc_contains_head(captured, num_captured, head)) {
+            captured[num_captured++] = head;
+            uint16_t stone = head;
+            do {
+                hash ^= goengc_zobrist_stone(opponent, stone);
+                stone = board->chain_next[stone];
+            } while (stone != head);
+        }
+    }
+
+    return hash;
+}
+
+int goengc_board_record_position(const GoengcBoard* restrict board,
+                                 GoengcHistory* restrict history,
+                                 GoengcColor to_move) {
+    assert(board != NULL);
+    assert(history != NULL);
+
+    uint64_t hash = history->rule == GOENGC_SUPERKO_SITUATIONAL
+                        ? goengc_zobrist_situation(board->hash, to_move)
+                        : board->hash;
+    return goengc_history_add(history, hash);
+}
+
+GoengcMoveLegality goengc_board_get_superko_legality(
+    const GoengcBoard* restrict board, const GoengcHistory* restrict history,
+    GoengcMove move) {
+    assert(board != NULL);
+    assert(history != NULL);
+
+    GoengcMoveLegality legality = goengc_board_get_move_legality(board, move);
+    /* Passing is always allowed */
+    if (legality != GOENGC_MOVE_LEGAL || move.is_pass) {
+        return legality;
+    }
+
+    uint64_t hash = goengc_board_get_hash_after_move(board, move);
+    if (history->rule == GOENGC_SUPERKO_SITUATIONAL) {
+        hash = goengc_zobrist_situation(hash,
+                                        goengc_color_opposite(move.color));
+    }
+    return goengc_history_contains(history, hash) ? GOENGC_MOVE_KO
+                                                  : GOENGC_MOVE_LEGAL;
+}
+
+void goengc_board_get_legal_moves(const GoengcBoard* restrict board,
+                                  GoengcColor color,
+                                  GoengcBitfield* restrict legal) {
+    assert(board != NULL);
+    assert(legal != NULL);
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    GoengcColorMasks masks;
+    goengc_colorfield_get_masks(&board->color_field, &masks);
+
+    /* Collect the points that give a new stone a liberty: empty points,
+     * friendly chains with a spare liberty and opponent chains in atari */
+    GoengcBitfield sources;
+    goengc_bitfield_copy(&sources, &masks.empty);
+    GoengcBitfield stones;
+    goengc_bitfield_copy(&stones, &masks.black);
+    goengc_bitfield_or(&stones, &stones, &masks.white);
+    for (uint16_t index = goengc_bitfield_find_first(&stones);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(&stones, index + 1)) {
+        uint16_t liberties =
+            board->chain_liberties[board->chain_head[index]];
+        int own = goengc_colorfield_get_color(&board->color_field, index) ==
+                  color;
+        if (own == (liberties > 1)) {
+            goengc_bitfield_set_bit(&sources, index);
+        }
+    }
+
+    goengc_bitfield_neighbors(legal, &sources);
+    goengc_bitfield_and(legal, legal, &masks.empty);
+
+    if (board->ko_index != GOENGC_NO_KO && board->ko_color == color) {
+        goengc_bitfield_clear_bit(legal, board->ko_index);
+    }
+}
+
+void goengc_board_get_superko_legal_moves(const GoengcBoard* restrict board,
+                                          const GoengcHistory* restrict history,
+                                          GoengcColor color,
+                                          GoengcBitfield* restrict legal) {
+    assert(board != NULL);
+    assert(history != NULL);
+
+    goengc_board_get_legal_moves(board, color, legal);
+
+    GoengcColor opponent = goengc_color_opposite(color);
+    for (uint16_t index = goengc_bitfield_find_first(legal);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(legal, index + 1)) {
+        GoengcMove move =
+            goengc_move_create(color, 0, goengc_index_to_coord(index));
+        uint64_t hash = goengc_board_get_hash_after_move(board, move);
+        if (history->rule == GOENGC_SUPERKO_SITUATIONAL) {
+            hash = goengc_zobrist_situation(hash, opponent);
+        }
+        if (goengc_history_contains(history, hash)) {
+            goengc_bitfield_clear_bit(legal, index);
+        }
+    }
+}
+
+int goengc_board_is_eye(const GoengcBoard* restrict board, uint16_t index,
+                        GoengcColor color) {
+    assert(board != NULL);
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    for (int n = 0; n < 4; n++) {
+        GoengcColor neighbor = goengc_colorfield_get_color(
+            &board->color_field, index + GOENGC_NEIGHBOR_4[n]);
+        if (neighbor != color && neighbor != GOENGC_COLOR_OFF_BOARD) {
+            return 0;
+        }
+    }
+
+    /* Opponent stones on the diagonals can make the eye false */
+    GoengcColor opponent = goengc_color_opposite(color);
+    uint8_t num_opponent = 0;
+    uint8_t num_off_board = 0;
+    for (int n = 0; n < 4; n++) {
+        GoengcColor diagonal = goengc_colorfield_get_color(
+            &board->color_field, index + GOENGC_NEIGHBOR_DIAGONAL[n]);
+        num_opponent += diagonal == opponent;
+        num_off_board += diagonal == GOENGC_COLOR_OFF_BOARD;
+    }
+    return num_off_board > 0 ? num_opponent == 0 : num_opponent < 2;
+}
+
+/**
+ * Shared implementation of goengc_board_play and goengc_board_play_undoable
+ * @param board The board to modify
+ * @param move The move to play
+ * @param undo Record of the chain changes to fill in, or NULL
+ * @return The number of stones captured by the move
+ */
+static uint16_t goengc_board_play_move(GoengcBoard* restrict board,
+                                       GoengcMove move,
+                                       GoengcUndo* restrict undo) {
+    GOENGC_COUNT(GOENGC_COUNTER_BOARD_PLAYS, 1);
+    board->ko_index = GOENGC_NO_KO;
+    if (move.is_pass) {
+        return 0;
+    }
+
+    uint16_t index = goengc_coord_to_index(move.coord.x, move.coord.y);
+    uint16_t opponents[4];
+    uint8_t num_opponents =
+        goengc_board_place_stone(board, index, move.color, opponents, undo);
+
+    /* Remove adjacent opponent chains that lost their last liberty */
+    uint16_t captured = 0;
+    uint16_t captured_index = GOENGC_NO_KO;
+    for (uint8_t i = 0; i < num_opponents; i++) {
+        if (board->chain_liberties[opponents[i]] == 0) {
+            if (undo != NULL) {
+                undo->captured[undo->num_captured++] = opponents[i];
+            }
+            captured_index = opponents[i];
+            captured += goengc_board_remove_chain(board, opponents[i]);
+        }
+    }
+    GOENGC_COUNT(GOENGC_COUNTER_BOARD_CAPTURES, captured);
+
+    int16_t sign = move.color == GOENGC_COLOR_BLACK ? 1 : -1;
+    uint16_t head = board->chain_head[index];
+    if (captured == 0 && board->chain_liberties[head] == 0) {
+        /* Suicide: the opponent captures the player's own chain */
+        if (undo != NULL) {
+            undo->captured[undo->num_captured++] = head;
+            undo->suicide = 1;
+        }
+        board->num_captures -= sign * goengc_board_remove_chain(board, head);
+        return 0;
+    }
+    board->num_captures += sign * captured;
+
+    /* A lone stone that captured a lone stone and sits in atari can be
+     * retaken immediately at the captured point */
+    if (captured == 1 && board->chain_size[head] == 1 &&
+        board->chain_liberties[head] == 1) {
+        board->ko_index = captured_index;
+        board->ko_color = goengc_color_opposite(move.color);
+    }
+
+    return captured;
+}
+
+uint16_t goengc_board_play(GoengcBoard* restrict board, GoengcMove move) {
+    assert(board != NULL);
+    assert(move.color == GOENGC_COLOR_BLACK || move.color == GOENGC_COLOR_WHITE);
+
+    return goengc_board_play_move(board, move, NULL);
+}
+
+uint16_t goengc_board_play_undoable(GoengcBoard* restrict board,
+                                    GoengcMove move,
+                                    GoengcUndo* restrict undo) {
+    assert(board != NULL);
+    assert(undo != NULL);
+    assert(move.color == GOENGC_COLOR_BLACK || move.color == GOENGC_COLOR_WHITE);
+
+    undo->move = move;
+    undo->num_adjacent = 0;
+    undo->num_merges = 0;
+    undo->num_captured = 0;
+    if (!move.is_pass) {
+        uint16_t index = goengc_coord_to_index(move.coord.x, move.coord.y);
+        undo->point_next = board->chain_next[index];
+        undo->point_size = board->chain_size[index];
+        undo->point_liberties = board->chain_liberties[index];
+    }
+    undo->hash = board->hash;
+    undo->num_captures = board->num_captures;
+    undo->ko_index = board->ko_index;
+    undo->ko_color = board->ko_color;
+    undo->suicide = 0;
+
+    return goengc_board_play_move(board, move, undo);
+}
+
+/**
+ * Put a chain removed by a move back on the board and take the freed points
+ * back from the adjacent chains, reversing goengc_board_remove_chain. The
+ * stone list and size of the chain are still in place.
+ * @param board The board to modify
+ * @param head The head of the removed chain
+ * @param color The color of its stones
+ */
+static void goengc_board_restore_chain(GoengcBoard* restrict board,
+                                       uint16_t head, GoengcColor color) {
+    uint16_t stone = head;
+    do {
+        goengc_board_set_color(board, stone, color);
+        goengc_board_toggle_stone(board, color, stone);
+        board->chain_head[stone] = head;
+        stone = board->chain_next[stone];
+    } while (stone != head);
+
+    stone = head;
+    do {
+        uint16_t seen[4];
+        uint8_t num_seen = 0;
+        for (int n = 0; n < 4; n++) {
+            uint16_t neighbor_head =
+                board->chain_head[stone + GOENGC_NEIGHBOR_4[n]];
+            if (neighbor_head != GOENGC_NO_CHAIN && neighbor_head != head &&
+                !goengc_contains_head(seen, num_seen, neighbor_head)) {
+                seen[num_seen++] = neighbor_head;
+                board->chain_liberties[neighbor_head]--;
+            }
+        }
+        stone = board->chain_next[stone];
+    } while (stone != head);
+}
+
+void goengc_board_undo(GoengcBoard* restrict board,
+                       const GoengcUndo* restrict undo) {
+    assert(board != NULL);
+    assert(undo != NULL);
+
+    if (!undo->move.is_pass) {
+        uint16_t index =
+            goengc_coord_to_index(undo->move.coord.x, undo->move.coord.y);
+        GoengcColor captured_color =
+            undo->suicide ? undo->move.color
+                          : goengc_color_opposite(undo->move.color);
+
+        /* Put the removed chains back. After a suicide this is the played
+         * stone's own chain, which leaves the board as after a quiet move. */
+        for (uint8_t i = 0; i < undo->num_captured; i++) {
+            goengc_board_restore_chain(board, undo->captured[i],
+                                       captured_color);
+        }
+
+        /* Take the played stone off and split the merges in reverse order.
+         * Swapping the next stones of the two heads again undoes the splice
+         * of goengc_board_merge_chains. */
+        assert(goengc_colorfield_get_color(&board->color_field, index) ==
+               undo->move.color);
+        goengc_board_set_color(board, index, GOENGC_COLOR_EMPTY);
+        goengc_board_toggle_stone(board, undo->move.color, index);
+        for (uint8_t i = undo->num_merges; i-- > 0;) {
+            uint16_t head = undo->merged_into[i];
+            uint16_t absorbed = undo->absorbed[i];
+            uint16_t next = board->chain_next[head];
+            board->chain_next[head] = board->chain_next[absorbed];
+            board->chain_next[absorbed] = next;
+            board->chain_size[head] -= board->chain_size[absorbed];
+
+            uint16_t stone = absorbed;
+            do {
+                board->chain_head[stone] = absorbed;
+                stone = board->chain_next[stone];
+            } while (stone != absorbed);
+        }
+        board->chain_head[index] = GOENGC_NO_CHAIN;
+        board->chain_next[index] = undo->point_next;
+        board->chain_size[index] = undo->point_size;
+        board->chain_liberties[index] = undo->point_liberties;
+
+        for (uint8_t i = 0; i < undo->num_adjacent; i++) {
+            board->chain_liberties[undo->adjacent[i]] =
+                undo->adjacent_liberties[i];
+        }
+    }
+
+    assert(board->hash == undo->hash);
+    GOENGC_COUNT(GOENGC_COUNTER_BOARD_UNDOS, 1);
+    board->num_captures = undo->num_captures;
+    board->ko_index = undo->ko_index;
+    board->ko_color = undo->ko_color;
+}
+
+void goengc_board_get_chain_stones(const GoengcBoard* restrict board,
+                                   uint16_t index,
+                                   GoengcBitfield* restrict stones) {
+    assert(board != NULL);
+    assert(stones != NULL);
+    assert(board->chain_head[index] != GOENGC_NO_CHAIN);
+
+    goengc_bitfield_clear(stones);
+    uint16_t head = board->chain_head[index];
+    uint16_t stone = head;
+    do {
+        goengc_bitfield_set_bit(stones, stone);
+        stone = board->chain_next[stone];
+    } while (stone != head);
+}
+
+void goengc_board_get_chain_liberties(const GoengcBoard* restrict board,
+                                      uint16_t index,
+                                      GoengcBitfield* restrict liberties) {
+    assert(board != NULL);
+    assert(liberties != NULL);
+
+    GoengcBitfield stones;
+    GoengcBitfield empty;
+    goengc_board_get_chain_stones(board, index, &stones);
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY, &empty);
+    goengc_bitfield_dilate(liberties, &stones);
+    goengc_bitfield_and(liberties, liberties, &empty);
 }
@@ -0,0 +1,605 @@
+#include "goengc/board_batch.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goengc/popcount.h"
+
+/* Vector kernels are compiled for their instruction set with function
+ * attributes and picked at run time, so the library runs on any x86-64 */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GOENGC_BOARD_BATCH_X86 1
+#endif
+
+#define GOENGC_BOARD_BATCH_ALIGN 64
+
+/* Shorthands of the layout */
+#define LANES GOENGC_BOARD_BATCH_LANES
+#define WORDS GOENGC_BITFIELD_WORDS
+#define GROUP GOENGC_BOARD_BATCH_GROUP_WORDS
+#define WORD_BITS GOENGC_BITFIELD_WORD_BITS
+
+/* Kernels over one group of planes */
+typedef struct {
+    /* dst = (occupied ^ flip_occupied) & (color ^ flip_color) */
+    void (*select)(const uint64_t* restrict occupied,
+                   const uint64_t* restrict color, uint64_t flip_occupied,
+                   uint64_t flip_color, uint64_t* restrict dst);
+    /* dst = neighbors of src, within a mask */
+    void (*neighbors)(const uint64_t* restrict src,
+                      const uint64_t* restrict within, uint64_t* restrict dst);
+    /* Grow region to the points of mask connected to it */
+    void (*fill)(const uint64_t* restrict mask, uint64_t* restrict region);
+} GoengcBoardBatchKernels;
+
+/* Scalar kernels. The lanes of a word are the innermost loop, so compilers
+ * can still vectorize the straight-line ones. */
+
+static void goengc_board_batch_select_scalar(const uint64_t* restrict occupied,
+                                             const uint64_t* restrict color,
+                                             uint64_t flip_occupied,
+                                             uint64_t flip_color,
+                                             uint64_t* restrict dst) {
+    for (uint16_t i = 0; i < GROUP; i++) {
+        dst[i] = (occupied[i] ^ flip_occupied) & (color[i] ^ flip_color);
+    }
+}
+
+static void goengc_board_batch_neighbors_scalar(
+    const uint64_t* restrict src, const uint64_t* restrict within,
+    uint64_t* restrict dst) {
+    for (uint16_t w = 0; w < WORDS; w++) {
+        for (uint16_t l = 0; l < LANES; l++) {
+            uint64_t word = src[w * LANES + l];
+            uint64_t prev = w > 0 ? src[(w - 1) * LANES + l] : 0;
+            uint64_t next = w + 1 < WORDS ? src[(w + 1) * LANES + l] : 0;
+            dst[w * LANES + l] =
+                ((word << 1) | (prev >> (WORD_BITS - 1)) | (word >> 1) |
+                 (next << (WORD_BITS - 1)) | (word << GOENGC_DATA_SIZE) |
+                 (prev >> (WORD_BITS - GOENGC_DATA_SIZE)) |
+                 (word >> GOENGC_DATA_SIZE) |
+                 (next << (WORD_BITS - GOENGC_DATA_SIZE))) &
+                within[w * LANES + l];
+        }
+    }
+}
+
+/* Same sweeps as goengc_flood_fill_region, one lane at a time */
+static void goengc_board_batch_fill_scalar(const uint64_t* restrict mask,
+                                           uint64_t* restrict region) {
+    for (uint16_t l = 0; l < LANES; l++) {
+        int forward = 1;
+        int changed = 1;
+        while (changed) {
+            changed = 0;
+            for (uint16_t n = 0; n < WORDS; n++) {
+                uint16_t w = forward ? n : (uint16_t)(WORDS - 1 - n);
+                uint64_t same = mask[w * LANES + l];
+                uint64_t prev = w > 0 ? region[(w - 1) * LANES + l] : 0;
+                uint64_t next = w + 1 < WORDS ? region[(w + 1) * LANES + l] : 0;
+                uint64_t incoming = (prev >> (WORD_BITS - 1)) |
+                                    (next << (WORD_BITS - 1)) |
+                                    (prev >> (WORD_BITS - GOENGC_DATA_SIZE)) |
+                                    (next << (WORD_BITS - GOENGC_DATA_SIZE));
+                uint64_t grown = region[w * LANES + l] | (incoming & same);
+                if (grown == 0) {
+                    continue;
+                }
+
+                uint64_t previous;
+                do {
+                    previous = grown;
+                    grown |= ((grown << 1) | (grown >> 1) |
+                              (grown << GOENGC_DATA_SIZE) |
+                              (grown >> GOENGC_DATA_SIZE)) &
+                             same;
+                } while (grown != previous);
+                if (grown != region[w * LANES + l]) {
+                    region[w * LANES + l] = grown;
+                    changed = 1;
+                }
+            }
+            forward = !forward;
+        }
+    }
+}
+
+static const GoengcBoardBatchKernels goengc_board_batch_scalar = {
+    goengc_board_batch_select_scalar, goengc_board_batch_neighbors_scalar,
+    goengc_board_batch_fill_scalar};
+
+#if defined(GOENGC_BOARD_BATCH_X86)
+
+/* AVX2: a word of a group is two vectors of four lanes, processed as two
+ * independent halves */
+
+__attribute__((target("avx2"))) static void goengc_board_batch_select_avx2(
+    const uint64_t* restrict occupied, const uint64_t* restrict color,
+    uint64_t flip_occupied, uint64_t flip_color, uint64_t* restrict dst) {
+    const __m256i fo = _mm256_set1_epi64x((long long)flip_occupied);
+    const __m256i fc = _mm256_set1_epi64x((long long)flip_color);
+    for (uint16_t i = 0; i < GROUP; i += 4) {
+        __m256i o = _mm256_load_si256((const __m256i*)(occupied + i));
+        __m256i c = _mm256_load_si256((const __m256i*)(color + i));
+        _mm256_store_si256(
+            (__m256i*)(dst + i),
+            _mm256_and_si256(_mm256_xor_si256(o, fo), _mm256_xor_si256(c, fc)));
+    }
+}
+
+/* Shifts of a word, and the bits carried in from the neighboring words */
+__attribute__((target("avx2"))) static inline __m256i
+goengc_board_batch_spread_avx2(__m256i word) {
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_slli_epi64(word, 1), _mm256_srli_epi64(word, 1)),
+        _mm256_or_si256(_mm256_slli_epi64(word, GOENGC_DATA_SIZE),
+                        _mm256_srli_epi64(word, GOENGC_DATA_SIZE)));
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+goengc_board_batch_carry_avx2(__m256i prev, __m256i next) {
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_srli_epi64(prev, WORD_BITS - 1),
+                        _mm256_slli_epi64(next, WORD_BITS - 1)),
+        _mm256_or_si256(
+            _mm256_srli_epi64(prev, WORD_BITS - GOENGC_DATA_SIZE),
+            _mm256_slli_epi64(next, WORD_BITS - GOENGC_DATA_SIZE)));
+}
+
+__attribute__((target("avx2"))) static void goengc_board_batch_neighbors_avx2(
+    const uint64_t* restrict src, const uint64_t* restrict within,
+    uint64_t* restrict dst) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (uint16_t h = 0; h < LANES; h += 4) {
+        for (uint16_t w = 0; w < WORDS; w++) {
+            __m256i word = _mm256_load_si256((const __m256i*)(src + w * LANES + h));
+            __m256i prev =
+                w > 0 ? _mm256_load_si256(
+                            (const __m256i*)(src + (w - 1) * LANES + h))
+                      : zero;
+            __m256i next =
+                w + 1 < WORDS ? _mm256_load_si256(
+                                    (const __m256i*)(src + (w + 1) * LANES + h))
+                              : zero;
+            __m256i grown =
+                _mm256_or_si256(goengc_board_batch_spread_avx2(word),
+                                goengc_board_batch_carry_avx2(prev, next));
+            __m256i mask =
+                _mm256_load_si256((const __m256i*)(within + w * LANES + h));
+            _mm256_store_si256((__m256i*)(dst + w * LANES + h),
+                               _mm256_and_si256(grown, mask));
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void goengc_board_batch_fill_avx2(
+    const uint64_t* restrict mask, uint64_t* restrict region) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (uint16_t h = 0; h < LANES; h += 4) {
+        int forward = 1;
+        int changed = 1;
+        while (changed) {
+            changed = 0;
+            for (uint16_t n = 0; n < WORDS; n++) {
+                uint16_t w = forward ? n : (uint16_t)(WORDS - 1 - n);
+                uint64_t* at = region + w * LANES + h;
+                __m256i same =
+                    _mm256_load_si256((const __m256i*)(mask + w * LANES + h));
+                __m256i old = _mm256_load_si256((const __m256i*)at);
+                __m256i prev = w > 0 ? _mm256_load_si256(
+                                           (const __m256i*)(at - LANES))
+                                     : zero;
+                __m256i next = w + 1 < WORDS ? _mm256_load_si256(
+                                                   (const __m256i*)(at + LANES))
+                                             : zero;
+                __m256i grown = _mm256_or_si256(
+                    old, _mm256_and_si256(
+                             goengc_board_batch_carry_avx2(prev, next), same));
+                if (_mm256_testz_si256(grown, grown)) {
+                    continue;
+                }
+
+                /* Saturate within the word until no lane changes */
+                for (;;) {
+                    __m256i more = _mm256_or_si256(
+                        grown, _mm256_and_si256(
+                                   goengc_board_batch_spread_avx2(grown), same));
+                    __m256i diff = _mm256_xor_si256(more, grown);
+                    if (_mm256_testz_si256(diff, diff)) {
+                        break;
+                    }
+                    grown = more;
+                }
+                __m256i diff = _mm256_xor_si256(grown, old);
+                if (!_mm256_testz_si256(diff, diff)) {
+                    _mm256_store_si256((__m256i*)at, grown);
+                    changed = 1;
+                }
+            }
+            forward = !forward;
+        }
+    }
+}
+
+static const GoengcBoardBatchKernels goengc_board_batch_avx2 = {
+    goengc_board_batch_select_avx2, goengc_board_batch_neighbors_avx2,
+    goengc_board_batch_fill_avx2};
+
+/* AVX-512: a word of a group is one vector */
+
+__attribute__((target("avx512f"))) static void goengc_board_batch_select_avx512(
+    const uint64_t* restrict occupied, const uint64_t* restrict color,
+    uint64_t flip_occupied, uint64_t flip_color, uint64_t* restrict dst) {
+    const __m512i fo = _mm512_set1_epi64((long long)flip_occupied);
+    const __m512i fc = _mm512_set1_epi64((long long)flip_color);
+    for (uint16_t i = 0; i < GROUP; i += LANES) {
+        __m512i o = _mm512_load_si512((const void*)(occupied + i));
+        __m512i c = _mm512_load_si512((const void*)(color + i));
+        _mm512_store_si512(
+            (void*)(dst + i),
+            _mm512_and_si512(_mm512_xor_si512(o, fo), _mm512_xor_si512(c, fc)));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline __m512i
+goengc_board_batch_spread_avx512(__m512i word) {
+    return _mm512_or_si512(
+        _mm512_or_si512(_mm512_slli_epi64(word, 1), _mm512_srli_epi64(word, 1)),
+        _mm512_or_si512(_mm512_slli_epi64(word, GOENGC_DATA_SIZE),
+                        _mm512_srli_epi64(word, GOENGC_DATA_SIZE)));
+}
+
+__attribute__((target("avx512f"))) static inline __m512i
+goengc_board_batch_carry_avx512(__m512i prev, __m512i next) {
+    return _mm512_or_si512(
+        _mm512_or_si512(_mm512_srli_epi64(prev, WORD_BITS - 1),
+                        _mm512_slli_epi64(next, WORD_BITS - 1)),
+        _mm512_or_si512(
+            _mm512_srli_epi64(prev, WORD_BITS - GOENGC_DATA_SIZE),
+            _mm512_slli_epi64(next, WORD_BITS - GOENGC_DATA_SIZE)));
+}
+
+__attribute__((target("avx512f"))) static void
+goengc_board_batch_neighbors_avx512(const uint64_t* restrict src,
+                                    const uint64_t* restrict within,
+                                    uint64_t* restrict dst) {
+    const __m512i zero = _mm512_setzero_si512();
+    for (uint16_t w = 0; w < WORDS; w++) {
+        __m512i word = _mm512_load_si512((const void*)(src + w * LANES));
+        __m512i prev =
+            w > 0 ? _mm512_load_si512((const void*)(src + (w - 1) * LANES))
+                  : zero;
+        __m512i next = w + 1 < WORDS ? _mm512_load_si512(
+                                           (const void*)(src + (w + 1) * LANES))
+                                     : zero;
+        __m512i grown = _mm512_or_si512(goengc_board_batch_spread_avx512(word),
+                                        goengc_board_batch_carry_avx512(prev, next));
+        __m512i mask = _mm512_load_si512((const void*)(within + w * LANES));
+        _mm512_store_si512((void*)(dst + w * LANES),
+                           _mm512_and_si512(grown, mask));
+    }
+}
+
+__attribute__((target("avx512f"))) static void goengc_board_batch_fill_avx512(
+    const uint64_t* restrict mask, uint64_t* restrict region) {
+    const __m512i zero = _mm512_setzero_si512();
+    int forward = 1;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (uint16_t n = 0; n < WORDS; n++) {
+            uint16_t w = forward ? n : (uint16_t)(WORDS - 1 - n);
+            uint64_t* at = region + w * LANES;
+            __m512i same = _mm512_load_si512((const void*)(mask + w * LANES));
+            __m512i old = _mm512_load_si512((const void*)at);
+            __m512i prev =
+                w > 0 ? _mm512_load_si512((const void*)(at - LANES)) : zero;
+            __m512i next = w + 1 < WORDS
+                               ? _mm512_load_si512((const void*)(at + LANES))
+                               : zero;
+            __m512i grown = _mm512_or_si512(
+                old, _mm512_and_si512(
+                         goengc_board_batch_carry_avx512(prev, next), same));
+            if (_mm512_test_epi64_mask(grown, grown) == 0) {
+                continue;
+            }
+
+            /* Saturate within the word until no lane changes */
+            for (;;) {
+                __m512i more = _mm512_or_si512(
+                    grown, _mm512_and_si512(
+                               goengc_board_batch_spread_avx512(grown), same));
+                if (_mm512_cmpneq_epi64_mask(more, grown) == 0) {
+                    break;
+                }
+                grown = more;
+            }
+            if (_mm512_cmpneq_epi64_mask(grown, old) != 0) {
+                _mm512_store_si512((void*)at, grown);
+                changed = 1;
+            }
+        }
+        forward = !forward;
+    }
+}
+
+static const GoengcBoardBatchKernels goengc_board_batch_avx512 = {
+    goengc_board_batch_select_avx512, goengc_board_batch_neighbors_avx512,
+    goengc_board_batch_fill_avx512};
+
+#endif /* GOENGC_BOARD_BATCH_X86 */
+
+/* The kernel in use; AUTO until the first kernel call or selection */
+static _Atomic int goengc_board_batch_kernel = GOENGC_BOARD_BATCH_AUTO;
+
+/* Get the widest kernel the processor supports, at most a requested one */
+static GoengcBoardBatchKernel goengc_board_batch_supported(
+    GoengcBoardBatchKernel kernel) {
+    if (kernel == GOENGC_BOARD_BATCH_AUTO) {
+        kernel = GOENGC_BOARD_BATCH_AVX512;
+    }
+#if defined(GOENGC_BOARD_BATCH_X86)
+    __builtin_cpu_init();
+    if (kernel >= GOENGC_BOARD_BATCH_AVX512 &&
+        __builtin_cpu_supports("avx512f")) {
+        return GOENGC_BOARD_BATCH_AVX512;
+    }
+    if (kernel >= GOENGC_BOARD_BATCH_AVX2 && __builtin_cpu_supports("avx2")) {
+        return GOENGC_BOARD_BATCH_AVX2;
+    }
+#endif
+    return GOENGC_BOARD_BATCH_SCALAR;
+}
+
+GoengcBoardBatchKernel goengc_board_batch_select_kernel(
+    GoengcBoardBatchKernel kernel) {
+    kernel = goengc_board_batch_supported(kernel);
+    atomic_store_explicit(&goengc_board_batch_kernel, kernel,
+                          memory_order_relaxed);
+    return kernel;
+}
+
+static const GoengcBoardBatchKernels* goengc_board_batch_kernels(void) {
+    int kernel =
+        atomic_load_explicit(&goengc_board_batch_kernel, memory_order_relaxed);
+    if (kernel == GOENGC_BOARD_BATCH_AUTO) {
+        kernel = goengc_board_batch_select_kernel(GOENGC_BOARD_BATCH_AUTO);
+    }
+#if defined(GOENGC_BOARD_BATCH_X86)
+    if (kernel == GOENGC_BOARD_BATCH_AVX512) {
+        return &goengc_board_batch_avx512;
+    }
+    if (kernel == GOENGC_BOARD_BATCH_AVX2) {
+        return &goengc_board_batch_avx2;
+    }
+#endif
+    return &goengc_board_batch_scalar;
+}
+
+/* Allocate a zeroed plane of a number of groups */
+static uint64_t* goengc_board_batch_alloc_groups(uint32_t num_groups) {
+    size_t size = (size_t)num_groups * GROUP * sizeof(uint64_t);
+    uint64_t* plane = aligned_alloc(GOENGC_BOARD_BATCH_ALIGN, size);
+    if (plane != NULL) {
+        memset(plane, 0, size);
+    }
+    return plane;
+}
+
+int goengc_board_batch_init(GoengcBoardBatch* restrict batch,
+                            uint32_t num_boards) {
+    assert(batch != NULL);
+    assert(num_boards > 0);
+
+    batch->num_boards = num_boards;
+    batch->num_groups = (num_boards + LANES - 1) / LANES;
+    batch->occupied = goengc_board_batch_alloc_groups(batch->num_groups);
+    batch->color = goengc_board_batch_alloc_groups(batch->num_groups);
+    batch->info = calloc(num_boards, sizeof(GoengcBoardBatchInfo));
+    if (batch->occupied == NULL || batch->color == NULL ||
+        batch->info == NULL) {
+        goengc_board_batch_free(batch);
+        return -1;
+    }
+    return 0;
+}
+
+void goengc_board_batch_free(GoengcBoardBatch* restrict batch) {
+    assert(batch != NULL);
+
+    free(batch->occupied);
+    free(batch->color);
+    free(batch->info);
+    batch->occupied = NULL;
+    batch->color = NULL;
+    batch->info = NULL;
+    batch->num_boards = 0;
+    batch->num_groups = 0;
+}
+
+uint64_t* goengc_board_batch_alloc_plane(
+    const GoengcBoardBatch* restrict batch) {
+    assert(batch != NULL);
+    return goengc_board_batch_alloc_groups(batch->num_groups);
+}
+
+void goengc_board_batch_set(GoengcBoardBatch* restrict batch, uint32_t index,
+                            const GoengcBoard* restrict board) {
+    assert(batch != NULL && board != NULL);
+    assert(index < batch->num_boards);
+
+    for (uint16_t w = 0; w < WORDS; w++) {
+        size_t at = goengc_board_batch_word_index(index, w);
+        batch->occupied[at] = board->color_field.occupied_bits.words[w];
+        batch->color[at] = board->color_field.color_bits.words[w];
+    }
+    batch->info[index] =
+        (GoengcBoardBatchInfo){.num_captures = board->num_captures,
+                               .komi2 = board->komi2,
+                               .scoring = (uint8_t)board->scoring};
+}
+
+void goengc_board_batch_get_bitfield(const GoengcBoardBatch* restrict batch,
+                                     const uint64_t* restrict plane,
+                                     uint32_t index,
+                                     GoengcBitfield* restrict bitfield) {
+    assert(batch != NULL && plane != NULL && bitfield != NULL);
+    assert(index < batch->num_boards);
+    (void)batch;
+
+    for (uint16_t w = 0; w < WORDS; w++) {
+        bitfield->words[w] = plane[goengc_board_batch_word_index(index, w)];
+    }
+    bitfield->active_start = 0;
+    bitfield->active_end = GOENGC_DATA_SIZE_SQUARED;
+    goengc_bitfield_tighten(bitfield);
+}
+
+/* XOR masks that select a color class from the two planes */
+static void goengc_board_batch_color_flips(GoengcColor color,
+                                           uint64_t* flip_occupied,
+                                           uint64_t* flip_color) {
+    *flip_occupied = (color & 2) ? 0 : ~(uint64_t)0;
+    *flip_color = (color & 1) ? 0 : ~(uint64_t)0;
+}
+
+void goengc_board_batch_get_mask(const GoengcBoardBatch* restrict batch,
+                                 GoengcColor color, uint64_t* restrict mask) {
+    assert(batch != NULL && mask != NULL);
+
+    const GoengcBoardBatchKernels* kernels = goengc_board_batch_kernels();
+    uint64_t flip_occupied, flip_color;
+    goengc_board_batch_color_flips(color, &flip_occupied, &flip_color);
+    for (uint32_t g = 0; g < batch->num_groups; g++) {
+        size_t base = (size_t)g * GROUP;
+        kernels->select(batch->occupied + base, batch->color + base,
+                        flip_occupied, flip_color, mask + base);
+        if (color == GOENGC_COLOR_OFF_BOARD) {
+            for (uint16_t l = 0; l < LANES; l++) {
+                mask[base + (WORDS - 1) * LANES + l] &=
+                    GOENGC_BITFIELD_LAST_WORD_MASK;
+            }
+        }
+    }
+}
+
+void goengc_board_batch_flood_fill(const GoengcBoardBatch* restrict batch,
+                                   const uint64_t* restrict mask,
+                                   uint64_t* restrict region) {
+    assert(batch != NULL && mask != NULL && region != NULL);
+
+    const GoengcBoardBatchKernels* kernels = goengc_board_batch_kernels();
+    for (uint32_t g = 0; g < batch->num_groups; g++) {
+        kernels->fill(mask + (size_t)g * GROUP, region + (size_t)g * GROUP);
+    }
+}
+
+/* Count the set bits of each lane of a group plane */
+static void goengc_board_batch_count(const uint64_t* restrict plane,
+                                     uint16_t counts[LANES]) {
+    for (uint16_t l = 0; l < LANES; l++) {
+        counts[l] = 0;
+    }
+    for (uint16_t w = 0; w < WORDS; w++) {
+        for (uint16_t l = 0; l < LANES; l++) {
+            counts[l] += goengc_popcount64(plane[w * LANES + l]);
+        }
+    }
+}
+
+void goengc_board_batch_count_liberties(const GoengcBoardBatch* restrict batch,
+                                        GoengcColor color,
+                                        uint64_t* restrict liberties,
+                                        uint16_t* restrict counts) {
+    assert(batch != NULL && counts != NULL);
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    const GoengcBoardBatchKernels* kernels = goengc_board_batch_kernels();
+    uint64_t flip_occupied, flip_color;
+    goengc_board_batch_color_flips(color, &flip_occupied, &flip_color);
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t stones[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t empty[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t found[GROUP];
+    for (uint32_t g = 0; g < batch->num_groups; g++) {
+        size_t base = (size_t)g * GROUP;
+        uint64_t* out = liberties != NULL ? liberties + base : found;
+        kernels->select(batch->occupied + base, batch->color + base,
+                        flip_occupied, flip_color, stones);
+        kernels->select(batch->occupied + base, batch->color + base,
+                        ~(uint64_t)0, 0, empty);
+        kernels->neighbors(stones, empty, out);
+
+        uint16_t group_counts[LANES];
+        goengc_board_batch_count(out, group_counts);
+        for (uint16_t l = 0; l < LANES && g * LANES + l < batch->num_boards;
+             l++) {
+            counts[g * LANES + l] = group_counts[l];
+        }
+    }
+}
+
+void goengc_board_batch_score(const GoengcBoardBatch* restrict batch,
+                              GoengcScore* restrict scores) {
+    assert(batch != NULL && scores != NULL);
+
+    const GoengcBoardBatchKernels* kernels = goengc_board_batch_kernels();
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t black[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t white[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t empty[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t reach_black[GROUP];
+    _Alignas(GOENGC_BOARD_BATCH_ALIGN) uint64_t reach_white[GROUP];
+    for (uint32_t g = 0; g < batch->num_groups; g++) {
+        size_t base = (size_t)g * GROUP;
+        const uint64_t* occupied = batch->occupied + base;
+        const uint64_t* color = batch->color + base;
+        kernels->select(occupied, color, 0, ~(uint64_t)0, black);
+        kernels->select(occupied, color, 0, 0, white);
+        kernels->select(occupied, color, ~(uint64_t)0, 0, empty);
+
+        /* Regions reachable from each color's stones */
+        kernels->neighbors(black, empty, reach_black);
+        kernels->fill(empty, reach_black);
+        kernels->neighbors(white, empty, reach_white);
+        kernels->fill(empty, reach_white);
+
+        /* Regions reached by one color only are its territory; black and
+         * white are reused for the territories */
+        uint16_t black_stones[LANES], white_stones[LANES], open[LANES];
+        goengc_board_batch_count(black, black_stones);
+        goengc_board_batch_count(white, white_stones);
+        goengc_board_batch_count(empty, open);
+        for (uint16_t i = 0; i < GROUP; i++) {
+            black[i] = reach_black[i] & ~reach_white[i];
+            white[i] = reach_white[i] & ~reach_black[i];
+        }
+        uint16_t black_territory[LANES], white_territory[LANES];
+        goengc_board_batch_count(black, black_territory);
+        goengc_board_batch_count(white, white_territory);
+
+        for (uint16_t l = 0; l < LANES && g * LANES + l < batch->num_boards;
+             l++) {
+            const GoengcBoardBatchInfo* info = &batch->info[g * LANES + l];
+            GoengcScore* score = &scores[g * LANES + l];
+            score->dame = (int16_t)(open[l] - black_territory[l] -
+                                    white_territory[l]);
+            if (info->scoring == GOENGC_SCORING_TERRITORY) {
+                score->black = (int16_t)black_territory[l];
+                score->white = (int16_t)white_territory[l];
+                if (info->num_captures > 0) {
+                    score->black += info->num_captures;
+                } else {
+                    score->white -= info->num_captures;
+                }
+            } else {
+                score->black = (int16_t)(black_stones[l] + black_territory[l]);
+                score->white = (int16_t)(white_stones[l] + white_territory[l]);
+            }
+            score->score2 =
+                (int16_t)(2 * (score->black - score->white) - info->komi2);
+        }
+    }
+}
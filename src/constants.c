@@ -10,3 +10,29 @@ const int16_t GOENGC_NEIGHBOR_4[4] = {
     GOENGC_DATA_SIZE,  /* South: one row down */
     1                  /* East: one column right */
 };
+
+/**
+ * Definition of diagonal neighbor deltas
+ * Used for eye shape checks
+ */
+const int16_t GOENGC_NEIGHBOR_DIAGONAL[4] = {
+    -GOENGC_DATA_SIZE - 1, /* North-West */
+    GOENGC_DATA_SIZE - 1,  /* South-West */
+    GOENGC_DATA_SIZE + 1,  /* South-East */
+    -GOENGC_DATA_SIZE + 1  /* North-East */
+};
+
+/**
+ * Definition of 8-connected neighbor deltas
+ * Used for the 3x3 pattern codes
+ */
+const int16_t GOENGC_NEIGHBOR_8[8] = {
+    -GOENGC_DATA_SIZE,     /* North */
+    -1,                    /* West */
+    GOENGC_DATA_SIZE,      /* South */
+    1,                     /* East */
+    -GOENGC_DATA_SIZE - 1, /* North-West */
+    GOENGC_DATA_SIZE - 1,  /* South-West */
+    GOENGC_DATA_SIZE + 1,  /* South-East */
+    -GOENGC_DATA_SIZE + 1  /* North-East */
+};
@@ -0,0 +1,214 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/dataset.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+
+/* File header; the records follow it directly */
+typedef struct {
+    char magic[8];           /* GOENGC_DATASET_MAGIC without terminator */
+    uint32_t version;        /* GOENGC_DATASET_VERSION */
+    uint32_t record_size;    /* sizeof(GoengcDatasetRecord) */
+    uint32_t max_board_size; /* GOENGC_MAX_BOARD_SIZE of the writer */
+    uint32_t reserved0;
+    uint64_t num_records;
+    uint8_t reserved1[32];
+} GoengcDatasetHeader;
+
+_Static_assert(sizeof(GoengcDatasetHeader) == GOENGC_DATASET_HEADER_SIZE,
+               "Dataset header must match GOENGC_DATASET_HEADER_SIZE");
+
+static void goengc_dataset_header_init(GoengcDatasetHeader* header,
+                                       uint64_t num_records) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, GOENGC_DATASET_MAGIC, sizeof(header->magic));
+    header->version = GOENGC_DATASET_VERSION;
+    header->record_size = sizeof(GoengcDatasetRecord);
+    header->max_board_size = GOENGC_MAX_BOARD_SIZE;
+    header->num_records = num_records;
+}
+
+void goengc_dataset_record_from_board(const GoengcBoard* restrict board,
+                                      GoengcColor to_move, GoengcMove next_move,
+                                      int16_t result2,
+                                      GoengcDatasetRecord* restrict record) {
+    assert(board != NULL);
+    assert(record != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+
+    memset(record, 0, sizeof(*record));
+
+    const uint8_t width = board->board_size.x;
+    const uint8_t height = board->board_size.y;
+    goengc_bitfield_crop(&board->color_field.occupied_bits, width, height,
+                         record->occupied);
+    goengc_bitfield_crop(&board->color_field.color_bits, width, height,
+                         record->color);
+
+    record->board_width = width;
+    record->board_height = height;
+    record->to_move = (uint8_t)to_move;
+    record->komi2 = board->komi2;
+    record->scoring = (uint8_t)board->scoring;
+    record->ko_point =
+        board->ko_index != GOENGC_NO_KO && board->ko_color == to_move
+            ? goengc_dataset_pack_index(board->ko_index)
+            : GOENGC_DATASET_NO_POINT;
+    if (next_move.is_pass) {
+        record->next_move = GOENGC_DATASET_PASS;
+    } else if (next_move.color == GOENGC_COLOR_EMPTY) {
+        record->next_move = GOENGC_DATASET_NO_POINT;
+    } else {
+        record->next_move = goengc_dataset_pack_index(
+            goengc_coord_to_index(next_move.coord.x, next_move.coord.y));
+    }
+    record->result2 = result2;
+}
+
+void goengc_dataset_record_get_colors(
+    const GoengcDatasetRecord* restrict record,
+    GoengcColorField* restrict color_field) {
+    assert(record != NULL);
+    assert(color_field != NULL);
+
+    goengc_bitfield_uncrop(record->occupied, record->board_width,
+                           record->board_height, &color_field->occupied_bits);
+    goengc_bitfield_uncrop(record->color, record->board_width,
+                           record->board_height, &color_field->color_bits);
+}
+
+void goengc_dataset_record_to_board(const GoengcDatasetRecord* restrict record,
+                                    GoengcBoard* restrict board) {
+    assert(record != NULL);
+    assert(board != NULL);
+    assert(record->board_width > 0 &&
+           record->board_width <= GOENGC_MAX_BOARD_SIZE);
+    assert(record->board_height > 0 &&
+           record->board_height <= GOENGC_MAX_BOARD_SIZE);
+
+    board->board_size =
+        goengc_vec2_create(record->board_width, record->board_height);
+    board->komi2 = record->komi2;
+    board->scoring = (GoengcScoring)record->scoring;
+    board->num_captures = 0;
+
+    GoengcColorField color_field;
+    goengc_dataset_record_get_colors(record, &color_field);
+    goengc_board_set_colors(board, &color_field);
+
+    if (record->ko_point != GOENGC_DATASET_NO_POINT) {
+        board->ko_index = goengc_dataset_unpack_point(record->ko_point);
+        board->ko_color = (GoengcColor)record->to_move;
+    }
+}
+
+int goengc_dataset_writer_open(GoengcDatasetWriter* restrict writer,
+                               const char* path) {
+    assert(writer != NULL);
+    assert(path != NULL);
+
+    writer->num_records = 0;
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return -1;
+    }
+
+    /* The count is filled in on close */
+    GoengcDatasetHeader header;
+    goengc_dataset_header_init(&header, 0);
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int goengc_dataset_writer_add(GoengcDatasetWriter* restrict writer,
+                              const GoengcDatasetRecord* restrict record) {
+    assert(writer != NULL && writer->file != NULL);
+    assert(record != NULL);
+
+    if (fwrite(record, sizeof(*record), 1, writer->file) != 1) {
+        return -1;
+    }
+    writer->num_records++;
+    return 0;
+}
+
+int goengc_dataset_writer_close(GoengcDatasetWriter* restrict writer) {
+    assert(writer != NULL && writer->file != NULL);
+
+    GoengcDatasetHeader header;
+    goengc_dataset_header_init(&header, writer->num_records);
+    int failed = fseek(writer->file, 0, SEEK_SET) != 0 ||
+                 fwrite(&header, sizeof(header), 1, writer->file) != 1;
+    failed |= fclose(writer->file) != 0;
+    writer->file = NULL;
+    return failed ? -1 : 0;
+}
+
+int goengc_dataset_reader_open(GoengcDatasetReader* restrict reader,
+                               const char* path) {
+    assert(reader != NULL);
+    assert(path != NULL);
+
+    memset(reader, 0, sizeof(*reader));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (uint64_t)info.st_size < sizeof(GoengcDatasetHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+
+    /* Reject files of another version, board size or byte order, and files
+     * shorter than their header claims (e.g. an unfinished copy) */
+    GoengcDatasetHeader expected;
+    const GoengcDatasetHeader* header = mapping;
+    goengc_dataset_header_init(&expected, header->num_records);
+    uint64_t available =
+        (size - sizeof(GoengcDatasetHeader)) / sizeof(GoengcDatasetRecord);
+    if (memcmp(header, &expected, offsetof(GoengcDatasetHeader, reserved0)) !=
+            0 ||
+        header->num_records > available) {
+        munmap(mapping, size);
+        return -1;
+    }
+
+    /* Training samples records at random; read-ahead would only waste I/O */
+    posix_madvise(mapping, size, POSIX_MADV_RANDOM);
+
+    reader->mapping = mapping;
+    reader->mapping_size = size;
+    reader->records =
+        (const GoengcDatasetRecord*)((const char*)mapping +
+                                     sizeof(GoengcDatasetHeader));
+    reader->num_records = header->num_records;
+    return 0;
+}
+
+void goengc_dataset_reader_close(GoengcDatasetReader* restrict reader) {
+    assert(reader != NULL && reader->mapping != NULL);
+
+    munmap(reader->mapping, reader->mapping_size);
+    memset(reader, 0, sizeof(*reader));
+}
@@ -0,0 +1,219 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/features.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GOENGC_FEATURES_SSE2 1
+#endif
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "workers.h"
+
+/* Threads per call, the calling thread included */
+#define GOENGC_FEATURES_MAX_THREADS 64
+
+#define GOENGC_FEATURES_MAX_PLANES \
+    (GOENGC_FEATURE_HISTORY + 2 * GOENGC_FEATURES_MAX_HISTORY)
+
+/* A contiguous range of samples to encode */
+typedef struct {
+    const GoengcBoard* boards;
+    const GoengcColor* to_move;
+    uint8_t history;
+    GoengcFeatureFormat format;
+    void* output;
+    uint32_t first;
+    uint32_t last;
+} GoengcFeaturesJob;
+
+/* Expand cropped plane bits to one byte per point */
+static void goengc_features_expand_uint8(const uint64_t* restrict bits,
+                                         uint8_t* restrict out) {
+    uint16_t i = 0;
+#if defined(GOENGC_FEATURES_SSE2)
+    /* Broadcast each byte of 16 bits over 8 lanes and test one bit per lane */
+    const __m128i select = _mm_set_epi8(
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, (char)0x80, 0x40,
+        0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 16 <= GOENGC_FEATURES_PLANE_SIZE; i += 16) {
+        uint64_t chunk = goengc_bits_get(bits, i, 16);
+        __m128i lanes = _mm_set_epi64x(
+            (long long)((chunk >> 8) * 0x0101010101010101ULL),
+            (long long)((chunk & 0xFF) * 0x0101010101010101ULL));
+        lanes = _mm_cmpeq_epi8(_mm_and_si128(lanes, select), select);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_and_si128(lanes, one));
+    }
+#else
+    /* Broadcast 8 bits over the bytes of a word, keep one bit per byte and
+     * carry it to the byte's lowest bit */
+    for (; i + 8 <= GOENGC_FEATURES_PLANE_SIZE; i += 8) {
+        uint64_t lanes = goengc_bits_get(bits, i, 8) * 0x0101010101010101ULL;
+        lanes &= 0x8040201008040201ULL;
+        lanes = ((lanes + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+        memcpy(out + i, &lanes, sizeof(lanes));
+    }
+#endif
+    for (; i < GOENGC_FEATURES_PLANE_SIZE; i++) {
+        out[i] = (uint8_t)goengc_bits_get(bits, i, 1);
+    }
+}
+
+/* Expand cropped plane bits to one float per point */
+static void goengc_features_expand_float32(const uint64_t* restrict bits,
+                                           float* restrict out) {
+    uint16_t i = 0;
+#if defined(GOENGC_FEATURES_SSE2)
+    /* Broadcast 4 bits over 4 lanes and turn each lane's bit into a mask of
+     * 1.0f */
+    const __m128i select = _mm_set_epi32(8, 4, 2, 1);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 16 <= GOENGC_FEATURES_PLANE_SIZE; i += 16) {
+        uint32_t chunk = (uint32_t)goengc_bits_get(bits, i, 16);
+        for (uint8_t k = 0; k < 16; k += 4) {
+            __m128i lanes = _mm_set1_epi32((int)(chunk >> k));
+            lanes = _mm_cmpeq_epi32(_mm_and_si128(lanes, select), select);
+            _mm_storeu_ps(out + i + k,
+                          _mm_and_ps(_mm_castsi128_ps(lanes), one));
+        }
+    }
+#endif
+    for (; i < GOENGC_FEATURES_PLANE_SIZE; i++) {
+        out[i] = (float)goengc_bits_get(bits, i, 1);
+    }
+}
+
+/* Build the planes of one sample in the cropped bit layout */
+static void goengc_features_build(const GoengcBoard* boards,
+                                  GoengcColor to_move, uint8_t history,
+                                  uint64_t planes[][GOENGC_BITFIELD_CROPPED_WORDS]) {
+    memset(planes, 0,
+           goengc_features_num_planes(history) * sizeof(planes[0]));
+
+    /* Color classes a row at a time straight from the two color planes:
+     * black = O & ~C, white = O & C, empty = ~O & C, on-board = O | C */
+    for (uint8_t h = 0; h <= history; h++) {
+        const GoengcBoard* board = &boards[h];
+        const uint64_t* occupied = board->color_field.occupied_bits.words;
+        const uint64_t* color = board->color_field.color_bits.words;
+        const uint8_t width = board->board_size.x;
+        uint64_t* own = planes[h == 0 ? GOENGC_FEATURE_OWN
+                                      : GOENGC_FEATURE_HISTORY + 2 * (h - 1)];
+        uint64_t* opponent =
+            planes[h == 0 ? GOENGC_FEATURE_OPPONENT
+                          : GOENGC_FEATURE_HISTORY + 2 * (h - 1) + 1];
+
+        for (uint8_t y = 0; y < board->board_size.y; y++) {
+            uint16_t from = (y + GOENGC_PAD) * GOENGC_DATA_SIZE + GOENGC_PAD;
+            uint16_t to = (uint16_t)(y * GOENGC_FEATURES_SIZE);
+            uint64_t o = goengc_bits_get(occupied, from, width);
+            uint64_t c = goengc_bits_get(color, from, width);
+            uint64_t white = o & c;
+            uint64_t black = o & ~c;
+            goengc_bits_put(own, to, width,
+                            to_move == GOENGC_COLOR_BLACK ? black : white);
+            goengc_bits_put(opponent, to, width,
+                            to_move == GOENGC_COLOR_BLACK ? white : black);
+            if (h == 0) {
+                goengc_bits_put(planes[GOENGC_FEATURE_EMPTY], to, width,
+                                ~o & c);
+                goengc_bits_put(planes[GOENGC_FEATURE_ON_BOARD], to, width,
+                                o | c);
+            }
+        }
+    }
+
+    /* Liberties from the chain data of the current position */
+    const GoengcBoard* board = &boards[0];
+    const GoengcBitfield* stones = &board->color_field.occupied_bits;
+    for (uint16_t index = goengc_bitfield_find_next(stones, 0);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(stones, index + 1)) {
+        uint16_t liberties = board->chain_liberties[board->chain_head[index]];
+        uint8_t plane = liberties >= 3   ? GOENGC_FEATURE_LIBERTIES_3
+                        : liberties == 2 ? GOENGC_FEATURE_LIBERTIES_2
+                                         : GOENGC_FEATURE_LIBERTIES_1;
+        GoengcVec2 coord = goengc_index_to_coord(index);
+        goengc_bits_put(planes[plane],
+                        (uint16_t)((coord.y - GOENGC_PAD) * GOENGC_FEATURES_SIZE +
+                                   coord.x - GOENGC_PAD),
+                        1, 1);
+    }
+
+    if (board->ko_index != GOENGC_NO_KO && board->ko_color == to_move) {
+        GoengcVec2 coord = goengc_index_to_coord(board->ko_index);
+        goengc_bits_put(planes[GOENGC_FEATURE_KO],
+                        (uint16_t)((coord.y - GOENGC_PAD) * GOENGC_FEATURES_SIZE +
+                                   coord.x - GOENGC_PAD),
+                        1, 1);
+    }
+}
+
+/* Encode the samples of a job */
+static void goengc_features_run(const GoengcFeaturesJob* job) {
+    const uint16_t num_planes = goengc_features_num_planes(job->history);
+    uint64_t planes[GOENGC_FEATURES_MAX_PLANES][GOENGC_BITFIELD_CROPPED_WORDS];
+
+    for (uint32_t sample = job->first; sample < job->last; sample++) {
+        goengc_features_build(&job->boards[(size_t)sample * (job->history + 1)],
+                              job->to_move[sample], job->history, planes);
+
+        size_t offset = (size_t)sample * num_planes * GOENGC_FEATURES_PLANE_SIZE;
+        for (uint16_t p = 0; p < num_planes; p++) {
+            size_t plane_offset = offset + (size_t)p * GOENGC_FEATURES_PLANE_SIZE;
+            if (job->format == GOENGC_FEATURES_UINT8) {
+                goengc_features_expand_uint8(
+                    planes[p], (uint8_t*)job->output + plane_offset);
+            } else {
+                goengc_features_expand_float32(
+                    planes[p], (float*)job->output + plane_offset);
+            }
+        }
+    }
+}
+
+/* Worker: encode the share of the job with the worker's id */
+static void goengc_features_worker(void* context, uint16_t id) {
+    const GoengcFeaturesJob* jobs = context;
+    goengc_features_run(&jobs[id]);
+}
+
+void goengc_features_encode(const GoengcBoard* boards,
+                            const GoengcColor* to_move, uint32_t batch_size,
+                            uint8_t history, GoengcFeatureFormat format,
+                            uint16_t num_threads, void* output) {
+    assert(boards != NULL);
+    assert(to_move != NULL);
+    assert(output != NULL);
+    assert(history <= GOENGC_FEATURES_MAX_HISTORY);
+    assert(num_threads > 0);
+
+    /* Only split batches that keep every thread busy for a while */
+    uint32_t max_threads = batch_size / GOENGC_FEATURES_MIN_THREAD_BATCH;
+    if (max_threads > GOENGC_FEATURES_MAX_THREADS) {
+        max_threads = GOENGC_FEATURES_MAX_THREADS;
+    }
+    uint32_t count = num_threads < max_threads ? num_threads : max_threads;
+    if (count == 0) {
+        count = 1;
+    }
+
+    GoengcFeaturesJob jobs[GOENGC_FEATURES_MAX_THREADS];
+    for (uint32_t t = 0; t < count; t++) {
+        jobs[t] = (GoengcFeaturesJob){
+            .boards = boards,
+            .to_move = to_move,
+            .history = history,
+            .format = format,
+            .output = output,
+            .first = (uint32_t)((uint64_t)batch_size * t / count),
+            .last = (uint32_t)((uint64_t)batch_size * (t + 1) / count)};
+    }
+
+    goengc_workers_run(goengc_features_worker, jobs, (uint16_t)count);
+}
@@ -7,10 +7,104 @@
 #include "goengc/bitfield.h"
 #include "goengc/color_field.h"
 #include "goengc/constants.h"
+#include "goengc/instrument.h"
 #include "goengc/size.h"
 #include "goengc/types.h"
 
-/* Flood fill implementation */
+/* Mark all positions with the same color as the seed */
+static void goengc_flood_fill_prepare(
+    const GoengcColorField* restrict color_field, uint16_t seed_index,
+    GoengcBitfield* restrict same_color, GoengcBitfield* restrict visited) {
+    /* Get the seed color that we'll be matching */
+    GoengcColor target_color =
+        goengc_colorfield_get_color(color_field, seed_index);
+
+    /* Extract the color class in one pass over the two color planes */
+    goengc_colorfield_get_mask(color_field, target_color, same_color);
+    goengc_bitfield_clear(visited);
+
+    /* Initialize visited with the seed */
+    goengc_bitfield_set_bit(visited, seed_index);
+}
+
+/* Dilate a word of the region to saturation, staying within one word */
+static inline uint64_t goengc_flood_fill_word(uint64_t region,
+                                              uint64_t mask) {
+    uint64_t previous;
+    do {
+        previous = region;
+        region |= ((region << 1) | (region >> 1) |
+                   (region << GOENGC_DATA_SIZE) |
+                   (region >> GOENGC_DATA_SIZE)) &
+                  mask;
+    } while (region != previous);
+    return region;
+}
+
+/* Multi-seed region growth */
+void goengc_flood_fill_region(const GoengcBitfield* restrict mask,
+                              GoengcBitfield* restrict region) {
+    assert(mask != NULL);
+    assert(region != NULL);
+
+    const uint64_t* same = mask->words;
+    uint64_t* reached = region->words;
+
+    /* Only words that hold points of the mask can change */
+    uint16_t begin = goengc_bitfield_word_begin(mask);
+    uint16_t end = goengc_bitfield_word_end(mask);
+    GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_CALLS, 1);
+    if (begin >= end) {
+        return;
+    }
+
+    /* Sweep over the words in alternating directions. Each word is first
+     * seeded with the points reached from its neighbor words, then dilated to
+     * saturation in registers. A path that crosses word boundaries in the
+     * sweep direction is followed in a single sweep, so the number of sweeps
+     * only depends on how often the region turns back on itself. */
+    int forward = 1;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_ITERATIONS, 1);
+        GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_FRONTIER, end - begin);
+        for (uint16_t n = begin; n < end; n++) {
+            uint16_t i = forward ? n : (uint16_t)(end - 1 - (n - begin));
+            uint64_t prev = i > 0 ? reached[i - 1] : 0;
+            uint64_t succ = i + 1 < GOENGC_BITFIELD_WORDS ? reached[i + 1] : 0;
+
+            /* Points reached across the word boundary in any direction */
+            uint64_t incoming =
+                (prev >> (GOENGC_BITFIELD_WORD_BITS - 1)) |
+                (succ << (GOENGC_BITFIELD_WORD_BITS - 1)) |
+                (prev >> (GOENGC_BITFIELD_WORD_BITS - GOENGC_DATA_SIZE)) |
+                (succ << (GOENGC_BITFIELD_WORD_BITS - GOENGC_DATA_SIZE));
+            uint64_t grown = reached[i] | (incoming & same[i]);
+            if (grown == 0) {
+                continue;
+            }
+
+            grown = goengc_flood_fill_word(grown, same[i]);
+            if (grown != reached[i]) {
+                reached[i] = grown;
+                changed = 1;
+            }
+        }
+        forward = !forward;
+    }
+
+    /* Recompute the active area of the result */
+    if (region->active_start > begin * GOENGC_BITFIELD_WORD_BITS) {
+        region->active_start = begin * GOENGC_BITFIELD_WORD_BITS;
+    }
+    region->active_end = GOENGC_DATA_SIZE_SQUARED;
+    goengc_bitfield_tighten(region);
+    GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_BITS,
+                 goengc_bitfield_count_bits(region));
+}
+
+/* Word sweep flood fill implementation */
 void goengc_flood_fill(const GoengcColorField* restrict color_field,
                        GoengcVec2 seed, GoengcBitfield* restrict same_color,
                        GoengcBitfield* restrict visited) {
@@ -18,33 +112,35 @@ void goengc_flood_fill(const GoengcColorField* restrict color_field,
     assert(same_color != NULL);
     assert(visited != NULL);
 
-    /* Convert seed coordinates to index */
     uint16_t seed_index = goengc_coord_to_index(seed.x, seed.y);
+    goengc_flood_fill_prepare(color_field, seed_index, same_color, visited);
+    goengc_flood_fill_region(same_color, visited);
+}
 
-    /* Get the seed color that we'll be matching */
-    GoengcColor target_color =
-        goengc_colorfield_get_color(color_field, seed_index);
+/* Frontier scan flood fill implementation */
+void goengc_flood_fill_scan(const GoengcColorField* restrict color_field,
+                            GoengcVec2 seed, GoengcBitfield* restrict same_color,
+                            GoengcBitfield* restrict visited) {
+    assert(color_field != NULL);
+    assert(same_color != NULL);
+    assert(visited != NULL);
 
-    /* Reset the scratch bitfield and visited */
-    goengc_bitfield_clear(same_color);
-    goengc_bitfield_clear(visited);
+    /* Convert seed coordinates to index */
+    uint16_t seed_index = goengc_coord_to_index(seed.x, seed.y);
 
     /* Pre-processing: Mark all positions with the same color as the seed */
-    for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED; index++) {
-        if (goengc_colorfield_get_color(color_field, index) == target_color) {
-            goengc_bitfield_set_bit(same_color, index);
-        }
-    }
-
-    /* Initialize visited with the seed */
-    goengc_bitfield_set_bit(visited, seed_index);
+    goengc_flood_fill_prepare(color_field, seed_index, same_color, visited);
 
     /* Initialize frontier tracking */
     uint16_t current_start = seed_index;
     uint16_t current_end = seed_index + 1; /* exclusive end */
+    GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_CALLS, 1);
 
     /* Iterative flooding */
     while (current_start < current_end) {
+        GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_ITERATIONS, 1);
+        GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_FRONTIER,
+                     current_end - current_start);
         /* Initialize next frontier as empty range */
         uint16_t next_start = GOENGC_DATA_SIZE_SQUARED;
         uint16_t next_end = 0;
@@ -81,4 +177,6 @@ void goengc_flood_fill(const GoengcColorField* restrict color_field,
         current_start = next_start;
         current_end = next_end;
     }
+    GOENGC_COUNT(GOENGC_COUNTER_FLOOD_FILL_BITS,
+                 goengc_bitfield_count_bits(visited));
 }
@@ -0,0 +1,74 @@
+#include "goengc/game.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "goengc/board.h"
+#include "goengc/history.h"
+#include "goengc/types.h"
+#include "goengc/zobrist.h"
+
+/* Hash of the current position as the game's superko rule records it */
+static uint64_t goengc_game_position_hash(const GoengcGame* restrict game) {
+    return game->rule == GOENGC_SUPERKO_SITUATIONAL
+               ? goengc_zobrist_situation(game->board.hash, game->to_move)
+               : game->board.hash;
+}
+
+void goengc_game_init(GoengcGame* restrict game, GoengcVec2 board_size,
+                      int8_t komi2, GoengcScoring scoring, GoengcSuperko rule) {
+    assert(game != NULL);
+
+    goengc_board_init(&game->board, board_size, komi2, scoring);
+    game->rule = rule;
+    game->to_move = GOENGC_COLOR_BLACK;
+    game->num_moves = 0;
+    goengc_history_init(&game->history, rule);
+    goengc_history_add(&game->history, goengc_game_position_hash(game));
+}
+
+int goengc_game_play(GoengcGame* restrict game, GoengcMove move) {
+    assert(game != NULL);
+
+    if (game->num_moves >= GOENGC_GAME_MAX_MOVES) {
+        return 0;
+    }
+    goengc_board_play_undoable(&game->board, move,
+                               &game->moves[game->num_moves]);
+    game->to_move = goengc_color_opposite(move.color);
+
+    /* The history has room for every position of a full game */
+    uint64_t hash = goengc_game_position_hash(game);
+    game->new_position[game->num_moves] =
+        !goengc_history_contains(&game->history, hash);
+    int stored = goengc_history_add(&game->history, hash);
+    assert(stored);
+    (void)stored;
+    game->num_moves++;
+    return 1;
+}
+
+int goengc_game_undo(GoengcGame* restrict game) {
+    assert(game != NULL);
+
+    if (game->num_moves == 0) {
+        return 0;
+    }
+    game->num_moves--;
+    if (game->new_position[game->num_moves]) {
+        goengc_history_remove(&game->history,
+                              goengc_game_position_hash(game));
+    }
+    const GoengcUndo* undo = &game->moves[game->num_moves];
+    goengc_board_undo(&game->board, undo);
+    game->to_move = undo->move.color;
+    return 1;
+}
+
+GoengcMoveLegality goengc_game_get_superko_legality(
+    const GoengcGame* restrict game, GoengcMove move) {
+    assert(game != NULL);
+
+    return goengc_board_get_superko_legality(&game->board, &game->history,
+                                             move);
+}
@@ -0,0 +1,71 @@
+#include "goengc/history.h"
+
+#include <assert.h>
+#include <string.h>
+
+void goengc_history_init(GoengcHistory* restrict history, GoengcSuperko rule) {
+    assert(history != NULL);
+    memset(history->slots, 0, sizeof(history->slots));
+    history->count = 0;
+    history->contains_zero = 0;
+    history->rule = rule;
+}
+
+int goengc_history_add(GoengcHistory* restrict history, uint64_t hash) {
+    assert(history != NULL);
+
+    if (hash == 0) {
+        history->contains_zero = 1;
+        return 1;
+    }
+    if (history->count >= GOENGC_HISTORY_MAX_POSITIONS) {
+        return 0;
+    }
+
+    uint16_t slot = goengc_history_slot(hash);
+    while (history->slots[slot] != 0) {
+        if (history->slots[slot] == hash) {
+            return 1;
+        }
+        slot = (slot + 1) & (GOENGC_HISTORY_SLOTS - 1);
+    }
+    history->slots[slot] = hash;
+    history->count++;
+    return 1;
+}
+
+int goengc_history_remove(GoengcHistory* restrict history, uint64_t hash) {
+    assert(history != NULL);
+
+    if (hash == 0) {
+        int present = history->contains_zero;
+        history->contains_zero = 0;
+        return present;
+    }
+
+    uint16_t slot = goengc_history_slot(hash);
+    while (history->slots[slot] != hash) {
+        if (history->slots[slot] == 0) {
+            return 0;
+        }
+        slot = (slot + 1) & (GOENGC_HISTORY_SLOTS - 1);
+    }
+    history->slots[slot] = 0;
+    history->count--;
+
+    /* An entry further along the run moves into the hole unless its own
+     * starting slot lies between the hole and the entry */
+    uint16_t hole = slot;
+    for (slot = (slot + 1) & (GOENGC_HISTORY_SLOTS - 1);
+         history->slots[slot] != 0;
+         slot = (slot + 1) & (GOENGC_HISTORY_SLOTS - 1)) {
+        uint16_t home = goengc_history_slot(history->slots[slot]);
+        if (((slot - home) & (GOENGC_HISTORY_SLOTS - 1)) >=
+            ((slot - hole) & (GOENGC_HISTORY_SLOTS - 1))) {
+            history->slots[hole] = history->slots[slot];
+            history->slots[slot] = 0;
+            hole = slot;
+        }
+    }
+    return 1;
+}
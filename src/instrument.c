@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/instrument.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+
+static const char* const goengc_counter_names[GOENGC_NUM_COUNTERS] = {
+    "flood_fill.calls",        "flood_fill.iterations",
+    "flood_fill.frontier",     "flood_fill.bits",
+    "bitfield.set_bit",        "board.plays",
+    "board.captures",          "board.undos",
+    "legality.checks",         "legality.non_empty",
+    "legality.suicidal",       "legality.ko",
+};
+
+#if GOENGC_INSTRUMENT
+
+_Thread_local GoengcInstrumentBlock goengc_instrument_block;
+
+/* Live threads, and the totals of threads that have exited. The lock is
+ * only taken when a thread starts or stops counting and by snapshots. */
+static pthread_mutex_t goengc_instrument_lock = PTHREAD_MUTEX_INITIALIZER;
+static GoengcInstrumentBlock* goengc_instrument_threads = NULL;
+static uint64_t goengc_instrument_retired[GOENGC_NUM_COUNTERS];
+static pthread_once_t goengc_instrument_once = PTHREAD_ONCE_INIT;
+static pthread_key_t goengc_instrument_key;
+
+/* Thread exit: keep the counts and drop the block from the registry */
+static void goengc_instrument_retire(void* arg) {
+    GoengcInstrumentBlock* block = arg;
+    pthread_mutex_lock(&goengc_instrument_lock);
+    for (int c = 0; c < GOENGC_NUM_COUNTERS; c++) {
+        goengc_instrument_retired[c] +=
+            atomic_load_explicit(&block->counts[c], memory_order_relaxed);
+        atomic_store_explicit(&block->counts[c], 0, memory_order_relaxed);
+    }
+    GoengcInstrumentBlock** link = &goengc_instrument_threads;
+    while (*link != NULL && *link != block) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) {
+        *link = block->next;
+    }
+    block->registered = 0;
+    pthread_mutex_unlock(&goengc_instrument_lock);
+}
+
+static void goengc_instrument_create_key(void) {
+    pthread_key_create(&goengc_instrument_key, goengc_instrument_retire);
+}
+
+void goengc_instrument_register(void) {
+    GoengcInstrumentBlock* block = &goengc_instrument_block;
+    pthread_once(&goengc_instrument_once, goengc_instrument_create_key);
+
+    pthread_mutex_lock(&goengc_instrument_lock);
+    block->next = goengc_instrument_threads;
+    goengc_instrument_threads = block;
+    block->registered = 1;
+    pthread_mutex_unlock(&goengc_instrument_lock);
+
+    /* Makes the key's destructor retire the block when the thread exits */
+    pthread_setspecific(goengc_instrument_key, block);
+}
+
+int goengc_instrument_enabled(void) { return 1; }
+
+void goengc_instrument_snapshot(GoengcInstrumentSnapshot* snapshot) {
+    assert(snapshot != NULL);
+
+    pthread_mutex_lock(&goengc_instrument_lock);
+    memcpy(snapshot->counts, goengc_instrument_retired,
+           sizeof(snapshot->counts));
+    for (GoengcInstrumentBlock* block = goengc_instrument_threads;
+         block != NULL; block = block->next) {
+        for (int c = 0; c < GOENGC_NUM_COUNTERS; c++) {
+            snapshot->counts[c] +=
+                atomic_load_explicit(&block->counts[c], memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&goengc_instrument_lock);
+}
+
+void goengc_instrument_reset(void) {
+    pthread_mutex_lock(&goengc_instrument_lock);
+    memset(goengc_instrument_retired, 0, sizeof(goengc_instrument_retired));
+    for (GoengcInstrumentBlock* block = goengc_instrument_threads;
+         block != NULL; block = block->next) {
+        for (int c = 0; c < GOENGC_NUM_COUNTERS; c++) {
+            atomic_store_explicit(&block->counts[c], 0, memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&goengc_instrument_lock);
+}
+
+#else
+
+int goengc_instrument_enabled(void) { return 0; }
+
+void goengc_instrument_snapshot(GoengcInstrumentSnapshot* snapshot) {
+    assert(snapshot != NULL);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+void goengc_instrument_reset(void) {}
+
+#endif /* GOENGC_INSTRUMENT */
+
+const char* goengc_counter_name(GoengcCounter counter) {
+    assert(counter < GOENGC_NUM_COUNTERS);
+    return goengc_counter_names[counter];
+}
+
+/* Average of a counter per event of another, or 0 if there was none */
+static double goengc_instrument_ratio(const GoengcInstrumentSnapshot* snapshot,
+                                      GoengcCounter counter,
+                                      GoengcCounter per) {
+    return snapshot->counts[per] > 0 ? (double)snapshot->counts[counter] /
+                                           (double)snapshot->counts[per]
+                                     : 0.0;
+}
+
+void goengc_instrument_print(const GoengcInstrumentSnapshot* snapshot,
+                             FILE* stream) {
+    assert(snapshot != NULL);
+    assert(stream != NULL);
+
+    for (int c = 0; c < GOENGC_NUM_COUNTERS; c++) {
+        fprintf(stream, "%-24s %20llu\n", goengc_counter_names[c],
+                (unsigned long long)snapshot->counts[c]);
+    }
+    fprintf(stream, "%-24s %20.2f\n", "flood_fill.iterations/call",
+            goengc_instrument_ratio(snapshot,
+                                    GOENGC_COUNTER_FLOOD_FILL_ITERATIONS,
+                                    GOENGC_COUNTER_FLOOD_FILL_CALLS));
+    fprintf(stream, "%-24s %20.2f\n", "flood_fill.frontier/iter",
+            goengc_instrument_ratio(snapshot,
+                                    GOENGC_COUNTER_FLOOD_FILL_FRONTIER,
+                                    GOENGC_COUNTER_FLOOD_FILL_ITERATIONS));
+    fprintf(stream, "%-24s %20.2f\n", "flood_fill.bits/call",
+            goengc_instrument_ratio(snapshot, GOENGC_COUNTER_FLOOD_FILL_BITS,
+                                    GOENGC_COUNTER_FLOOD_FILL_CALLS));
+    fprintf(stream, "%-24s %20.4f\n", "board.captures/play",
+            goengc_instrument_ratio(snapshot, GOENGC_COUNTER_BOARD_CAPTURES,
+                                    GOENGC_COUNTER_BOARD_PLAYS));
+}
@@ -0,0 +1,565 @@
+#include "goengc/ladder.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/constants.h"
+#include "goengc/popcount.h"
+#include "goengc/types.h"
+
+/* Most defender moves considered at one node: the extension and captures
+ * of adjacent attacker chains in atari */
+#define GOENGC_LADDER_MAX_CANDIDATES 16
+
+/* Shorthands of the layout */
+#define WORDS GOENGC_BITFIELD_WORDS
+#define WORD_BITS GOENGC_BITFIELD_WORD_BITS
+
+/* Position of a reading as point sets in the bitfield layout. The sets are
+ * plain words without active areas: a node copies the state to play a move,
+ * so taking the move back costs nothing and the board is never touched. */
+typedef struct {
+    uint64_t defender[WORDS];  /* Stones of the defending color */
+    uint64_t attacker[WORDS];  /* Stones of the attacking color */
+    uint64_t empty[WORDS];     /* Empty on-board points */
+    uint64_t chain[WORDS];     /* Stones of the defending chain */
+    uint64_t liberties[WORDS]; /* Liberties of the defending chain */
+    uint16_t ko_index;         /* Point the side to move may not retake */
+} GoengcLadderState;
+
+/* State shared by the nodes of one reading */
+typedef struct {
+    uint32_t nodes;
+    uint32_t max_nodes;
+    uint64_t placed[WORDS]; /* Stones played on the current line */
+} GoengcLadderSearch;
+
+static GoengcLadderStatus goengc_ladder_attack(
+    GoengcLadderSearch* restrict search,
+    const GoengcLadderState* restrict state, uint16_t depth, uint16_t* move,
+    uint16_t* breaker);
+
+static inline int goengc_ladder_get(const uint64_t* points, uint16_t index) {
+    return (int)((points[index / WORD_BITS] >> (index % WORD_BITS)) & 1);
+}
+
+static inline void goengc_ladder_set(uint64_t* points, uint16_t index) {
+    points[index / WORD_BITS] |= (uint64_t)1 << (index % WORD_BITS);
+}
+
+static inline void goengc_ladder_clear(uint64_t* points, uint16_t index) {
+    points[index / WORD_BITS] &= ~((uint64_t)1 << (index % WORD_BITS));
+}
+
+/* Count the points of a set */
+static inline uint16_t goengc_ladder_count(const uint64_t* points) {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < WORDS; i++) {
+        count += goengc_popcount64(points[i]);
+    }
+    return count;
+}
+
+/* Find the first point of a set at or after an index;
+ * GOENGC_DATA_SIZE_SQUARED if there is none */
+static inline uint16_t goengc_ladder_find(const uint64_t* points,
+                                          uint16_t index) {
+    uint16_t i = index / WORD_BITS;
+    if (i >= WORDS) {
+        return GOENGC_DATA_SIZE_SQUARED;
+    }
+    uint64_t word = points[i] & (~(uint64_t)0 << (index % WORD_BITS));
+    while (word == 0) {
+        if (++i == WORDS) {
+            return GOENGC_DATA_SIZE_SQUARED;
+        }
+        word = points[i];
+    }
+    return (uint16_t)(i * WORD_BITS + goengc_ctz64(word));
+}
+
+/* Count the neighbors of a point in a set */
+static inline int goengc_ladder_touches(const uint64_t* points,
+                                        uint16_t index) {
+    int count = 0;
+    for (int n = 0; n < 4; n++) {
+        count += goengc_ladder_get(points, index + GOENGC_NEIGHBOR_4[n]);
+    }
+    return count;
+}
+
+/* Check if a point is next to a stone outside a chain */
+static inline int goengc_ladder_touches_other(const uint64_t* stones,
+                                              const uint64_t* chain,
+                                              uint16_t index) {
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        if (goengc_ladder_get(stones, neighbor) &&
+            !goengc_ladder_get(chain, neighbor)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Points of a mask next to a point set, as goengc_bitfield_neighbors;
+ * returns their count */
+static inline uint16_t goengc_ladder_neighbors(const uint64_t* restrict src,
+                                               const uint64_t* restrict mask,
+                                               uint64_t* restrict dst) {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < WORDS; i++) {
+        uint64_t word = src[i];
+        uint64_t prev = i > 0 ? src[i - 1] : 0;
+        uint64_t next = i + 1 < WORDS ? src[i + 1] : 0;
+        dst[i] = ((word << 1) | (prev >> (WORD_BITS - 1)) | (word >> 1) |
+                  (next << (WORD_BITS - 1)) | (word << GOENGC_DATA_SIZE) |
+                  (prev >> (WORD_BITS - GOENGC_DATA_SIZE)) |
+                  (word >> GOENGC_DATA_SIZE) |
+                  (next << (WORD_BITS - GOENGC_DATA_SIZE))) &
+                 mask[i];
+        count += goengc_popcount64(dst[i]);
+    }
+    return count;
+}
+
+/* Grow a region to every point of a mask connected to it, with the word
+ * sweeps of goengc_flood_fill_region. Sweeps cover the words the region
+ * reaches and one more on each side, as chains are mostly small. */
+static void goengc_ladder_fill(const uint64_t* restrict mask,
+                               uint64_t* restrict region) {
+    int16_t first = 0;
+    while (first < WORDS && region[first] == 0) {
+        first++;
+    }
+    if (first == WORDS) {
+        return;
+    }
+    int16_t last = WORDS - 1;
+    while (region[last] == 0) {
+        last--;
+    }
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        int16_t begin = first > 0 ? first - 1 : 0;
+        int16_t end = last + 1 < WORDS ? last + 1 : WORDS - 1;
+        for (int16_t i = begin; i <= end; i++) {
+            uint64_t prev = i > 0 ? region[i - 1] : 0;
+            uint64_t next = i + 1 < WORDS ? region[i + 1] : 0;
+            uint64_t grown =
+                region[i] | (((prev >> (WORD_BITS - 1)) |
+                              (next << (WORD_BITS - 1)) |
+                              (prev >> (WORD_BITS - GOENGC_DATA_SIZE)) |
+                              (next << (WORD_BITS - GOENGC_DATA_SIZE))) &
+                             mask[i]);
+            uint64_t previous;
+            do {
+                previous = grown;
+                grown |= ((grown << 1) | (grown >> 1) |
+                          (grown << GOENGC_DATA_SIZE) |
+                          (grown >> GOENGC_DATA_SIZE)) &
+                         mask[i];
+            } while (grown != previous);
+            if (grown != region[i]) {
+                region[i] = grown;
+                changed = 1;
+                first = i < first ? i : first;
+                last = i > last ? i : last;
+            }
+        }
+    }
+}
+
+/* The chain of a stone among a color's stones. Most stones next to a
+ * ladder stand alone and need no fill. */
+static inline void goengc_ladder_chain_of(const uint64_t* restrict stones,
+                                          uint16_t index,
+                                          uint64_t* restrict chain) {
+    memset(chain, 0, WORDS * sizeof(uint64_t));
+    goengc_ladder_set(chain, index);
+    if (goengc_ladder_touches(stones, index)) {
+        goengc_ladder_fill(stones, chain);
+    }
+}
+
+/**
+ * Play a move on a copy of a state, following the board's rules: captures,
+ * no suicide and simple ko. The move must not fill the last liberty of the
+ * defending chain.
+ * @param state The state before the move
+ * @param defender Whether the defender plays (else the attacker)
+ * @param index The point to play, which must be empty
+ * @param next The state after the move (output)
+ * @return 1 if the move is legal, 0 otherwise (next is then undefined)
+ */
+static int goengc_ladder_play(const GoengcLadderState* restrict state,
+                              int defender, uint16_t index,
+                              GoengcLadderState* restrict next) {
+    assert(goengc_ladder_get(state->empty, index));
+
+    if (index == state->ko_index) {
+        return 0;
+    }
+    *next = *state;
+    uint64_t* own = defender ? next->defender : next->attacker;
+    uint64_t* opponent = defender ? next->attacker : next->defender;
+    goengc_ladder_set(own, index);
+    goengc_ladder_clear(next->empty, index);
+    goengc_ladder_clear(next->liberties, index);
+
+    /* Remove the opponent chains left without liberties. A stone next to
+     * an empty point needs no fill, and the defending chain keeps its
+     * liberties in the state. */
+    uint16_t num_captured = 0;
+    uint16_t captured_index = GOENGC_NO_KO;
+    uint64_t chain[WORDS], liberties[WORDS];
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        if (!goengc_ladder_get(opponent, neighbor) ||
+            goengc_ladder_touches(next->empty, neighbor)) {
+            continue;
+        }
+        if (goengc_ladder_get(state->chain, neighbor)) {
+            assert(goengc_ladder_count(next->liberties) > 0);
+            continue;
+        }
+        goengc_ladder_chain_of(opponent, neighbor, chain);
+        if (goengc_ladder_neighbors(chain, next->empty, liberties) == 0) {
+            for (uint16_t i = 0; i < WORDS; i++) {
+                opponent[i] &= ~chain[i];
+                next->empty[i] |= chain[i];
+            }
+            num_captured += goengc_ladder_count(chain);
+            captured_index = neighbor;
+        }
+    }
+
+    /* A defender stone next to the chain joins it, with any other chain it
+     * touches; without liberties it would be suicide. A chain of more than
+     * one stone cannot retake a ko. */
+    next->ko_index = GOENGC_NO_KO;
+    int joins = defender && goengc_ladder_touches(state->chain, index);
+    if (joins) {
+        goengc_ladder_set(next->chain, index);
+        if (goengc_ladder_touches_other(own, next->chain, index)) {
+            goengc_ladder_fill(own, next->chain);
+        }
+        return goengc_ladder_neighbors(next->chain, next->empty,
+                                       next->liberties) > 0;
+    }
+    if (num_captured > 0) {
+        goengc_ladder_neighbors(next->chain, next->empty, next->liberties);
+    }
+
+    /* Otherwise the chain of the new stone is only needed for suicide and
+     * ko */
+    if (num_captured == 0 && goengc_ladder_touches(next->empty, index)) {
+        return 1;
+    }
+    memset(chain, 0, sizeof(chain));
+    goengc_ladder_set(chain, index);
+    if (goengc_ladder_touches_other(own, chain, index)) {
+        goengc_ladder_fill(own, chain);
+    }
+    uint16_t count = goengc_ladder_neighbors(chain, next->empty, liberties);
+    if (count == 0) {
+        return 0;
+    }
+    if (num_captured == 1 && count == 1 && goengc_ladder_count(chain) == 1) {
+        next->ko_index = captured_index;
+    }
+    return 1;
+}
+
+/* Check the limits before playing a move */
+static int goengc_ladder_exhausted(const GoengcLadderSearch* search,
+                                   uint16_t depth) {
+    return search->nodes >= search->max_nodes ||
+           depth >= GOENGC_LADDER_MAX_DEPTH;
+}
+
+/* Collect the defender's moves: the extension at the last liberty and the
+ * capture of every adjacent attacker chain in atari */
+static uint8_t goengc_ladder_defender_moves(
+    const GoengcLadderState* restrict state,
+    uint16_t moves[GOENGC_LADDER_MAX_CANDIDATES]) {
+    uint8_t count = 0;
+    moves[count++] = goengc_ladder_find(state->liberties, 0);
+
+    uint64_t adjacent[WORDS], seen[WORDS], chain[WORDS], liberties[WORDS];
+    goengc_ladder_neighbors(state->chain, state->attacker, adjacent);
+    memset(seen, 0, sizeof(seen));
+    for (uint16_t stone = goengc_ladder_find(adjacent, 0);
+         stone < GOENGC_DATA_SIZE_SQUARED &&
+         count < GOENGC_LADDER_MAX_CANDIDATES;
+         stone = goengc_ladder_find(adjacent, stone + 1)) {
+        /* A stone with 2 empty neighbors is not in atari */
+        if (goengc_ladder_get(seen, stone) ||
+            goengc_ladder_touches(state->empty, stone) >= 2) {
+            continue;
+        }
+        goengc_ladder_chain_of(state->attacker, stone, chain);
+        for (uint16_t i = 0; i < WORDS; i++) {
+            seen[i] |= chain[i];
+        }
+        if (goengc_ladder_neighbors(chain, state->empty, liberties) != 1) {
+            continue;
+        }
+        uint16_t point = goengc_ladder_find(liberties, 0);
+        int known = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            known |= moves[i] == point;
+        }
+        if (!known) {
+            moves[count++] = point;
+        }
+    }
+    return count;
+}
+
+/* Find the stone that breaks the ladder when a defender move at a point
+ * escapes: a defender stone of another chain next to it, or a stone of an
+ * adjacent attacker chain in atari that the reading did not play */
+static uint16_t goengc_ladder_find_breaker(
+    const GoengcLadderSearch* restrict search,
+    const GoengcLadderState* restrict state, uint16_t index) {
+    uint64_t chain[WORDS], liberties[WORDS];
+    for (int n = 0; n < 4; n++) {
+        uint16_t neighbor = index + GOENGC_NEIGHBOR_4[n];
+        if (goengc_ladder_get(state->defender, neighbor) &&
+            !goengc_ladder_get(state->chain, neighbor) &&
+            !goengc_ladder_get(search->placed, neighbor)) {
+            return neighbor;
+        }
+        if (goengc_ladder_get(state->attacker, neighbor)) {
+            goengc_ladder_chain_of(state->attacker, neighbor, chain);
+            if (goengc_ladder_neighbors(chain, state->empty, liberties) == 1) {
+                for (uint16_t i = 0; i < WORDS; i++) {
+                    chain[i] &= ~search->placed[i];
+                }
+                uint16_t stone = goengc_ladder_find(chain, 0);
+                if (stone < GOENGC_DATA_SIZE_SQUARED) {
+                    return stone;
+                }
+            }
+        }
+    }
+    return GOENGC_LADDER_NO_POINT;
+}
+
+/* Defender to move with the chain in atari. On an escape, move is the
+ * escape and breaker the breaker of its line. */
+static GoengcLadderStatus goengc_ladder_defend(
+    GoengcLadderSearch* restrict search,
+    const GoengcLadderState* restrict state, uint16_t depth, uint16_t* move,
+    uint16_t* breaker) {
+    uint16_t moves[GOENGC_LADDER_MAX_CANDIDATES];
+    uint8_t count = goengc_ladder_defender_moves(state, moves);
+
+    GoengcLadderStatus status = GOENGC_LADDER_CAPTURED;
+    for (uint8_t i = 0; i < count; i++) {
+        GoengcLadderState next;
+        if (!goengc_ladder_play(state, 1, moves[i], &next)) {
+            continue;
+        }
+        if (goengc_ladder_exhausted(search, depth)) {
+            return GOENGC_LADDER_UNKNOWN;
+        }
+        search->nodes++;
+
+        uint16_t liberties = goengc_ladder_count(next.liberties);
+        uint16_t line_breaker = GOENGC_LADDER_NO_POINT;
+        GoengcLadderStatus outcome;
+        if (liberties >= 3) {
+            line_breaker = goengc_ladder_find_breaker(search, state, moves[i]);
+            outcome = GOENGC_LADDER_ESCAPED;
+        } else if (liberties == 2) {
+            uint16_t reply;
+            goengc_ladder_set(search->placed, moves[i]);
+            outcome = goengc_ladder_attack(search, &next, depth + 1, &reply,
+                                           &line_breaker);
+            goengc_ladder_clear(search->placed, moves[i]);
+        } else {
+            outcome = GOENGC_LADDER_CAPTURED;
+        }
+
+        if (outcome == GOENGC_LADDER_ESCAPED) {
+            *move = moves[i];
+            *breaker = line_breaker;
+            return GOENGC_LADDER_ESCAPED;
+        }
+        if (outcome == GOENGC_LADDER_UNKNOWN) {
+            status = GOENGC_LADDER_UNKNOWN;
+        }
+    }
+    return status;
+}
+
+/* Attacker to move with the chain at 2 liberties: an atari on either
+ * liberty. On a capture, move is the capturing atari. On an escape, breaker
+ * is the first breaker found on the lines, as an atari from the wrong side
+ * usually escapes into open space. */
+static GoengcLadderStatus goengc_ladder_attack(
+    GoengcLadderSearch* restrict search,
+    const GoengcLadderState* restrict state, uint16_t depth, uint16_t* move,
+    uint16_t* breaker) {
+    uint16_t points[2];
+    points[0] = goengc_ladder_find(state->liberties, 0);
+    points[1] = goengc_ladder_find(state->liberties, points[0] + 1);
+
+    GoengcLadderStatus status = GOENGC_LADDER_ESCAPED;
+    *breaker = GOENGC_LADDER_NO_POINT;
+    for (int i = 0; i < 2; i++) {
+        GoengcLadderState next;
+        if (!goengc_ladder_play(state, 0, points[i], &next)) {
+            continue;
+        }
+        if (goengc_ladder_exhausted(search, depth)) {
+            return GOENGC_LADDER_UNKNOWN;
+        }
+        search->nodes++;
+
+        GoengcLadderStatus outcome;
+        uint16_t line_breaker = GOENGC_LADDER_NO_POINT;
+        if (goengc_ladder_count(next.liberties) == 1) {
+            uint16_t reply;
+            goengc_ladder_set(search->placed, points[i]);
+            outcome = goengc_ladder_defend(search, &next, depth + 1, &reply,
+                                           &line_breaker);
+            goengc_ladder_clear(search->placed, points[i]);
+        } else {
+            /* The atari captured defender stones next to the chain */
+            outcome = GOENGC_LADDER_ESCAPED;
+        }
+
+        if (outcome == GOENGC_LADDER_CAPTURED) {
+            *move = points[i];
+            return GOENGC_LADDER_CAPTURED;
+        }
+        if (outcome == GOENGC_LADDER_UNKNOWN) {
+            status = GOENGC_LADDER_UNKNOWN;
+        } else if (*breaker == GOENGC_LADDER_NO_POINT) {
+            *breaker = line_breaker;
+        }
+    }
+    return status;
+}
+
+void goengc_ladder_read(const GoengcBoard* restrict board, uint16_t index,
+                        uint32_t max_nodes,
+                        GoengcLadderResult* restrict result) {
+    assert(board != NULL);
+    assert(result != NULL);
+    assert(index < GOENGC_DATA_SIZE_SQUARED);
+
+    result->status = GOENGC_LADDER_NONE;
+    result->move = GOENGC_LADDER_NO_POINT;
+    result->breaker = GOENGC_LADDER_NO_POINT;
+    result->nodes = 0;
+    if (goengc_board_get_chain(board, index) == GOENGC_NO_CHAIN) {
+        return;
+    }
+    uint16_t liberties = goengc_board_get_liberties(board, index);
+    if (liberties > 2) {
+        return;
+    }
+
+    GoengcColor defender =
+        goengc_colorfield_get_color(&board->color_field, index);
+    GoengcColor to_move =
+        liberties == 1 ? defender : goengc_color_opposite(defender);
+    GoengcColorMasks masks;
+    goengc_colorfield_get_masks(&board->color_field, &masks);
+    GoengcBitfield chain, chain_liberties;
+    goengc_board_get_chain_stones(board, index, &chain);
+    goengc_board_get_chain_liberties(board, index, &chain_liberties);
+
+    GoengcLadderState state;
+    memcpy(state.defender,
+           defender == GOENGC_COLOR_BLACK ? masks.black.words
+                                          : masks.white.words,
+           sizeof(state.defender));
+    memcpy(state.attacker,
+           defender == GOENGC_COLOR_BLACK ? masks.white.words
+                                          : masks.black.words,
+           sizeof(state.attacker));
+    memcpy(state.empty, masks.empty.words, sizeof(state.empty));
+    memcpy(state.chain, chain.words, sizeof(state.chain));
+    memcpy(state.liberties, chain_liberties.words, sizeof(state.liberties));
+    state.ko_index =
+        board->ko_color == to_move ? board->ko_index : GOENGC_NO_KO;
+
+    GoengcLadderSearch search;
+    search.nodes = 0;
+    search.max_nodes = max_nodes;
+    memset(search.placed, 0, sizeof(search.placed));
+
+    uint16_t move = GOENGC_LADDER_NO_POINT;
+    uint16_t breaker = GOENGC_LADDER_NO_POINT;
+    result->status =
+        liberties == 1
+            ? goengc_ladder_defend(&search, &state, 0, &move, &breaker)
+            : goengc_ladder_attack(&search, &state, 0, &move, &breaker);
+    result->nodes = search.nodes;
+
+    /* Only the move that decides in the reader's favor is reported */
+    if ((liberties == 1 && result->status == GOENGC_LADDER_ESCAPED) ||
+        (liberties == 2 && result->status == GOENGC_LADDER_CAPTURED)) {
+        result->move = move;
+    }
+    if (result->status == GOENGC_LADDER_ESCAPED) {
+        result->breaker = breaker;
+    }
+}
+
+void goengc_ladder_read_all(const GoengcBoard* restrict board,
+                            uint32_t max_nodes,
+                            GoengcLadderFeatures* restrict features) {
+    assert(board != NULL);
+    assert(features != NULL);
+
+    goengc_bitfield_clear(&features->captured);
+    goengc_bitfield_clear(&features->escaped);
+    goengc_bitfield_clear(&features->unknown);
+    goengc_bitfield_clear(&features->moves);
+    goengc_bitfield_clear(&features->breakers);
+    features->nodes = 0;
+
+    /* Chains already read, as their stones */
+    GoengcBitfield done;
+    goengc_bitfield_clear(&done);
+    const GoengcBitfield* stones = &board->color_field.occupied_bits;
+    for (uint16_t index = goengc_bitfield_find_first(stones);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(stones, index + 1)) {
+        if (goengc_bitfield_get_bit(&done, index) ||
+            goengc_board_get_liberties(board, index) > 2) {
+            continue;
+        }
+
+        GoengcBitfield chain;
+        goengc_board_get_chain_stones(board, index, &chain);
+        goengc_bitfield_or(&done, &done, &chain);
+
+        GoengcLadderResult result;
+        goengc_ladder_read(board, index, max_nodes, &result);
+        features->nodes += result.nodes;
+        GoengcBitfield* target =
+            result.status == GOENGC_LADDER_CAPTURED  ? &features->captured
+            : result.status == GOENGC_LADDER_ESCAPED ? &features->escaped
+                                                     : &features->unknown;
+        goengc_bitfield_or(target, target, &chain);
+        if (result.move != GOENGC_LADDER_NO_POINT) {
+            goengc_bitfield_set_bit(&features->moves, result.move);
+        }
+        if (result.breaker != GOENGC_LADDER_NO_POINT) {
+            goengc_bitfield_set_bit(&features->breakers, result.breaker);
+        }
+    }
+}
@@ -0,0 +1,369 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/mcts.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/playout.h"
+#include "goengc/random.h"
+#include "goengc/scoring.h"
+#include "workers.h"
+
+/* Longest path from the root; deeper leaves are evaluated, not expanded.
+ * Bounds the path of games that cycle through kos. */
+#define GOENGC_MCTS_MAX_DEPTH (2 * GOENGC_DATA_SIZE_SQUARED)
+
+/* Per-thread state of a search */
+typedef struct {
+    _Alignas(GOENGC_CACHE_LINE) GoengcBoard board;
+    GoengcWorkspace workspace;
+    GoengcRng rng;
+    uint32_t path[GOENGC_MCTS_MAX_DEPTH];
+} GoengcMctsWorker;
+
+/* Shared job description */
+typedef struct {
+    GoengcMcts* mcts;
+    uint32_t num_visits;
+    _Atomic uint32_t next_visit;
+    GoengcMctsWorker* workers;
+} GoengcMctsJob;
+
+static void goengc_mcts_init_node(GoengcMctsNode* restrict node,
+                                  uint16_t move) {
+    atomic_init(&node->value, 0);
+    atomic_init(&node->visits, 0);
+    node->first_child = 0;
+    node->num_children = 0;
+    node->move = move;
+    atomic_init(&node->state, GOENGC_MCTS_LEAF);
+}
+
+static GoengcMove goengc_mcts_to_move(uint16_t move, GoengcColor color) {
+    return move == GOENGC_MCTS_PASS
+               ? goengc_move_create(color, 1, goengc_vec2_create(0, 0))
+               : goengc_move_create(color, 0, goengc_index_to_coord(move));
+}
+
+int goengc_mcts_init(GoengcMcts* restrict mcts, const GoengcBoard* root,
+                     GoengcColor to_move, size_t size_mb, uint64_t seed) {
+    assert(mcts != NULL);
+    assert(root != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+    assert(size_mb > 0);
+
+    uint64_t capacity = ((uint64_t)size_mb << 20) / sizeof(GoengcMctsNode);
+    if (capacity > UINT32_MAX) {
+        capacity = UINT32_MAX;
+    }
+    mcts->nodes = malloc(capacity * sizeof(GoengcMctsNode));
+    if (mcts->nodes == NULL) {
+        return -1;
+    }
+    mcts->capacity = (uint32_t)capacity;
+
+    memcpy(&mcts->root_board, root, sizeof(mcts->root_board));
+    mcts->root_to_move = to_move;
+    mcts->root_passes = 0;
+    mcts->evaluate = goengc_mcts_evaluate_playout;
+    mcts->user = NULL;
+    mcts->exploration = 1.0f;
+    mcts->seed = seed;
+
+    goengc_mcts_init_node(&mcts->nodes[GOENGC_MCTS_ROOT], GOENGC_MCTS_PASS);
+    atomic_init(&mcts->num_nodes, 1);
+    return 0;
+}
+
+void goengc_mcts_free(GoengcMcts* restrict mcts) {
+    assert(mcts != NULL);
+
+    free(mcts->nodes);
+    mcts->nodes = NULL;
+    mcts->capacity = 0;
+}
+
+void goengc_mcts_set_evaluator(GoengcMcts* restrict mcts,
+                               GoengcMctsEvaluator evaluate, void* user) {
+    assert(mcts != NULL);
+    assert(evaluate != NULL);
+
+    mcts->evaluate = evaluate;
+    mcts->user = user;
+}
+
+float goengc_mcts_evaluate_playout(GoengcBoard* restrict board,
+                                   GoengcWorkspace* restrict workspace,
+                                   GoengcColor to_move, GoengcRng* restrict rng,
+                                   void* user) {
+    (void)user;
+    GoengcPlayoutResult playout =
+        goengc_playout_run(board, workspace, to_move, rng);
+    return playout.score2 > 0 ? 1.0f : playout.score2 < 0 ? 0.0f : 0.5f;
+}
+
+/* Create the children of a leaf. Returns 0 if another thread expands it or
+ * the arena is full; the node is then evaluated as a leaf. */
+static int goengc_mcts_expand(GoengcMcts* restrict mcts,
+                              GoengcMctsNode* restrict node,
+                              const GoengcBoard* restrict board,
+                              GoengcColor to_move,
+                              GoengcWorkspace* restrict workspace) {
+    if (atomic_load_explicit(&mcts->num_nodes, memory_order_relaxed) >=
+        mcts->capacity) {
+        return 0;
+    }
+    uint8_t expected = GOENGC_MCTS_LEAF;
+    if (!atomic_compare_exchange_strong_explicit(
+            &node->state, &expected, GOENGC_MCTS_EXPANDING,
+            memory_order_acquire, memory_order_relaxed)) {
+        return 0;
+    }
+
+    /* Legal moves that do not fill an own eye, plus a pass */
+    GoengcBitfield* legal = &workspace->scratch1;
+    goengc_board_get_legal_moves(board, to_move, legal);
+    for (uint16_t index = goengc_bitfield_find_first(legal);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(legal, index + 1)) {
+        if (goengc_board_is_eye(board, index, to_move)) {
+            goengc_bitfield_clear_bit(legal, index);
+        }
+    }
+    uint32_t num_children = goengc_bitfield_count_bits(legal) + 1u;
+
+    uint32_t first = atomic_fetch_add_explicit(&mcts->num_nodes, num_children,
+                                               memory_order_relaxed);
+    if (first > mcts->capacity || num_children > mcts->capacity - first) {
+        /* The arena is full; the count stays past capacity so later
+         * expansions fail at the first check */
+        atomic_store_explicit(&node->state, GOENGC_MCTS_LEAF,
+                              memory_order_relaxed);
+        return 0;
+    }
+
+    GoengcMctsNode* child = &mcts->nodes[first];
+    goengc_mcts_init_node(child++, GOENGC_MCTS_PASS);
+    for (uint16_t index = goengc_bitfield_find_first(legal);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(legal, index + 1)) {
+        goengc_mcts_init_node(child++, index);
+    }
+    node->first_child = first;
+    node->num_children = (uint16_t)num_children;
+
+    /* Publish the children to threads that load the state with acquire */
+    atomic_store_explicit(&node->state, GOENGC_MCTS_EXPANDED,
+                          memory_order_release);
+    return 1;
+}
+
+/* Pick the child with the best UCT score; unvisited children come first */
+static uint32_t goengc_mcts_select(const GoengcMcts* restrict mcts,
+                                   GoengcMctsNode* restrict node) {
+    uint32_t parent_visits =
+        atomic_load_explicit(&node->visits, memory_order_relaxed);
+    float log_parent = logf((float)(parent_visits > 0 ? parent_visits : 1));
+    uint32_t best = node->first_child;
+    float best_score = -INFINITY;
+
+    for (uint32_t i = node->first_child;
+         i < node->first_child + node->num_children; i++) {
+        GoengcMctsNode* child = &mcts->nodes[i];
+        uint32_t visits =
+            atomic_load_explicit(&child->visits, memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        uint64_t value =
+            atomic_load_explicit(&child->value, memory_order_relaxed);
+        float q = (float)value / ((float)GOENGC_MCTS_VALUE_ONE * visits);
+        float score = q + mcts->exploration * sqrtf(log_parent / visits);
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+/* One visit: descend to a leaf, expand it, evaluate and back up */
+static void goengc_mcts_visit(GoengcMcts* restrict mcts,
+                              GoengcMctsWorker* restrict worker) {
+    GoengcBoard* board = &worker->board;
+    memcpy(board, &mcts->root_board, sizeof(*board));
+    GoengcColor to_move = mcts->root_to_move;
+    uint8_t passes = mcts->root_passes;
+
+    /* Visits are counted on the way down: this is the virtual loss */
+    uint32_t node_index = GOENGC_MCTS_ROOT;
+    uint32_t depth = 0;
+    worker->path[depth++] = node_index;
+    atomic_fetch_add_explicit(&mcts->nodes[node_index].visits, 1,
+                              memory_order_relaxed);
+
+    float black_wins;
+    int expanded = 0;
+    for (;;) {
+        if (passes >= 2) {
+            GoengcScore score =
+                goengc_score(board, NULL, &worker->workspace.scratch1,
+                             &worker->workspace.scratch2);
+            black_wins = score.score2 > 0 ? 1.0f : score.score2 < 0 ? 0.0f : 0.5f;
+            break;
+        }
+
+        GoengcMctsNode* node = &mcts->nodes[node_index];
+        uint8_t state = atomic_load_explicit(&node->state, memory_order_acquire);
+        if (state == GOENGC_MCTS_LEAF && !expanded &&
+            depth < GOENGC_MCTS_MAX_DEPTH) {
+            expanded = goengc_mcts_expand(mcts, node, board, to_move,
+                                          &worker->workspace);
+            if (expanded) {
+                state = GOENGC_MCTS_EXPANDED;
+            }
+        }
+        if (state != GOENGC_MCTS_EXPANDED) {
+            black_wins = mcts->evaluate(board, &worker->workspace, to_move,
+                                        &worker->rng, mcts->user);
+            break;
+        }
+
+        node_index = goengc_mcts_select(mcts, node);
+        worker->path[depth++] = node_index;
+        atomic_fetch_add_explicit(&mcts->nodes[node_index].visits, 1,
+                                  memory_order_relaxed);
+
+        uint16_t move = mcts->nodes[node_index].move;
+        goengc_board_play(board, goengc_mcts_to_move(move, to_move));
+        passes = move == GOENGC_MCTS_PASS ? passes + 1 : 0;
+        to_move = goengc_color_opposite(to_move);
+    }
+
+    /* Credit every node to the player who moved into it, who alternates
+     * starting from the opponent of the side to move at the root */
+    uint64_t black_value =
+        (uint64_t)(black_wins * GOENGC_MCTS_VALUE_ONE + 0.5f);
+    uint64_t white_value = GOENGC_MCTS_VALUE_ONE - black_value;
+    int black_moved_first = mcts->root_to_move == GOENGC_COLOR_WHITE;
+    for (uint32_t d = 0; d < depth; d++) {
+        int black_moved = (d & 1) ? !black_moved_first : black_moved_first;
+        atomic_fetch_add_explicit(&mcts->nodes[worker->path[d]].value,
+                                  black_moved ? black_value : white_value,
+                                  memory_order_relaxed);
+    }
+}
+
+/* Worker: claim visits from the shared budget until it runs out */
+static void goengc_mcts_worker(void* context, uint16_t id) {
+    GoengcMctsJob* job = context;
+    GoengcMctsWorker* worker = &job->workers[id];
+
+    while (atomic_fetch_add_explicit(&job->next_visit, 1,
+                                     memory_order_relaxed) < job->num_visits) {
+        goengc_mcts_visit(job->mcts, worker);
+    }
+}
+
+uint16_t goengc_mcts_search(GoengcMcts* restrict mcts, uint32_t num_visits,
+                            uint16_t num_threads) {
+    assert(mcts != NULL && mcts->nodes != NULL);
+    assert(num_threads > 0);
+
+    if (num_threads > GOENGC_MCTS_MAX_THREADS) {
+        num_threads = GOENGC_MCTS_MAX_THREADS;
+    }
+    GoengcMctsWorker* workers = aligned_alloc(
+        GOENGC_CACHE_LINE, (size_t)num_threads * sizeof(GoengcMctsWorker));
+    if (workers == NULL) {
+        return 0;
+    }
+
+    /* Streams differ per thread and per search call */
+    uint64_t root_visits = atomic_load_explicit(
+        &mcts->nodes[GOENGC_MCTS_ROOT].visits, memory_order_relaxed);
+    GoengcMctsJob job = {.mcts = mcts, .num_visits = num_visits,
+                         .workers = workers};
+    atomic_init(&job.next_visit, 0);
+    for (uint16_t i = 0; i < num_threads; i++) {
+        goengc_rng_seed(&workers[i].rng,
+                        mcts->seed ^ ((uint64_t)i << 48) ^ root_visits);
+    }
+
+    /* The visit budget is shared, so the threads that start use all of it */
+    uint16_t started =
+        goengc_workers_run(goengc_mcts_worker, &job, num_threads);
+
+    free(workers);
+    return started;
+}
+
+GoengcMove goengc_mcts_get_best_move(const GoengcMcts* restrict mcts) {
+    assert(mcts != NULL && mcts->nodes != NULL);
+
+    /* Casting away const is fine: the loads do not modify the node */
+    GoengcMctsNode* root = (GoengcMctsNode*)&mcts->nodes[GOENGC_MCTS_ROOT];
+    uint16_t best_move = GOENGC_MCTS_PASS;
+    if (atomic_load_explicit(&root->state, memory_order_acquire) ==
+        GOENGC_MCTS_EXPANDED) {
+        uint32_t best_visits = 0;
+        for (uint32_t i = root->first_child;
+             i < root->first_child + root->num_children; i++) {
+            GoengcMctsNode* child = (GoengcMctsNode*)&mcts->nodes[i];
+            uint32_t visits =
+                atomic_load_explicit(&child->visits, memory_order_relaxed);
+            if (visits > best_visits) {
+                best_move = child->move;
+                best_visits = visits;
+            }
+        }
+    }
+    return goengc_mcts_to_move(best_move, mcts->root_to_move);
+}
+
+void goengc_mcts_advance(GoengcMcts* restrict mcts, GoengcMove move) {
+    assert(mcts != NULL && mcts->nodes != NULL);
+    assert(move.color == mcts->root_to_move);
+
+    goengc_board_play(&mcts->root_board, move);
+    mcts->root_passes = move.is_pass ? mcts->root_passes + 1 : 0;
+    mcts->root_to_move = goengc_color_opposite(mcts->root_to_move);
+
+    /* Every node above the new root is garbage; start over at the front */
+    goengc_mcts_init_node(&mcts->nodes[GOENGC_MCTS_ROOT], GOENGC_MCTS_PASS);
+    atomic_store_explicit(&mcts->num_nodes, 1, memory_order_relaxed);
+}
+
+void goengc_mcts_get_stats(const GoengcMcts* restrict mcts,
+                           GoengcMctsStats* restrict stats) {
+    assert(mcts != NULL && mcts->nodes != NULL);
+    assert(stats != NULL);
+
+    GoengcMctsNode* root = (GoengcMctsNode*)&mcts->nodes[GOENGC_MCTS_ROOT];
+    uint32_t num_nodes = atomic_load_explicit(
+        &((GoengcMcts*)mcts)->num_nodes, memory_order_relaxed);
+    if (num_nodes > mcts->capacity) {
+        num_nodes = mcts->capacity;
+    }
+    stats->num_nodes = num_nodes;
+    stats->capacity = mcts->capacity;
+    stats->bytes_used = (size_t)num_nodes * sizeof(GoengcMctsNode);
+    stats->bytes_total = (size_t)mcts->capacity * sizeof(GoengcMctsNode);
+    stats->root_visits =
+        atomic_load_explicit(&root->visits, memory_order_relaxed);
+
+    /* The root's value is credited to the player who moved into it */
+    uint64_t value = atomic_load_explicit(&root->value, memory_order_relaxed);
+    stats->root_value =
+        stats->root_visits > 0
+            ? 1.0f - (float)value /
+                         ((float)GOENGC_MCTS_VALUE_ONE * stats->root_visits)
+            : 0.5f;
+}
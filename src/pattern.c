@@ -0,0 +1,165 @@
+#include "goengc/pattern.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/random.h"
+#include "goengc/symmetry.h"
+#include "goengc/types.h"
+
+/* Offsets of the neighbors of GOENGC_NEIGHBOR_8 */
+static const int8_t goengc_pattern_dx[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+static const int8_t goengc_pattern_dy[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+
+/* Neighbor at offset (dx, dy), indexed by (dy + 1) * 3 + dx + 1 */
+static const int8_t goengc_pattern_neighbor_at[9] = {4, 0, 7, 1, -1,
+                                                     3, 5, 2, 6};
+
+uint16_t goengc_pattern_transform(uint16_t pattern, GoengcSymmetry symmetry) {
+    uint16_t transformed = 0;
+    for (int k = 0; k < 8; k++) {
+        int dx = goengc_pattern_dx[k];
+        int dy = goengc_pattern_dy[k];
+        if (symmetry & GOENGC_SYMMETRY_TRANSPOSE_BIT) {
+            int swap = dx;
+            dx = dy;
+            dy = swap;
+        }
+        if (symmetry & GOENGC_SYMMETRY_FLIP_X_BIT) {
+            dx = -dx;
+        }
+        if (symmetry & GOENGC_SYMMETRY_FLIP_Y_BIT) {
+            dy = -dy;
+        }
+        int target = goengc_pattern_neighbor_at[(dy + 1) * 3 + dx + 1];
+        transformed |=
+            (uint16_t)(goengc_pattern_get_color(pattern, k) << (2 * target));
+    }
+    return transformed;
+}
+
+void goengc_pattern_table_init(GoengcPatternTable* restrict table,
+                               uint16_t weight) {
+    assert(table != NULL);
+
+    for (uint32_t pattern = 0; pattern < GOENGC_PATTERN_COUNT; pattern++) {
+        table->weights[pattern] =
+            goengc_pattern_is_eye((uint16_t)pattern, GOENGC_COLOR_BLACK)
+                ? 0
+                : weight;
+    }
+    table->max_weight = weight;
+}
+
+void goengc_pattern_table_set(GoengcPatternTable* restrict table,
+                              uint16_t pattern, uint16_t weight) {
+    assert(table != NULL);
+
+    table->weights[pattern] = weight;
+    if (weight > table->max_weight) {
+        table->max_weight = weight;
+    }
+}
+
+void goengc_pattern_table_set_symmetric(GoengcPatternTable* restrict table,
+                                        uint16_t pattern, uint16_t weight) {
+    assert(table != NULL);
+
+    for (int s = 0; s < GOENGC_NUM_SYMMETRIES; s++) {
+        goengc_pattern_table_set(
+            table, goengc_pattern_transform(pattern, (GoengcSymmetry)s),
+            weight);
+    }
+}
+
+/* Pick among the legal candidates in proportion to their weights, in one
+ * pass */
+static uint16_t goengc_pattern_pick_exact(
+    const GoengcBoard* restrict board, const GoengcPatternTable* restrict table,
+    GoengcColor color, GoengcBitfield* restrict candidates,
+    GoengcRng* restrict rng) {
+    GoengcBitfield legal;
+    goengc_board_get_legal_moves(board, color, &legal);
+    goengc_bitfield_and(candidates, candidates, &legal);
+
+    uint16_t points[GOENGC_DATA_SIZE_SQUARED];
+    uint32_t totals[GOENGC_DATA_SIZE_SQUARED];
+    uint16_t count = 0;
+    uint32_t total = 0;
+    for (uint16_t index = goengc_bitfield_find_first(candidates);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(candidates, index + 1)) {
+        uint16_t weight = goengc_pattern_table_get(table, board, index, color);
+        if (weight > 0) {
+            total += weight;
+            points[count] = index;
+            totals[count++] = total;
+        }
+    }
+    if (count == 0) {
+        return GOENGC_DATA_SIZE_SQUARED;
+    }
+
+    uint32_t target = goengc_rng_below(rng, total);
+    uint16_t i = 0;
+    while (totals[i] <= target) {
+        i++;
+    }
+    return points[i];
+}
+
+uint16_t goengc_pattern_pick(const GoengcBoard* restrict board,
+                             const GoengcPatternTable* restrict table,
+                             GoengcColor color,
+                             GoengcBitfield* restrict candidates,
+                             GoengcRng* restrict rng) {
+    assert(board != NULL);
+    assert(table != NULL);
+    assert(candidates != NULL);
+    assert(rng != NULL);
+    assert(color == GOENGC_COLOR_BLACK || color == GOENGC_COLOR_WHITE);
+
+    if (table->max_weight == 0) {
+        return GOENGC_DATA_SIZE_SQUARED;
+    }
+
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY,
+                               candidates);
+    uint16_t count = goengc_bitfield_count_bits(candidates);
+    uint16_t rejections = 0;
+
+    /* Draw without replacement over points that can never be picked, and
+     * with replacement over points rejected by their weight */
+    while (count > 0) {
+        if (rejections == GOENGC_PATTERN_MAX_REJECTIONS) {
+            return goengc_pattern_pick_exact(board, table, color, candidates,
+                                             rng);
+        }
+        uint16_t index =
+            goengc_bitfield_select(candidates, goengc_rng_below(rng, count));
+        uint16_t weight = goengc_pattern_table_get(table, board, index, color);
+        if (weight > 0) {
+            /* Full weight needs no draw, so equal weights draw exactly
+             * like goengc_playout_run */
+            if (weight < table->max_weight &&
+                goengc_rng_below(rng, table->max_weight) >= weight) {
+                rejections++;
+                continue;
+            }
+            if (goengc_board_is_legal(board,
+                                      goengc_move_create(
+                                          color, 0,
+                                          goengc_index_to_coord(index)))) {
+                return index;
+            }
+        }
+        goengc_bitfield_clear_bit(candidates, index);
+        count--;
+        rejections = 0;
+    }
+
+    return GOENGC_DATA_SIZE_SQUARED;
+}
@@ -0,0 +1,260 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "goengc/perft.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/color_field.h"
+#include "workers.h"
+
+/* A subtree handed to a thread: the first two moves from the root, as board
+ * indices with GOENGC_PERFT_PASS for a pass */
+typedef struct {
+    uint16_t first;
+    uint16_t second;
+} GoengcPerftItem;
+
+/* Per-thread state of a parallel run */
+typedef struct {
+    _Alignas(GOENGC_CACHE_LINE) GoengcBoard board;
+    GoengcPerftCounts counts;
+    uint64_t divide[GOENGC_DATA_SIZE_SQUARED];
+} GoengcPerftWorker;
+
+/* Shared job description */
+typedef struct {
+    GoengcColor to_move;
+    uint8_t passes;
+    uint8_t depth;
+    const GoengcPerftItem* items;
+    uint32_t num_items;
+    _Atomic uint32_t next_item;
+    GoengcPerftWorker* workers;
+} GoengcPerftJob;
+
+static GoengcMove goengc_perft_move(uint16_t index, GoengcColor color) {
+    return index == GOENGC_PERFT_PASS
+               ? goengc_move_create(color, 1, goengc_vec2_create(0, 0))
+               : goengc_move_create(color, 0, goengc_index_to_coord(index));
+}
+
+/* Get the legal points of a position; the pass is always legal */
+static void goengc_perft_get_moves(const GoengcBoard* restrict board,
+                                   GoengcColor to_move,
+                                   GoengcBitfield* restrict legal,
+                                   GoengcPerftCounts* restrict rejected) {
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY, legal);
+    for (uint16_t index = goengc_bitfield_find_first(legal);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(legal, index + 1)) {
+        GoengcMoveLegality legality = goengc_board_get_move_legality(
+            board, goengc_perft_move(index, to_move));
+        if (legality != GOENGC_MOVE_LEGAL) {
+            goengc_bitfield_clear_bit(legal, index);
+            if (rejected != NULL) {
+                rejected->kos += legality == GOENGC_MOVE_KO;
+                rejected->suicides += legality == GOENGC_MOVE_SUICIDAL;
+            }
+        }
+    }
+}
+
+void goengc_perft(GoengcBoard* restrict board, GoengcColor to_move,
+                  uint8_t passes, uint8_t depth,
+                  GoengcPerftCounts* restrict counts) {
+    assert(board != NULL);
+    assert(counts != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+    assert(passes <= 2);
+
+    if (depth == 0) {
+        counts->nodes++;
+        return;
+    }
+    if (passes >= 2) {
+        return;
+    }
+
+    /* Bulk-count the last ply: every legal move ends one sequence */
+    GoengcBitfield legal;
+    if (depth == 1) {
+        goengc_perft_get_moves(board, to_move, &legal, counts);
+        counts->nodes += goengc_bitfield_count_bits(&legal) + 1u;
+        counts->passes++;
+        return;
+    }
+
+    GoengcColor opponent = goengc_color_opposite(to_move);
+    GoengcUndo undo;
+    goengc_perft_get_moves(board, to_move, &legal, NULL);
+    for (uint16_t index = goengc_bitfield_find_first(&legal);
+         index < GOENGC_DATA_SIZE_SQUARED;
+         index = goengc_bitfield_find_next(&legal, index + 1)) {
+        goengc_board_play_undoable(board, goengc_perft_move(index, to_move),
+                                   &undo);
+        goengc_perft(board, opponent, 0, depth - 1, counts);
+        goengc_board_undo(board, &undo);
+    }
+    goengc_board_play_undoable(
+        board, goengc_perft_move(GOENGC_PERFT_PASS, to_move), &undo);
+    goengc_perft(board, opponent, passes + 1, depth - 1, counts);
+    goengc_board_undo(board, &undo);
+}
+
+/* Worker: claim subtrees until none are left */
+static void goengc_perft_worker(void* context, uint16_t id) {
+    GoengcPerftJob* job = context;
+    GoengcPerftWorker* worker = &job->workers[id];
+    GoengcColor opponent = goengc_color_opposite(job->to_move);
+    GoengcUndo first_undo;
+    GoengcUndo second_undo;
+
+    for (;;) {
+        uint32_t i = atomic_fetch_add_explicit(&job->next_item, 1,
+                                               memory_order_relaxed);
+        if (i >= job->num_items) {
+            break;
+        }
+        const GoengcPerftItem* item = &job->items[i];
+        uint8_t passes = item->first == GOENGC_PERFT_PASS ? job->passes + 1 : 0;
+        goengc_board_play_undoable(
+            &worker->board, goengc_perft_move(item->first, job->to_move),
+            &first_undo);
+        goengc_board_play_undoable(
+            &worker->board, goengc_perft_move(item->second, opponent),
+            &second_undo);
+        passes = item->second == GOENGC_PERFT_PASS ? passes + 1 : 0;
+
+        uint64_t before = worker->counts.nodes;
+        goengc_perft(&worker->board, job->to_move, passes, job->depth - 2,
+                     &worker->counts);
+        worker->divide[item->first] += worker->counts.nodes - before;
+
+        goengc_board_undo(&worker->board, &second_undo);
+        goengc_board_undo(&worker->board, &first_undo);
+    }
+}
+
+uint16_t goengc_perft_parallel(const GoengcBoard* restrict board,
+                               GoengcColor to_move, uint8_t passes,
+                               uint8_t depth, uint16_t num_threads,
+                               GoengcPerftCounts* restrict counts,
+                               uint64_t* restrict divide) {
+    assert(board != NULL);
+    assert(counts != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+    assert(passes <= 2);
+    assert(num_threads > 0);
+
+    memset(counts, 0, sizeof(*counts));
+    if (divide != NULL) {
+        memset(divide, 0, GOENGC_DATA_SIZE_SQUARED * sizeof(*divide));
+    }
+
+    /* Trees of less than three plies, or ended by the first pass, are too
+     * small to split */
+    GoengcColor opponent = goengc_color_opposite(to_move);
+    GoengcBoard scratch = *board;
+    if (depth < 3 || passes >= 2) {
+        if (divide == NULL || depth == 0 || passes >= 2) {
+            goengc_perft(&scratch, to_move, passes, depth, counts);
+            return 1;
+        }
+        GoengcBitfield legal;
+        GoengcUndo undo;
+        goengc_perft_get_moves(&scratch, to_move, &legal,
+                               depth == 1 ? counts : NULL);
+        goengc_bitfield_set_bit(&legal, GOENGC_PERFT_PASS);
+        counts->passes += depth == 1;
+        for (uint16_t index = goengc_bitfield_find_first(&legal);
+             index < GOENGC_DATA_SIZE_SQUARED;
+             index = goengc_bitfield_find_next(&legal, index + 1)) {
+            uint64_t before = counts->nodes;
+            goengc_board_play_undoable(&scratch,
+                                       goengc_perft_move(index, to_move), &undo);
+            goengc_perft(&scratch, opponent,
+                         index == GOENGC_PERFT_PASS ? passes + 1 : 0,
+                         depth - 1, counts);
+            goengc_board_undo(&scratch, &undo);
+            divide[index] = counts->nodes - before;
+        }
+        return 1;
+    }
+
+    /* List the subtrees below every pair of first moves */
+    const uint32_t max_items = (GOENGC_DATA_SIZE_SQUARED + 1) *
+                               (GOENGC_DATA_SIZE_SQUARED + 1);
+    GoengcPerftItem* items = malloc(max_items * sizeof(GoengcPerftItem));
+    if (num_threads > GOENGC_PERFT_MAX_THREADS) {
+        num_threads = GOENGC_PERFT_MAX_THREADS;
+    }
+    GoengcPerftWorker* workers = aligned_alloc(
+        GOENGC_CACHE_LINE, (size_t)num_threads * sizeof(GoengcPerftWorker));
+    if (items == NULL || workers == NULL) {
+        free(items);
+        free(workers);
+        return 0;
+    }
+
+    uint32_t num_items = 0;
+    GoengcBitfield first_moves;
+    GoengcBitfield second_moves;
+    GoengcUndo undo;
+    goengc_perft_get_moves(&scratch, to_move, &first_moves, NULL);
+    goengc_bitfield_set_bit(&first_moves, GOENGC_PERFT_PASS);
+    for (uint16_t first = goengc_bitfield_find_first(&first_moves);
+         first < GOENGC_DATA_SIZE_SQUARED;
+         first = goengc_bitfield_find_next(&first_moves, first + 1)) {
+        if (first == GOENGC_PERFT_PASS && passes + 1 >= 2) {
+            continue; /* The game is over, so nothing follows */
+        }
+        goengc_board_play_undoable(&scratch, goengc_perft_move(first, to_move),
+                                   &undo);
+        goengc_perft_get_moves(&scratch, opponent, &second_moves, NULL);
+        goengc_bitfield_set_bit(&second_moves, GOENGC_PERFT_PASS);
+        for (uint16_t second = goengc_bitfield_find_first(&second_moves);
+             second < GOENGC_DATA_SIZE_SQUARED;
+             second = goengc_bitfield_find_next(&second_moves, second + 1)) {
+            items[num_items++] = (GoengcPerftItem){first, second};
+        }
+        goengc_board_undo(&scratch, &undo);
+    }
+
+    GoengcPerftJob job = {.to_move = to_move,
+                          .passes = passes,
+                          .depth = depth,
+                          .items = items,
+                          .num_items = num_items,
+                          .workers = workers};
+    atomic_init(&job.next_item, 0);
+    for (uint16_t i = 0; i < num_threads; i++) {
+        memcpy(&workers[i].board, board, sizeof(workers[i].board));
+        memset(&workers[i].counts, 0, sizeof(workers[i].counts));
+        memset(workers[i].divide, 0, sizeof(workers[i].divide));
+    }
+
+    /* The subtrees are shared, so the threads that start take all of them */
+    uint16_t started =
+        goengc_workers_run(goengc_perft_worker, &job, num_threads);
+
+    for (uint16_t i = 0; i < num_threads; i++) {
+        counts->nodes += workers[i].counts.nodes;
+        counts->passes += workers[i].counts.passes;
+        counts->kos += workers[i].counts.kos;
+        counts->suicides += workers[i].counts.suicides;
+        if (divide != NULL) {
+            for (uint16_t index = 0; index < GOENGC_DATA_SIZE_SQUARED;
+                 index++) {
+                divide[index] += workers[i].divide[index];
+            }
+        }
+    }
+
+    free(items);
+    free(workers);
+    return started;
+}
@@ -0,0 +1,101 @@
+#include "goengc/playout.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/pattern.h"
+#include "goengc/random.h"
+#include "goengc/scoring.h"
+#include "goengc/types.h"
+
+/* Pick a uniformly random legal move that does not fill an own eye. Points
+ * are drawn from the empty set without replacement until one qualifies, so
+ * the choice is uniform over all qualifying points. */
+static uint16_t goengc_playout_pick(const GoengcBoard* restrict board,
+                                    GoengcBitfield* restrict candidates,
+                                    GoengcColor color,
+                                    GoengcRng* restrict rng) {
+    goengc_colorfield_get_mask(&board->color_field, GOENGC_COLOR_EMPTY,
+                               candidates);
+    uint16_t count = goengc_bitfield_count_bits(candidates);
+
+    while (count > 0) {
+        uint16_t index =
+            goengc_bitfield_select(candidates, goengc_rng_below(rng, count));
+        if (!goengc_board_is_eye(board, index, color) &&
+            goengc_board_is_legal(
+                board,
+                goengc_move_create(color, 0, goengc_index_to_coord(index)))) {
+            return index;
+        }
+        goengc_bitfield_clear_bit(candidates, index);
+        count--;
+    }
+
+    return GOENGC_DATA_SIZE_SQUARED;
+}
+
+/* Playout loop of goengc_playout_run and goengc_playout_run_patterns; moves
+ * are drawn by pattern weight if a table is given, uniformly otherwise */
+static GoengcPlayoutResult goengc_playout_loop(
+    GoengcBoard* restrict board, GoengcWorkspace* restrict workspace,
+    GoengcColor to_move, const GoengcPatternTable* restrict table,
+    GoengcRng* restrict rng) {
+    uint16_t max_moves = 3 * board->board_size.x * board->board_size.y;
+    uint16_t num_moves = 0;
+    int passes = 0;
+
+    while (passes < 2 && num_moves < max_moves) {
+        uint16_t index =
+            table != NULL
+                ? goengc_pattern_pick(board, table, to_move,
+                                      &workspace->scratch1, rng)
+                : goengc_playout_pick(board, &workspace->scratch1, to_move,
+                                      rng);
+        if (index < GOENGC_DATA_SIZE_SQUARED) {
+            goengc_board_play(board,
+                              goengc_move_create(to_move, 0,
+                                                 goengc_index_to_coord(index)));
+            passes = 0;
+        } else {
+            goengc_board_play(
+                board, goengc_move_create(to_move, 1, goengc_vec2_create(0, 0)));
+            passes++;
+        }
+        num_moves++;
+        to_move = goengc_color_opposite(to_move);
+    }
+
+    GoengcScore score =
+        goengc_score(board, NULL, &workspace->scratch1, &workspace->scratch2);
+    return (GoengcPlayoutResult){.score2 = score.score2,
+                                 .num_moves = num_moves};
+}
+
+GoengcPlayoutResult goengc_playout_run(GoengcBoard* restrict board,
+                                       GoengcWorkspace* restrict workspace,
+                                       GoengcColor to_move,
+                                       GoengcRng* restrict rng) {
+    assert(board != NULL);
+    assert(workspace != NULL);
+    assert(rng != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+
+    return goengc_playout_loop(board, workspace, to_move, NULL, rng);
+}
+
+GoengcPlayoutResult goengc_playout_run_patterns(
+    GoengcBoard* restrict board, GoengcWorkspace* restrict workspace,
+    GoengcColor to_move, const GoengcPatternTable* restrict table,
+    GoengcRng* restrict rng) {
+    assert(board != NULL);
+    assert(workspace != NULL);
+    assert(table != NULL);
+    assert(rng != NULL);
+    assert(to_move == GOENGC_COLOR_BLACK || to_move == GOENGC_COLOR_WHITE);
+
+    return goengc_playout_loop(board, workspace, to_move, table, rng);
+}
@@ -0,0 +1,79 @@
+#include "goengc/scoring.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "goengc/bitfield.h"
+#include "goengc/board.h"
+#include "goengc/color_field.h"
+#include "goengc/floodfill.h"
+#include "goengc/types.h"
+
+GoengcScore goengc_score(const GoengcBoard* restrict board,
+                         const GoengcBitfield* restrict dead,
+                         GoengcBitfield* restrict black_area,
+                         GoengcBitfield* restrict white_area) {
+    assert(board != NULL);
+    assert(black_area != NULL && white_area != NULL);
+
+    GoengcColorMasks masks;
+    goengc_colorfield_get_masks(&board->color_field, &masks);
+
+    /* Points that regions may span: empty points and dead stones */
+    GoengcBitfield open;
+    goengc_bitfield_copy(&open, &masks.empty);
+    int16_t dead_black = 0;
+    int16_t dead_white = 0;
+    if (dead != NULL) {
+        GoengcBitfield removed;
+        goengc_bitfield_and(&removed, &masks.black, dead);
+        dead_black = goengc_bitfield_count_bits(&removed);
+        goengc_bitfield_andnot(&masks.black, &masks.black, &removed);
+        goengc_bitfield_or(&open, &open, &removed);
+
+        goengc_bitfield_and(&removed, &masks.white, dead);
+        dead_white = goengc_bitfield_count_bits(&removed);
+        goengc_bitfield_andnot(&masks.white, &masks.white, &removed);
+        goengc_bitfield_or(&open, &open, &removed);
+    }
+
+    /* Regions reachable from each color's living stones */
+    GoengcBitfield reach_black;
+    GoengcBitfield reach_white;
+    goengc_bitfield_neighbors(&reach_black, &masks.black);
+    goengc_bitfield_and(&reach_black, &reach_black, &open);
+    goengc_flood_fill_region(&open, &reach_black);
+    goengc_bitfield_neighbors(&reach_white, &masks.white);
+    goengc_bitfield_and(&reach_white, &reach_white, &open);
+    goengc_flood_fill_region(&open, &reach_white);
+
+    /* Regions reached by one color only are its territory */
+    goengc_bitfield_copy(black_area, &reach_black);
+    goengc_bitfield_andnot(black_area, black_area, &reach_white);
+    goengc_bitfield_copy(white_area, &reach_white);
+    goengc_bitfield_andnot(white_area, white_area, &reach_black);
+    int16_t black_territory = goengc_bitfield_count_bits(black_area);
+    int16_t white_territory = goengc_bitfield_count_bits(white_area);
+
+    goengc_bitfield_or(black_area, black_area, &masks.black);
+    goengc_bitfield_or(white_area, white_area, &masks.white);
+
+    GoengcScore score;
+    score.dame = goengc_bitfield_count_bits(&open) - black_territory -
+                 white_territory;
+    if (board->scoring == GOENGC_SCORING_TERRITORY) {
+        score.black = black_territory + dead_white;
+        score.white = white_territory + dead_black;
+        /* Captures are stored as Black's minus White's */
+        if (board->num_captures > 0) {
+            score.black += board->num_captures;
+        } else {
+            score.white -= board->num_captures;
+        }
+    } else {
+        score.black = goengc_bitfield_count_bits(black_area);
+        score.white = goengc_bitfield_count_bits(white_area);
+    }
+    score.score2 = (int16_t)(2 * (score.black - score.white) - board->komi2);
+    return score;
+}
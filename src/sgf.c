@@ -0,0 +1,640 @@
+#include "goengc/sgf.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goengc/board.h"
+#include "goengc/types.h"
+
+/* Block size goengc_sgf_replay_file reads the stream in */
+#define GOENGC_SGF_BLOCK_SIZE (1 << 20)
+
+/* Properties the replayer acts on */
+typedef enum {
+    GOENGC_SGF_PROP_B = 0,
+    GOENGC_SGF_PROP_W,
+    GOENGC_SGF_PROP_AB,
+    GOENGC_SGF_PROP_AW,
+    GOENGC_SGF_PROP_AE,
+    GOENGC_SGF_PROP_SZ,
+    GOENGC_SGF_PROP_KM,
+    GOENGC_SGF_PROP_RU,
+    GOENGC_SGF_PROP_COUNT,
+    GOENGC_SGF_PROP_OTHER = GOENGC_SGF_PROP_COUNT
+} GoengcSgfProperty;
+
+/* Value list of a property, from its first '[' to past its last ']' */
+typedef struct {
+    size_t start;
+    size_t end;
+} GoengcSgfSpan;
+
+/* The properties of one node the replayer acts on */
+typedef struct {
+    GoengcSgfSpan spans[GOENGC_SGF_PROP_COUNT];
+    uint16_t present; /* Bit per GoengcSgfProperty */
+} GoengcSgfNode;
+
+/* Position in the input */
+typedef struct {
+    const char* data;
+    size_t size;
+    size_t pos;
+} GoengcSgfReader;
+
+/* Replay state of the current game */
+typedef struct {
+    GoengcBoard* board;
+    const GoengcSgfHandler* handler;
+    GoengcSgfStats* stats;
+    uint16_t ply;
+    int started; /* 1 once the root node is applied */
+    int active;  /* 0 once the game is skipped */
+} GoengcSgfGame;
+
+/* Result of applying a node */
+typedef enum {
+    GOENGC_SGF_NODE_OK = 0,
+    GOENGC_SGF_NODE_SKIP = 1, /* The game cannot be replayed further */
+    GOENGC_SGF_NODE_STOP = 2  /* A callback asked to stop */
+} GoengcSgfNodeResult;
+
+static inline int goengc_sgf_is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+           c == '\f';
+}
+
+static inline void goengc_sgf_skip_space(GoengcSgfReader* reader) {
+    while (reader->pos < reader->size &&
+           goengc_sgf_is_space(reader->data[reader->pos])) {
+        reader->pos++;
+    }
+}
+
+/* Move past a value starting at '['. Returns 0 if it is not terminated. */
+static inline int goengc_sgf_skip_value(GoengcSgfReader* reader) {
+    const char* data = reader->data;
+    size_t pos = reader->pos + 1;
+    while (pos < reader->size && data[pos] != ']') {
+        /* An escaped character never ends the value */
+        pos += data[pos] == '\\' ? 2 : 1;
+    }
+    if (pos >= reader->size) {
+        return 0;
+    }
+    reader->pos = pos + 1;
+    return 1;
+}
+
+/* Move past a game tree starting at '('. Returns 0 if it is not closed. */
+static int goengc_sgf_skip_tree(GoengcSgfReader* reader) {
+    uint32_t depth = 0;
+    while (reader->pos < reader->size) {
+        char c = reader->data[reader->pos];
+        if (c == '[') {
+            if (!goengc_sgf_skip_value(reader)) {
+                return 0;
+            }
+            continue;
+        }
+        reader->pos++;
+        if (c == '(') {
+            depth++;
+        } else if (c == ')' && --depth == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Map a property identifier to the properties the replayer acts on */
+static GoengcSgfProperty goengc_sgf_identify(const char* ident,
+                                             uint8_t length) {
+    if (length == 1) {
+        if (ident[0] == 'B') {
+            return GOENGC_SGF_PROP_B;
+        }
+        if (ident[0] == 'W') {
+            return GOENGC_SGF_PROP_W;
+        }
+    } else if (length == 2) {
+        switch (ident[0] << 8 | ident[1]) {
+            case 'A' << 8 | 'B': return GOENGC_SGF_PROP_AB;
+            case 'A' << 8 | 'W': return GOENGC_SGF_PROP_AW;
+            case 'A' << 8 | 'E': return GOENGC_SGF_PROP_AE;
+            case 'S' << 8 | 'Z': return GOENGC_SGF_PROP_SZ;
+            case 'K' << 8 | 'M': return GOENGC_SGF_PROP_KM;
+            case 'R' << 8 | 'U': return GOENGC_SGF_PROP_RU;
+            default: break;
+        }
+    }
+    return GOENGC_SGF_PROP_OTHER;
+}
+
+/* Read a node starting at ';', recording where the relevant property values
+ * are. Returns 0 on a syntax error. */
+static int goengc_sgf_read_node(GoengcSgfReader* reader,
+                                GoengcSgfNode* node) {
+    const char* data = reader->data;
+    node->present = 0;
+    reader->pos++;
+
+    for (;;) {
+        goengc_sgf_skip_space(reader);
+        if (reader->pos >= reader->size) {
+            return 1;
+        }
+
+        /* Identifiers are upper case; FF[3] allowed lower case letters in
+         * between, which are ignored */
+        char ident[2];
+        uint8_t length = 0;
+        int is_ident = 0;
+        while (reader->pos < reader->size) {
+            char c = data[reader->pos];
+            if (c >= 'A' && c <= 'Z') {
+                if (length < sizeof(ident)) {
+                    ident[length] = c;
+                }
+                length = length < 3 ? length + 1 : length;
+            } else if (!(c >= 'a' && c <= 'z')) {
+                break;
+            }
+            is_ident = 1;
+            reader->pos++;
+        }
+        if (!is_ident) {
+            return 1;
+        }
+
+        goengc_sgf_skip_space(reader);
+        if (reader->pos >= reader->size || data[reader->pos] != '[') {
+            return 0;
+        }
+        size_t start = reader->pos;
+        size_t end = start;
+        while (reader->pos < reader->size && data[reader->pos] == '[') {
+            if (!goengc_sgf_skip_value(reader)) {
+                return 0;
+            }
+            end = reader->pos;
+            goengc_sgf_skip_space(reader);
+        }
+
+        GoengcSgfProperty property = goengc_sgf_identify(ident, length);
+        if (property != GOENGC_SGF_PROP_OTHER) {
+            node->spans[property] = (GoengcSgfSpan){.start = start, .end = end};
+            node->present |= (uint16_t)(1u << property);
+        }
+    }
+}
+
+/* Get the next value of a value list. Returns 0 if there is none. */
+static int goengc_sgf_next_value(const char* data, size_t* pos, size_t end,
+                                 size_t* value_start, size_t* value_end) {
+    while (*pos < end && goengc_sgf_is_space(data[*pos])) {
+        (*pos)++;
+    }
+    if (*pos >= end || data[*pos] != '[') {
+        return 0;
+    }
+    size_t i = *pos + 1;
+    while (data[i] != ']') {
+        i += data[i] == '\\' ? 2 : 1;
+    }
+    *value_start = *pos + 1;
+    *value_end = i;
+    *pos = i + 1;
+    return 1;
+}
+
+/* Parse an unsigned decimal number. Returns the position after it, or start
+ * if there are no digits. */
+static size_t goengc_sgf_parse_number(const char* data, size_t start,
+                                      size_t end, uint32_t* value) {
+    uint32_t result = 0;
+    size_t pos = start;
+    while (pos < end && data[pos] >= '0' && data[pos] <= '9' &&
+           result < 100000) {
+        result = result * 10 + (uint32_t)(data[pos] - '0');
+        pos++;
+    }
+    *value = result;
+    return pos;
+}
+
+/* Parse a komi value such as "6.5" into komi * 2, rounded */
+static int8_t goengc_sgf_parse_komi2(const char* data, size_t start,
+                                     size_t end) {
+    while (start < end && goengc_sgf_is_space(data[start])) {
+        start++;
+    }
+    int negative = start < end && data[start] == '-';
+    if (start < end && (data[start] == '-' || data[start] == '+')) {
+        start++;
+    }
+
+    uint32_t whole;
+    size_t pos = goengc_sgf_parse_number(data, start, end, &whole);
+    uint32_t thousandths = 0;
+    if (pos < end && data[pos] == '.') {
+        uint32_t scale = 100;
+        for (pos++; pos < end && data[pos] >= '0' && data[pos] <= '9';
+             pos++) {
+            thousandths += (uint32_t)(data[pos] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    int32_t komi2 = (int32_t)(2 * whole + (2 * thousandths + 500) / 1000);
+    if (komi2 > INT8_MAX) {
+        komi2 = INT8_MAX;
+    }
+    return (int8_t)(negative ? -komi2 : komi2);
+}
+
+/* Parse a point "ab" into padded board coordinates. Returns 0 if the point
+ * is malformed or off the board. */
+static int goengc_sgf_parse_point(const GoengcBoard* board, const char* data,
+                                  size_t start, GoengcVec2* coord) {
+    char cx = data[start];
+    char cy = data[start + 1];
+    if (cx < 'a' || cx > 'z' || cy < 'a' || cy > 'z') {
+        return 0;
+    }
+    uint8_t x = (uint8_t)(cx - 'a');
+    uint8_t y = (uint8_t)(cy - 'a');
+    if (x >= board->board_size.x || y >= board->board_size.y) {
+        return 0;
+    }
+    *coord = goengc_vec2_create(x + GOENGC_PAD, y + GOENGC_PAD);
+    return 1;
+}
+
+/* Apply the root properties: board size, komi and rules */
+static GoengcSgfNodeResult goengc_sgf_apply_root(GoengcSgfGame* game,
+                                                 const char* data,
+                                                 const GoengcSgfNode* node) {
+    uint32_t width = 19;
+    uint32_t height = 19;
+    size_t pos;
+    size_t start = 0;
+    size_t end = 0;
+
+    if (node->present & (1u << GOENGC_SGF_PROP_SZ)) {
+        pos = node->spans[GOENGC_SGF_PROP_SZ].start;
+        goengc_sgf_next_value(data, &pos, node->spans[GOENGC_SGF_PROP_SZ].end,
+                              &start, &end);
+        size_t next = goengc_sgf_parse_number(data, start, end, &width);
+        height = width;
+        if (next < end && data[next] == ':') {
+            goengc_sgf_parse_number(data, next + 1, end, &height);
+        }
+    }
+    if (width < 1 || height < 1 || width > GOENGC_MAX_BOARD_SIZE ||
+        height > GOENGC_MAX_BOARD_SIZE) {
+        return GOENGC_SGF_NODE_SKIP;
+    }
+
+    int8_t komi2 = 0;
+    if (node->present & (1u << GOENGC_SGF_PROP_KM)) {
+        pos = node->spans[GOENGC_SGF_PROP_KM].start;
+        goengc_sgf_next_value(data, &pos, node->spans[GOENGC_SGF_PROP_KM].end,
+                              &start, &end);
+        komi2 = goengc_sgf_parse_komi2(data, start, end);
+    }
+
+    /* Japanese and Korean rules count territory, the others area */
+    GoengcScoring scoring = GOENGC_SCORING_AREA;
+    if (node->present & (1u << GOENGC_SGF_PROP_RU)) {
+        pos = node->spans[GOENGC_SGF_PROP_RU].start;
+        goengc_sgf_next_value(data, &pos, node->spans[GOENGC_SGF_PROP_RU].end,
+                              &start, &end);
+        if ((end - start >= 5 && (memcmp(data + start, "Japan", 5) == 0 ||
+                                  memcmp(data + start, "japan", 5) == 0 ||
+                                  memcmp(data + start, "Korea", 5) == 0 ||
+                                  memcmp(data + start, "korea", 5) == 0))) {
+            scoring = GOENGC_SCORING_TERRITORY;
+        }
+    }
+
+    goengc_board_init(game->board,
+                      goengc_vec2_create((uint8_t)width, (uint8_t)height),
+                      komi2, scoring);
+    return GOENGC_SGF_NODE_OK;
+}
+
+/* Apply a setup property: single points "ab" or rectangles "ab:cd" */
+static GoengcSgfNodeResult goengc_sgf_apply_setup(GoengcSgfGame* game,
+                                                  const char* data,
+                                                  GoengcSgfSpan span,
+                                                  GoengcColor color) {
+    size_t pos = span.start;
+    size_t start, end;
+    while (goengc_sgf_next_value(data, &pos, span.end, &start, &end)) {
+        GoengcVec2 from, to;
+        if (end - start == 2) {
+            if (!goengc_sgf_parse_point(game->board, data, start, &from)) {
+                return GOENGC_SGF_NODE_SKIP;
+            }
+            to = from;
+        } else if (end - start == 5 && data[start + 2] == ':') {
+            if (!goengc_sgf_parse_point(game->board, data, start, &from) ||
+                !goengc_sgf_parse_point(game->board, data, start + 3, &to)) {
+                return GOENGC_SGF_NODE_SKIP;
+            }
+        } else {
+            return GOENGC_SGF_NODE_SKIP;
+        }
+
+        /* The corners of a rectangle may come in any order */
+        uint8_t x0 = from.x < to.x ? from.x : to.x;
+        uint8_t x1 = from.x < to.x ? to.x : from.x;
+        uint8_t y0 = from.y < to.y ? from.y : to.y;
+        uint8_t y1 = from.y < to.y ? to.y : from.y;
+        for (uint8_t y = y0; y <= y1; y++) {
+            for (uint8_t x = x0; x <= x1; x++) {
+                goengc_board_setup_move(
+                    game->board,
+                    goengc_move_create(color, 0, goengc_vec2_create(x, y)));
+            }
+        }
+    }
+    return GOENGC_SGF_NODE_OK;
+}
+
+/* Play the move of a node */
+static GoengcSgfNodeResult goengc_sgf_apply_move(GoengcSgfGame* game,
+                                                 const char* data,
+                                                 GoengcSgfSpan span,
+                                                 GoengcColor color) {
+    GoengcBoard* board = game->board;
+    size_t pos = span.start;
+    size_t start = 0;
+    size_t end = 0;
+    goengc_sgf_next_value(data, &pos, span.end, &start, &end);
+
+    GoengcMove move;
+    if (start == end ||
+        (end - start == 2 && data[start] == 't' && data[start + 1] == 't' &&
+         board->board_size.x <= 19 && board->board_size.y <= 19)) {
+        move = goengc_move_create(color, 1, goengc_vec2_create(0, 0));
+    } else {
+        GoengcVec2 coord;
+        if (end - start != 2 ||
+            !goengc_sgf_parse_point(board, data, start, &coord) ||
+            goengc_colorfield_get_color(
+                &board->color_field,
+                goengc_coord_to_index(coord.x, coord.y)) !=
+                GOENGC_COLOR_EMPTY) {
+            return GOENGC_SGF_NODE_SKIP;
+        }
+        move = goengc_move_create(color, 0, coord);
+    }
+
+    goengc_board_play(board, move);
+    game->stats->moves++;
+    uint16_t ply = game->ply++;
+    const GoengcSgfHandler* handler = game->handler;
+    if (handler != NULL && handler->position != NULL &&
+        !handler->position(board, move, ply, handler->user)) {
+        return GOENGC_SGF_NODE_STOP;
+    }
+    return GOENGC_SGF_NODE_OK;
+}
+
+/* Apply a node of the main line */
+static GoengcSgfNodeResult goengc_sgf_apply_node(GoengcSgfGame* game,
+                                                 const char* data,
+                                                 const GoengcSgfNode* node) {
+    GoengcSgfNodeResult result;
+    int root = !game->started;
+    if (root) {
+        result = goengc_sgf_apply_root(game, data, node);
+        if (result != GOENGC_SGF_NODE_OK) {
+            return result;
+        }
+        game->started = 1;
+    }
+
+    static const GoengcSgfProperty setup[3] = {
+        GOENGC_SGF_PROP_AE, GOENGC_SGF_PROP_AB, GOENGC_SGF_PROP_AW};
+    static const GoengcColor setup_color[3] = {
+        GOENGC_COLOR_EMPTY, GOENGC_COLOR_BLACK, GOENGC_COLOR_WHITE};
+    for (int i = 0; i < 3; i++) {
+        if (node->present & (1u << setup[i])) {
+            result = goengc_sgf_apply_setup(game, data, node->spans[setup[i]],
+                                            setup_color[i]);
+            if (result != GOENGC_SGF_NODE_OK) {
+                return result;
+            }
+        }
+    }
+
+    const GoengcSgfHandler* handler = game->handler;
+    if (root && handler != NULL && handler->begin_game != NULL &&
+        !handler->begin_game(game->board, handler->user)) {
+        return GOENGC_SGF_NODE_STOP;
+    }
+
+    if (node->present & (1u << GOENGC_SGF_PROP_B)) {
+        return goengc_sgf_apply_move(
+            game, data, node->spans[GOENGC_SGF_PROP_B], GOENGC_COLOR_BLACK);
+    }
+    if (node->present & (1u << GOENGC_SGF_PROP_W)) {
+        return goengc_sgf_apply_move(
+            game, data, node->spans[GOENGC_SGF_PROP_W], GOENGC_COLOR_WHITE);
+    }
+    return GOENGC_SGF_NODE_OK;
+}
+
+/* Replay the main line of a game tree starting at '(' */
+static GoengcSgfStatus goengc_sgf_replay_game(GoengcSgfReader* reader,
+                                              GoengcBoard* restrict board,
+                                              const GoengcSgfHandler* handler,
+                                              GoengcSgfStats* restrict stats) {
+    GoengcSgfGame game = {.board = board,
+                          .handler = handler,
+                          .stats = stats,
+                          .ply = 0,
+                          .started = 0,
+                          .active = 1};
+    GoengcSgfNode node;
+
+    /* The main line enters the first subtree at each branch. Once a subtree
+     * is closed, the remaining subtrees of its parent are variations. */
+    uint32_t depth = 1;
+    int descending = 1;
+    reader->pos++;
+    while (depth > 0) {
+        goengc_sgf_skip_space(reader);
+        if (reader->pos >= reader->size) {
+            return GOENGC_SGF_SYNTAX;
+        }
+
+        switch (reader->data[reader->pos]) {
+            case ';':
+                if (!goengc_sgf_read_node(reader, &node)) {
+                    return GOENGC_SGF_SYNTAX;
+                }
+                if (game.active) {
+                    GoengcSgfNodeResult result =
+                        goengc_sgf_apply_node(&game, reader->data, &node);
+                    if (result == GOENGC_SGF_NODE_STOP) {
+                        return GOENGC_SGF_STOPPED;
+                    }
+                    game.active = result == GOENGC_SGF_NODE_OK;
+                }
+                break;
+            case '(':
+                if (descending) {
+                    depth++;
+                    reader->pos++;
+                } else if (!goengc_sgf_skip_tree(reader)) {
+                    return GOENGC_SGF_SYNTAX;
+                }
+                break;
+            case ')':
+                depth--;
+                descending = 0;
+                reader->pos++;
+                break;
+            default:
+                return GOENGC_SGF_SYNTAX;
+        }
+    }
+
+    if (!game.active) {
+        stats->skipped++;
+    } else if (game.started) {
+        stats->games++;
+        if (handler != NULL && handler->end_game != NULL &&
+            !handler->end_game(board, handler->user)) {
+            return GOENGC_SGF_STOPPED;
+        }
+    }
+    return GOENGC_SGF_OK;
+}
+
+/* Replay all games of a buffer, adding to the counters */
+static GoengcSgfStatus goengc_sgf_replay_games(const char* data, size_t size,
+                                               GoengcBoard* restrict board,
+                                               const GoengcSgfHandler* handler,
+                                               GoengcSgfStats* restrict stats) {
+    GoengcSgfReader reader = {.data = data, .size = size, .pos = 0};
+    for (;;) {
+        /* Text between game trees is ignored */
+        if (reader.pos >= size) {
+            return GOENGC_SGF_OK;
+        }
+        const char* open = memchr(data + reader.pos, '(', size - reader.pos);
+        if (open == NULL) {
+            return GOENGC_SGF_OK;
+        }
+        reader.pos = (size_t)(open - data);
+
+        GoengcSgfStatus status =
+            goengc_sgf_replay_game(&reader, board, handler, stats);
+        if (status != GOENGC_SGF_OK) {
+            return status;
+        }
+    }
+}
+
+/* Length of the prefix of a buffer that holds only complete game trees */
+static size_t goengc_sgf_complete_length(const char* data, size_t size) {
+    uint32_t depth = 0;
+    size_t complete = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        char c = data[pos];
+        if (depth == 0) {
+            depth = c == '(';
+            pos++;
+        } else if (c == '[') {
+            for (pos++; pos < size && data[pos] != ']';) {
+                pos += data[pos] == '\\' ? 2 : 1;
+            }
+            pos++;
+        } else {
+            if (c == '(') {
+                depth++;
+            } else if (c == ')' && --depth == 0) {
+                complete = pos + 1;
+            }
+            pos++;
+        }
+    }
+    return complete;
+}
+
+GoengcSgfStatus goengc_sgf_replay_buffer(const char* data, size_t size,
+                                         GoengcBoard* restrict board,
+                                         const GoengcSgfHandler* handler,
+                                         GoengcSgfStats* restrict stats) {
+    assert(data != NULL || size == 0);
+    assert(board != NULL);
+    assert(stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+    return goengc_sgf_replay_games(data, size, board, handler, stats);
+}
+
+GoengcSgfStatus goengc_sgf_replay_file(FILE* file, GoengcBoard* restrict board,
+                                       const GoengcSgfHandler* handler,
+                                       GoengcSgfStats* restrict stats) {
+    assert(file != NULL);
+    assert(board != NULL);
+    assert(stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+    size_t capacity = GOENGC_SGF_BLOCK_SIZE;
+    size_t length = 0;
+    char* buffer = malloc(capacity);
+    if (buffer == NULL) {
+        return GOENGC_SGF_IO;
+    }
+
+    GoengcSgfStatus status = GOENGC_SGF_OK;
+    for (;;) {
+        /* A game longer than the buffer makes it grow */
+        if (length == capacity) {
+            char* grown = realloc(buffer, 2 * capacity);
+            if (grown == NULL) {
+                status = GOENGC_SGF_IO;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+
+        size_t read = fread(buffer + length, 1, capacity - length, file);
+        if (read == 0) {
+            status = ferror(file)
+                         ? GOENGC_SGF_IO
+                         : goengc_sgf_replay_games(buffer, length, board,
+                                                   handler, stats);
+            break;
+        }
+        length += read;
+
+        /* Replay the complete games and keep the incomplete tail */
+        size_t complete = goengc_sgf_complete_length(buffer, length);
+        if (complete > 0) {
+            status = goengc_sgf_replay_games(buffer, complete, board, handler,
+                                             stats);
+            if (status != GOENGC_SGF_OK) {
+                break;
+            }
+            memmove(buffer, buffer + complete, length - complete);
+            length -= complete;
+        }
+    }
+
+    free(buffer);
+    return status;
+}
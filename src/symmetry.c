@@ -0,0 +1,87 @@
+#include "goengc/symmetry.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* Board rows are held in 32-bit words; GOENGC_MAX_BOARD_SIZE is at most 25 */
+#define GOENGC_SYMMETRY_ROWS 32
+
+/* Reverse the bit order of a word */
+static inline uint32_t goengc_symmetry_reverse32(uint32_t value) {
+    value = ((value >> 1) & 0x55555555u) | ((value & 0x55555555u) << 1);
+    value = ((value >> 2) & 0x33333333u) | ((value & 0x33333333u) << 2);
+    value = ((value >> 4) & 0x0F0F0F0Fu) | ((value & 0x0F0F0F0Fu) << 4);
+    value = ((value >> 8) & 0x00FF00FFu) | ((value & 0x00FF00FFu) << 8);
+    return (value >> 16) | (value << 16);
+}
+
+/* Transpose a 32x32 bit matrix in place (bit x of rows[y] becomes bit y of
+ * rows[x]) by swapping ever smaller off-diagonal blocks */
+static void goengc_symmetry_transpose32(uint32_t rows[GOENGC_SYMMETRY_ROWS]) {
+    uint32_t mask = 0x0000FFFFu;
+    for (uint8_t block = 16; block != 0;
+         block >>= 1, mask ^= mask << block) {
+        for (uint8_t k = 0; k < GOENGC_SYMMETRY_ROWS;
+             k = (uint8_t)((k + block + 1) & ~block)) {
+            uint32_t swap = ((rows[k] >> block) ^ rows[k + block]) & mask;
+            rows[k] ^= swap << block;
+            rows[k + block] ^= swap;
+        }
+    }
+}
+
+void goengc_bitfield_transform(const GoengcBitfield* restrict src,
+                               GoengcVec2 board_size, GoengcSymmetry symmetry,
+                               GoengcBitfield* restrict dst) {
+    assert(src != NULL);
+    assert(dst != NULL);
+    assert(board_size.x <= GOENGC_MAX_BOARD_SIZE &&
+           board_size.y <= GOENGC_MAX_BOARD_SIZE);
+
+    uint32_t rows[GOENGC_SYMMETRY_ROWS] = {0};
+    for (uint8_t y = 0; y < board_size.y; y++) {
+        rows[y] = (uint32_t)goengc_bits_get(
+            src->words, (y + GOENGC_PAD) * GOENGC_DATA_SIZE + GOENGC_PAD,
+            board_size.x);
+    }
+
+    GoengcVec2 size = goengc_symmetry_board_size(board_size, symmetry);
+    if (symmetry & GOENGC_SYMMETRY_TRANSPOSE_BIT) {
+        goengc_symmetry_transpose32(rows);
+    }
+    if (symmetry & GOENGC_SYMMETRY_FLIP_X_BIT) {
+        for (uint8_t y = 0; y < size.y; y++) {
+            rows[y] = goengc_symmetry_reverse32(rows[y]) >>
+                      (GOENGC_SYMMETRY_ROWS - size.x);
+        }
+    }
+    if (symmetry & GOENGC_SYMMETRY_FLIP_Y_BIT) {
+        for (uint8_t y = 0; y < size.y / 2; y++) {
+            uint32_t swap = rows[y];
+            rows[y] = rows[size.y - 1 - y];
+            rows[size.y - 1 - y] = swap;
+        }
+    }
+
+    memset(dst->words, 0, sizeof(dst->words));
+    for (uint8_t y = 0; y < size.y; y++) {
+        goengc_bits_put(dst->words,
+                        (y + GOENGC_PAD) * GOENGC_DATA_SIZE + GOENGC_PAD,
+                        size.x, rows[y]);
+    }
+    dst->active_start = 0;
+    dst->active_end = GOENGC_DATA_SIZE_SQUARED;
+    goengc_bitfield_tighten(dst);
+}
+
+void goengc_colorfield_transform(const GoengcColorField* restrict src,
+                                 GoengcVec2 board_size, GoengcSymmetry symmetry,
+                                 GoengcColorField* restrict dst) {
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    goengc_bitfield_transform(&src->occupied_bits, board_size, symmetry,
+                              &dst->occupied_bits);
+    goengc_bitfield_transform(&src->color_bits, board_size, symmetry,
+                              &dst->color_bits);
+}
@@ -0,0 +1,159 @@
+#include "goengc/transposition.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Pack a payload into the data word; valid entries are never 0 because the
+ * generation is never 0 */
+static inline uint64_t goengc_transposition_pack(GoengcTranspositionData data) {
+    return (uint64_t)data.move | ((uint64_t)(uint16_t)data.value << 16) |
+           ((uint64_t)data.weight << 32) | ((uint64_t)data.flags << 48) |
+           ((uint64_t)data.generation << 56);
+}
+
+static inline GoengcTranspositionData goengc_transposition_unpack(
+    uint64_t word) {
+    return (GoengcTranspositionData){
+        .move = (uint16_t)word,
+        .value = (int16_t)(uint16_t)(word >> 16),
+        .weight = (uint16_t)(word >> 32),
+        .flags = (uint8_t)(word >> 48),
+        .generation = (uint8_t)(word >> 56)};
+}
+
+int goengc_transposition_init(GoengcTranspositionTable* restrict table,
+                              size_t size_mb) {
+    assert(table != NULL);
+    assert(size_mb > 0);
+
+    uint64_t budget = (uint64_t)size_mb << 20;
+    uint64_t num_buckets = 1;
+    while (num_buckets * 2 * sizeof(GoengcTranspositionBucket) <= budget) {
+        num_buckets *= 2;
+    }
+
+    table->buckets =
+        aligned_alloc(GOENGC_TRANSPOSITION_BUCKET_SIZE,
+                      num_buckets * sizeof(GoengcTranspositionBucket));
+    if (table->buckets == NULL) {
+        return -1;
+    }
+    table->mask = num_buckets - 1;
+    atomic_init(&table->generation, 1);
+    goengc_transposition_clear(table);
+    return 0;
+}
+
+void goengc_transposition_free(GoengcTranspositionTable* restrict table) {
+    assert(table != NULL);
+
+    free(table->buckets);
+    table->buckets = NULL;
+    table->mask = 0;
+}
+
+void goengc_transposition_clear(GoengcTranspositionTable* restrict table) {
+    assert(table != NULL && table->buckets != NULL);
+
+    /* All-zero words are an empty entry */
+    memset(table->buckets, 0,
+           (table->mask + 1) * sizeof(GoengcTranspositionBucket));
+}
+
+void goengc_transposition_new_generation(
+    GoengcTranspositionTable* restrict table) {
+    assert(table != NULL);
+
+    uint8_t generation =
+        atomic_load_explicit(&table->generation, memory_order_relaxed) + 1;
+    atomic_store_explicit(&table->generation, generation == 0 ? 1 : generation,
+                          memory_order_relaxed);
+}
+
+int goengc_transposition_probe(const GoengcTranspositionTable* table,
+                               uint64_t key,
+                               GoengcTranspositionData* restrict data,
+                               GoengcTranspositionStats* restrict stats) {
+    assert(table != NULL && table->buckets != NULL);
+    assert(data != NULL);
+
+    /* Casting away const is fine: relaxed loads do not modify the entry */
+    GoengcTranspositionEntry* entries =
+        ((GoengcTranspositionBucket*)&table->buckets[key & table->mask])
+            ->entries;
+    if (stats != NULL) {
+        stats->probes++;
+    }
+    for (int i = 0; i < GOENGC_TRANSPOSITION_BUCKET_ENTRIES; i++) {
+        uint64_t word =
+            atomic_load_explicit(&entries[i].data, memory_order_relaxed);
+        uint64_t check =
+            atomic_load_explicit(&entries[i].check, memory_order_relaxed);
+        if (word != 0 && (check ^ word) == key) {
+            *data = goengc_transposition_unpack(word);
+            if (stats != NULL) {
+                stats->hits++;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void goengc_transposition_store(GoengcTranspositionTable* table, uint64_t key,
+                                GoengcTranspositionData data,
+                                GoengcTranspositionStats* restrict stats) {
+    assert(table != NULL && table->buckets != NULL);
+
+    GoengcTranspositionEntry* entries = table->buckets[key & table->mask].entries;
+    uint8_t generation =
+        atomic_load_explicit(&table->generation, memory_order_relaxed);
+    data.generation = generation;
+
+    /* Pick the slot: the position's own entry, else an empty one, else the
+     * oldest generation, else the lightest entry */
+    int victim = -1;
+    int lightest = 0;
+    int lightest_score = INT_MIN;
+    int live = 0;
+    for (int i = 0; i < GOENGC_TRANSPOSITION_BUCKET_ENTRIES; i++) {
+        uint64_t word =
+            atomic_load_explicit(&entries[i].data, memory_order_relaxed);
+        uint64_t check =
+            atomic_load_explicit(&entries[i].check, memory_order_relaxed);
+        if (word == 0 || (check ^ word) == key) {
+            victim = i;
+            break;
+        }
+
+        /* Generations wrap, so the age is taken modulo 256 */
+        GoengcTranspositionData old = goengc_transposition_unpack(word);
+        uint8_t age = (uint8_t)(generation - old.generation);
+        live += age == 0;
+        int score = (int)age * 65536 - old.weight;
+        if (score > lightest_score) {
+            lightest = i;
+            lightest_score = score;
+        }
+    }
+
+    if (stats != NULL) {
+        stats->stores++;
+    }
+    if (victim < 0) {
+        victim = lightest;
+        if (stats != NULL) {
+            stats->overwrites++;
+            stats->collisions += live == GOENGC_TRANSPOSITION_BUCKET_ENTRIES;
+        }
+    }
+
+    /* Two relaxed stores; a reader that sees one without the other fails
+     * the key check and treats the entry as a miss */
+    uint64_t word = goengc_transposition_pack(data);
+    atomic_store_explicit(&entries[victim].data, word, memory_order_relaxed);
+    atomic_store_explicit(&entries[victim].check, key ^ word,
+                          memory_order_relaxed);
+}
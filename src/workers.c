@@ -0,0 +1,59 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "workers.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+typedef struct {
+    GoengcWorkerFunction function;
+    void* context;
+    uint16_t id;
+} GoengcWorkerThread;
+
+static void* goengc_workers_thread(void* arg) {
+    GoengcWorkerThread* thread = arg;
+    thread->function(thread->context, thread->id);
+    return NULL;
+}
+
+uint16_t goengc_workers_run(GoengcWorkerFunction function, void* context,
+                            uint16_t num_workers) {
+    assert(function != NULL);
+    assert(num_workers > 0);
+
+    /* Without memory for the handles, the calling thread runs every worker */
+    pthread_t* handles = NULL;
+    GoengcWorkerThread* threads = NULL;
+    if (num_workers > 1) {
+        handles = malloc(num_workers * sizeof(pthread_t));
+        threads = malloc(num_workers * sizeof(GoengcWorkerThread));
+    }
+
+    /* The calling thread works as worker 0; starting stops at the first
+     * thread that fails */
+    uint16_t started = 1;
+    if (handles != NULL && threads != NULL) {
+        for (uint16_t i = 1; i < num_workers; i++) {
+            threads[i] = (GoengcWorkerThread){
+                .function = function, .context = context, .id = i};
+            if (pthread_create(&handles[i], NULL, goengc_workers_thread,
+                               &threads[i]) != 0) {
+                break;
+            }
+            started++;
+        }
+    }
+    function(context, 0);
+    for (uint16_t i = started; i < num_workers; i++) {
+        function(context, i);
+    }
+    for (uint16_t i = 1; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    free(handles);
+    free(threads);
+    return started;
+}
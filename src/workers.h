@@ -0,0 +1,25 @@
+#ifndef GOENGC_WORKERS_H
+#define GOENGC_WORKERS_H
+
+#include <stdint.h>
+
+/* Alignment of per-thread state, so that threads never write to the same
+ * cache line */
+#define GOENGC_CACHE_LINE 64
+
+/* The work of one worker, called with the shared context and its id */
+typedef void (*GoengcWorkerFunction)(void* context, uint16_t id);
+
+/**
+ * Run workers 0 to num_workers - 1 in parallel and wait for all of them.
+ * The calling thread runs worker 0, then every worker whose thread could not
+ * be started, so each worker runs exactly once either way.
+ * @param function The work of a worker
+ * @param context Shared state passed to every worker
+ * @param num_workers The number of workers (at least 1)
+ * @return The number of threads that ran workers, the caller included
+ */
+uint16_t goengc_workers_run(GoengcWorkerFunction function, void* context,
+                            uint16_t num_workers);
+
+#endif /* GOENGC_WORKERS_H */